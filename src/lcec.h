@@ -28,6 +28,7 @@
 
 #include "ecrt.h"
 #include "lcec_conf.h"
+#include "lcec_tap.h"
 
 // list macros
 #define LCEC_LIST_APPEND(first, last, item) \
@@ -68,6 +69,13 @@ do {                        \
 // State update period (ns)
 #define LCEC_STATE_UPDATE_PERIOD 1000000000LL
 
+// execution time histogram (log2 buckets, first bucket < 1us)
+#define LCEC_TIMING_HIST_BUCKETS 12
+#define LCEC_TIMING_HIST_SHIFT   10
+
+// execution time average filter (2^n samples)
+#define LCEC_TIMING_AVG_SHIFT 4
+
 // IDN builder
 #define LCEC_IDN_TYPE_P 0x8000
 #define LCEC_IDN_TYPE_S 0x0000
@@ -77,12 +85,33 @@ do {                        \
 #define LCEC_FSOE_MSG_LEN 6
 
 struct lcec_master;
+struct lcec_domain;
 struct lcec_slave;
+struct lcec_rec;
 
 typedef int (*lcec_slave_init_t) (int comp_id, struct lcec_slave *slave, ec_pdo_entry_reg_t *pdo_entry_regs);
 typedef void (*lcec_slave_cleanup_t) (struct lcec_slave *slave);
 typedef void (*lcec_slave_rw_t) (struct lcec_slave *slave, long period);
 
+typedef enum {
+  lcecTimingReceive = 0,
+  lcecTimingProcess,
+  lcecTimingRead,
+  lcecTimingWrite,
+  lcecTimingSend,
+  lcecTimingCount
+} LCEC_TIMING_PHASE_T;
+
+typedef struct {
+  hal_u32_t *last;
+  hal_u32_t *min;
+  hal_u32_t *max;
+  hal_u32_t *avg;
+  hal_u32_t hist[LCEC_TIMING_HIST_BUCKETS];
+  long long avg_acc;
+  int valid;
+} lcec_timing_data_t;
+
 typedef struct lcec_master_data {
   hal_u32_t *slaves_responding;
   hal_bit_t *state_init;
@@ -98,8 +127,74 @@ typedef struct lcec_master_data {
   hal_u32_t pll_max_err;
   hal_u32_t *pll_reset_cnt;
 #endif
+  hal_s32_t *send_time;
+  hal_u32_t *thread_overruns;
+  hal_bit_t *timing_reset;
+  lcec_timing_data_t timing[lcecTimingCount];
 } lcec_master_data_t;
 
+typedef struct lcec_domain_data {
+  hal_u32_t *wc_expected;
+  hal_u32_t *wc_actual;
+  hal_u32_t *wc_state;
+  hal_bit_t *wc_valid;
+  hal_u32_t *wc_bad_cycles;
+  hal_u32_t *wc_lost_frames;
+  hal_bit_t wc_skip_read;
+} lcec_domain_data_t;
+
+typedef struct {
+  lcec_slave_rw_t proc;
+  struct lcec_slave *slave;
+} lcec_slave_func_t;
+
+// byte range of the domain data, relative to domain->process_data
+typedef struct {
+  int offset;
+  int length;
+} lcec_domain_range_t;
+
+typedef struct lcec_domain {
+  struct lcec_domain *prev;
+  struct lcec_domain *next;
+  struct lcec_master *master;
+  int index;
+  char name[LCEC_CONF_STR_MAXLEN];
+  int cycle_divider;
+  int cycle_cnt;
+  int queued;
+  int active;
+  int pdo_entry_count;
+  ec_pdo_entry_reg_t *pdo_entry_regs;
+  lcec_slave_func_t *read_funcs;
+  int read_func_count;
+  lcec_slave_func_t *write_funcs;
+  int write_func_count;
+  ec_domain_t *domain;
+  ec_domain_state_t state;
+  lcec_domain_data_t *hal_data;
+  uint8_t *process_data;
+  int process_data_len;
+  int process_data_valid;
+  lcec_domain_range_t *out_ranges;
+  int out_range_count;
+  uint8_t *out_data;
+} lcec_domain_t;
+
+typedef struct {
+  lcec_thread_t thread;
+  void (*funct) (void *arg, long period);
+  long period;
+  unsigned int request;
+  unsigned int done;
+  unsigned int wake_seq;
+  int sleeping;
+  int inline_run;
+  int busy;
+  int cpu_warned;
+  int stop;
+} lcec_master_thread_t;
+
 typedef struct lcec_slave_state {
   hal_bit_t *online;
   hal_bit_t *operational;
@@ -118,7 +213,9 @@ typedef struct lcec_master {
   unsigned long mutex;
   int pdo_entry_count;
   ec_pdo_entry_reg_t *pdo_entry_regs;
-  ec_domain_t *domain;
+  struct lcec_domain *first_domain;
+  struct lcec_domain *last_domain;
+  uint8_t *domain_mem;
   uint8_t *process_data;
   int process_data_len;
   struct lcec_slave *first_slave;
@@ -127,9 +224,24 @@ typedef struct lcec_master {
   uint64_t app_time_base;
   uint32_t app_time_period;
   long period_last;
+  int send_first;
+  long long cycle_start;
+  int thread_cpu;
+  lcec_master_thread_t *thread;
+  int tap_enabled;
+  int tap_shmem_id;
+  LCEC_TAP_HEADER_T *tap;
+  int rec_depth;
+  struct lcec_rec *rec;
   int sync_ref_cnt;
   int sync_ref_cycles;
   long long state_update_timer;
+  int slave_count;
+  int state_poll_conf;
+  int state_poll_count;
+  long long state_poll_rate;
+  long long state_poll_credit;
+  struct lcec_slave *state_poll_next;
   ec_master_state_t ms;
 #ifdef RTAPI_TASK_PLL_SUPPORT
   uint64_t dc_ref;
@@ -138,48 +250,24 @@ typedef struct lcec_master {
 #endif
 } lcec_master_t;
 
-typedef struct {
-  uint16_t assignActivate;
-  uint32_t sync0Cycle;
-  int32_t sync0Shift;
-  uint32_t sync1Cycle;
-  int32_t sync1Shift;
-} lcec_slave_dc_t;
-
-typedef struct {
-  uint16_t divider;
-  uint16_t intervals;
-} lcec_slave_watchdog_t;
-
-typedef struct {
-  uint16_t index;
-  int16_t subindex;
-  size_t length;
-  uint8_t data[];
-} lcec_slave_sdoconf_t;
-
-typedef struct {
-  uint8_t drive;
-  uint16_t idn;
-  ec_al_state_t state;
-  size_t length;
-  uint8_t data[];
-} lcec_slave_idnconf_t;
-
-typedef struct {
-  int id;
-  LCEC_CONF_MODPARAM_VAL_T value;
-} lcec_slave_modparam_t;
+// slave configs reference the tokens in the config shmem
+typedef LCEC_CONF_DC_T lcec_slave_dc_t;
+typedef LCEC_CONF_WATCHDOG_T lcec_slave_watchdog_t;
+typedef LCEC_CONF_SDOCONF_T lcec_slave_sdoconf_t;
+typedef LCEC_CONF_IDNCONF_T lcec_slave_idnconf_t;
+typedef LCEC_CONF_MODPARAM_T lcec_slave_modparam_t;
 
 typedef struct lcec_slave {
   struct lcec_slave *prev;
   struct lcec_slave *next;
   struct lcec_master *master;
+  struct lcec_domain *domain;
   int index;
   char name[LCEC_CONF_STR_MAXLEN];
   uint32_t vid;
   uint32_t pid;
   int pdo_entry_count;
+  ec_pdo_entry_reg_t *pdo_entry_regs;
   ec_sync_info_t *sync_info;
   ec_slave_config_t *config;
   ec_slave_config_state_t state;
@@ -194,6 +282,7 @@ typedef struct lcec_slave {
   ec_pdo_entry_info_t *generic_pdo_entries;
   ec_pdo_info_t *generic_pdos;
   ec_sync_info_t *generic_sync_managers;
+  struct lcec_generic_pin_conf *generic_pin_conf;
   lcec_slave_sdoconf_t *sdo_config;
   lcec_slave_idnconf_t *idn_config;
   lcec_slave_modparam_t *modparams;
@@ -208,6 +297,16 @@ typedef struct {
   const char *fmt;
 } lcec_pindesc_t;
 
+typedef struct lcec_typelist {
+  LCEC_SLAVE_TYPE_T type;
+  uint32_t vid;
+  uint32_t pid;
+  int pdo_entry_count;
+  lcec_slave_init_t proc_init;
+} lcec_typelist_t;
+
+extern const lcec_typelist_t lcec_types[];
+
 int lcec_read_sdo(struct lcec_slave *slave, uint16_t index, uint8_t subindex, uint8_t *target, size_t size);
 int lcec_read_idn(struct lcec_slave *slave, uint8_t drive_no, uint16_t idn, uint8_t *target, size_t size);
 
@@ -222,5 +321,16 @@ lcec_slave_t *lcec_slave_by_index(struct lcec_master *master, int index);
 
 void copy_fsoe_data(struct lcec_slave *slave, unsigned int slave_offset, unsigned int master_offset);
 
+int lcec_tap_entry_count(struct lcec_master *master);
+void lcec_tap_init_entries(struct lcec_master *master, LCEC_TAP_ENTRY_T *entry);
+int lcec_tap_init(int comp_id, struct lcec_master *master);
+void lcec_tap_cleanup(int comp_id, struct lcec_master *master);
+void lcec_tap_publish(struct lcec_master *master);
+
+int lcec_rec_init(int comp_id, struct lcec_master *master);
+void lcec_rec_cleanup(int comp_id, struct lcec_master *master);
+void lcec_rec_cycle(struct lcec_master *master);
+int lcec_rec_state_wanted(struct lcec_master *master);
+
 #endif
 
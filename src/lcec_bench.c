@@ -0,0 +1,667 @@
+//
+//    Copyright (C) 2026 Sascha Ittner <sascha.ittner@modusoft.de>
+//
+//    This program is free software; you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation; either version 2 of the License, or
+//    (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with this program; if not, write to the Free Software
+//    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301 USA
+//
+
+//
+// Cyclic microbenchmark for the slave drivers
+//
+// Instantiates N copies of every slave type from lcec_types[] on a
+// simulated master with a fake HAL, runs the drivers' read and write
+// functions with all slaves in OP over a synthetic process image and
+// reports time per slave and cycle and instructions per bus cycle for
+// every type.
+//
+// A generic CiA402 style drive with its control and status words and
+// packed analog values mapped via complex entries is run as the last
+// type (lcec_generic_init).
+//
+// With -d a single bus of N slaves (6 of 8 EK1100 couplers without
+// callbacks, one EL1008, one EL2008) is run instead, once walking the
+// slave list like the cyclic code did before the per-domain dispatch
+// tables and once through the tables, to compare the dispatch cost.
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <dlfcn.h>
+#include <time.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+
+#include "lcec.h"
+#include "lcec_generic.h"
+#include "lcec_fakehal.h"
+
+#define LCEC_BENCH_PERIOD   1000000
+#define LCEC_BENCH_IMAGES   16
+#define LCEC_BENCH_WARMUP   1000
+
+#define LCEC_BENCH_GENERIC_VID 0x00000999
+#define LCEC_BENCH_GENERIC_PID 0x00000002
+#define LCEC_BENCH_GENERIC_MAX 64
+#define LCEC_BENCH_GENERIC_NAMELEN 16
+
+#define LCEC_BENCH_DISPATCH_PATTERN 8
+
+typedef enum {
+  lcecBenchDispatchDirect = 0,
+  lcecBenchDispatchList,
+  lcecBenchDispatchTables
+} LCEC_BENCH_DISPATCH_T;
+
+typedef struct {
+  lcec_master_t *master;
+  lcec_domain_t *domain;
+  LCEC_BENCH_DISPATCH_T dispatch;
+  lcec_slave_t *slaves;
+  int slave_count;
+  ec_pdo_entry_reg_t *regs;
+  int reg_count;
+  uint8_t *images;
+} LCEC_BENCH_BUS_T;
+
+typedef struct {
+  uint16_t index;
+  uint8_t subindex;
+  uint8_t entry_bits;
+  uint8_t bit_offset;
+  uint8_t bit_length;
+  hal_type_t type;
+} LCEC_BENCH_GENERIC_PIN_T;
+
+typedef struct {
+  double ns_per_slave;
+  double instr_per_cycle;
+  int instr_valid;
+} LCEC_BENCH_RESULT_T;
+
+static const char *modname = "lcec_bench";
+
+int lcec_init_domain_funcs(lcec_master_t *master);
+
+// generic drive pins, pins of one PDO entry must follow each other
+static const LCEC_BENCH_GENERIC_PIN_T generic_outputs[] = {
+  { 0x6040, 0x00, 16,  0,  1, HAL_BIT }, { 0x6040, 0x00, 16,  1,  1, HAL_BIT },
+  { 0x6040, 0x00, 16,  2,  1, HAL_BIT }, { 0x6040, 0x00, 16,  3,  1, HAL_BIT },
+  { 0x6040, 0x00, 16,  4,  3, HAL_U32 }, { 0x6040, 0x00, 16,  7,  1, HAL_BIT },
+  { 0x6040, 0x00, 16,  8,  1, HAL_BIT }, { 0x6040, 0x00, 16,  9,  2, HAL_U32 },
+  { 0x6040, 0x00, 16, 11,  5, HAL_U32 },
+  { 0x607a, 0x00, 32,  0, 32, HAL_S32 }, { 0x60ff, 0x00, 32,  0, 32, HAL_S32 },
+  { 0x6071, 0x00, 16,  0, 16, HAL_S32 }, { 0x6060, 0x00,  8,  0,  8, HAL_S32 },
+  { 0x2001, 0x01, 32,  0, 12, HAL_FLOAT }, { 0x2001, 0x01, 32, 12, 12, HAL_FLOAT },
+  { 0x2001, 0x01, 32, 24,  8, HAL_U32 },
+  { 0 }
+};
+
+static const LCEC_BENCH_GENERIC_PIN_T generic_inputs[] = {
+  { 0x6041, 0x00, 16,  0,  1, HAL_BIT }, { 0x6041, 0x00, 16,  1,  1, HAL_BIT },
+  { 0x6041, 0x00, 16,  2,  1, HAL_BIT }, { 0x6041, 0x00, 16,  3,  1, HAL_BIT },
+  { 0x6041, 0x00, 16,  4,  1, HAL_BIT }, { 0x6041, 0x00, 16,  5,  1, HAL_BIT },
+  { 0x6041, 0x00, 16,  6,  1, HAL_BIT }, { 0x6041, 0x00, 16,  7,  1, HAL_BIT },
+  { 0x6041, 0x00, 16,  8,  2, HAL_U32 }, { 0x6041, 0x00, 16, 10,  1, HAL_BIT },
+  { 0x6041, 0x00, 16, 11,  1, HAL_BIT }, { 0x6041, 0x00, 16, 12,  2, HAL_U32 },
+  { 0x6041, 0x00, 16, 14,  2, HAL_U32 },
+  { 0x6064, 0x00, 32,  0, 32, HAL_S32 }, { 0x606c, 0x00, 32,  0, 32, HAL_S32 },
+  { 0x6077, 0x00, 16,  0, 16, HAL_S32 }, { 0x6061, 0x00,  8,  0,  8, HAL_S32 },
+  { 0x2100, 0x01, 16,  0,  4, HAL_U32 }, { 0x2100, 0x01, 16,  4, 12, HAL_S32 },
+  { 0x2101, 0x01, 32,  0, 12, HAL_FLOAT }, { 0x2101, 0x01, 32, 12, 12, HAL_FLOAT },
+  { 0x2101, 0x01, 32, 24,  8, HAL_U32 },
+  { 0 }
+};
+
+static ec_pdo_entry_info_t generic_pdo_entries[2][LCEC_BENCH_GENERIC_MAX];
+static ec_pdo_info_t generic_pdos[2];
+static ec_sync_info_t generic_syncs[3];
+static lcec_generic_pin_conf_t generic_pin_conf[2 * LCEC_BENCH_GENERIC_MAX];
+static char generic_names[2 * LCEC_BENCH_GENERIC_MAX][LCEC_BENCH_GENERIC_NAMELEN];
+
+static uint32_t rnd_state = 0x12345678;
+
+static uint32_t bench_rand(void) {
+  rnd_state ^= rnd_state << 13;
+  rnd_state ^= rnd_state >> 17;
+  rnd_state ^= rnd_state << 5;
+  return rnd_state;
+}
+
+static long long bench_time(void) {
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+static int perf_open(void) {
+  struct perf_event_attr attr;
+
+  memset(&attr, 0, sizeof(attr));
+  attr.type = PERF_TYPE_HARDWARE;
+  attr.size = sizeof(attr);
+  attr.config = PERF_COUNT_HW_INSTRUCTIONS;
+  attr.disabled = 1;
+  attr.exclude_kernel = 1;
+  attr.exclude_hv = 1;
+
+  return syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0);
+}
+
+static const char *type_name(const lcec_typelist_t *type) {
+  Dl_info info;
+
+  if (dladdr(type->proc_init, &info) && info.dli_sname != NULL) {
+    return info.dli_sname;
+  }
+  return "?";
+}
+
+static int generic_pin_count(void) {
+  return (sizeof(generic_outputs) + sizeof(generic_inputs)) / sizeof(LCEC_BENCH_GENERIC_PIN_T) - 2;
+}
+
+static lcec_generic_pin_conf_t *generic_init_pins(lcec_generic_pin_conf_t *pin, const LCEC_BENCH_GENERIC_PIN_T *p, hal_pin_dir_t dir, const char *pfx) {
+  int i;
+
+  for (i = 0; p->index != 0; i++, p++, pin++) {
+    snprintf(generic_names[pin - generic_pin_conf], LCEC_BENCH_GENERIC_NAMELEN, "%s-%d", pfx, i);
+    pin->name = generic_names[pin - generic_pin_conf];
+    pin->type = p->type;
+    pin->subType = (p->type == HAL_FLOAT) ? lcecPdoEntTypeFloatSigned : lcecPdoEntTypeSimple;
+    pin->floatScale = 1.0;
+    pin->bitOffset = p->bit_offset;
+    pin->bitLength = p->bit_length;
+    pin->dir = dir;
+    pin->pdo_idx = p->index;
+    pin->pdo_sidx = p->subindex;
+  }
+
+  return pin;
+}
+
+static void generic_init_pdos(void) {
+  const LCEC_BENCH_GENERIC_PIN_T *tabs[2] = { generic_outputs, generic_inputs };
+  const LCEC_BENCH_GENERIC_PIN_T *p, *prev;
+  ec_pdo_entry_info_t *entry;
+  lcec_generic_pin_conf_t *pin;
+  int i;
+
+  // one PDO entry per index/subindex
+  for (i = 0; i < 2; i++) {
+    entry = generic_pdo_entries[i];
+    for (p = tabs[i], prev = NULL; p->index != 0; prev = p, p++) {
+      if (prev != NULL && prev->index == p->index && prev->subindex == p->subindex) {
+        continue;
+      }
+      entry->index = p->index;
+      entry->subindex = p->subindex;
+      entry->bit_length = p->entry_bits;
+      entry++;
+    }
+    generic_pdos[i].index = i ? 0x1a00 : 0x1600;
+    generic_pdos[i].n_entries = entry - generic_pdo_entries[i];
+    generic_pdos[i].entries = generic_pdo_entries[i];
+    generic_syncs[i].index = i ? 3 : 2;
+    generic_syncs[i].dir = i ? EC_DIR_INPUT : EC_DIR_OUTPUT;
+    generic_syncs[i].n_pdos = 1;
+    generic_syncs[i].pdos = &generic_pdos[i];
+  }
+  generic_syncs[2].index = 0xff;
+
+  pin = generic_init_pins(generic_pin_conf, generic_outputs, HAL_IN, "out");
+  generic_init_pins(pin, generic_inputs, HAL_OUT, "in");
+}
+
+static void generic_init_slave(lcec_slave_t *slave) {
+  // pin config is only read on init, all slaves share it
+  slave->generic_pin_conf = generic_pin_conf;
+  slave->sync_info = generic_syncs;
+}
+
+static void bus_free(LCEC_BENCH_BUS_T *bus) {
+  int i;
+
+  if (bus->slaves != NULL) {
+    for (i = 0; i < bus->slave_count; i++) {
+      if (bus->slaves[i].proc_cleanup != NULL) {
+        bus->slaves[i].proc_cleanup(&bus->slaves[i]);
+      }
+    }
+    free(bus->slaves);
+  }
+  if (bus->master != NULL) {
+    if (bus->master->master != NULL) {
+      ecrt_release_master(bus->master->master);
+    }
+    free(bus->master);
+  }
+  if (bus->domain != NULL) {
+    lcec_free(bus->domain->read_funcs);
+    lcec_free(bus->domain->write_funcs);
+    free(bus->domain->hal_data);
+    free(bus->domain);
+  }
+  free(bus->regs);
+  free(bus->images);
+  memset(bus, 0, sizeof(LCEC_BENCH_BUS_T));
+}
+
+// slave i gets types[i % type_count]
+static int bus_init(LCEC_BENCH_BUS_T *bus, int comp_id, int type_idx, const lcec_typelist_t **types, int type_count, int count) {
+  lcec_master_t *master;
+  lcec_domain_t *domain;
+  lcec_slave_t *slave;
+  const lcec_typelist_t *type;
+  ec_pdo_entry_reg_t *reg, *dst;
+  int i, j, reg_max;
+
+  memset(bus, 0, sizeof(LCEC_BENCH_BUS_T));
+
+  for (i = 0, reg_max = 0; i < count; i++) {
+    reg_max += types[i % type_count]->pdo_entry_count;
+  }
+
+  // setup master with one domain
+  master = bus->master = calloc(1, sizeof(lcec_master_t));
+  domain = bus->domain = calloc(1, sizeof(lcec_domain_t));
+  bus->slaves = calloc(count, sizeof(lcec_slave_t));
+  bus->regs = calloc(reg_max + 1, sizeof(ec_pdo_entry_reg_t));
+  if (master == NULL || domain == NULL || bus->slaves == NULL || bus->regs == NULL) {
+    fprintf(stderr, "%s: ERROR: unable to allocate memory\n", modname);
+    goto fail;
+  }
+  bus->slave_count = count;
+
+  strcpy(master->name, "b");
+  master->app_time_period = LCEC_BENCH_PERIOD;
+  master->first_domain = master->last_domain = domain;
+  master->master = ecrt_request_master(0);
+  if (master->master == NULL) {
+    goto fail;
+  }
+  domain->master = master;
+  domain->cycle_divider = 1;
+  domain->active = 1;
+  domain->process_data_valid = 1;
+  domain->hal_data = calloc(1, sizeof(lcec_domain_data_t));
+  if (domain->hal_data == NULL) {
+    goto fail;
+  }
+  domain->domain = ecrt_master_create_domain(master->master);
+  if (domain->domain == NULL) {
+    goto fail;
+  }
+
+  // init slaves
+  for (i = 0, slave = bus->slaves, reg = bus->regs; i < count; i++, slave++) {
+    type = types[i % type_count];
+    slave->index = i;
+    snprintf(slave->name, LCEC_CONF_STR_MAXLEN, "%d-%d", type_idx, i);
+    slave->master = master;
+    slave->domain = domain;
+    slave->vid = type->vid;
+    slave->pid = type->pid;
+    slave->pdo_entry_count = type->pdo_entry_count;
+    slave->proc_init = type->proc_init;
+    slave->pdo_entry_regs = reg;
+    reg += type->pdo_entry_count;
+    LCEC_LIST_APPEND(master->first_slave, master->last_slave, slave);
+
+    slave->config = ecrt_master_slave_config(master->master, 0, slave->index, slave->vid, slave->pid);
+    if (slave->config == NULL) {
+      goto fail;
+    }
+    if (type->type == lcecSlaveTypeGeneric) {
+      generic_init_slave(slave);
+    }
+    if (slave->proc_init != NULL && slave->proc_init(comp_id, slave, slave->pdo_entry_regs) != 0) {
+      goto fail;
+    }
+    if (slave->sync_info != NULL && ecrt_slave_config_pdos(slave->config, EC_END, slave->sync_info) != 0) {
+      goto fail;
+    }
+  }
+
+  // drivers may register less entries than reserved
+  for (reg = dst = bus->regs, j = 0; j < reg_max; j++, reg++) {
+    if (reg->index != 0) {
+      *(dst++) = *reg;
+    }
+  }
+  memset(dst, 0, sizeof(ec_pdo_entry_reg_t));
+  bus->reg_count = dst - bus->regs;
+
+  if (ecrt_domain_reg_pdo_entry_list(domain->domain, bus->regs) != 0) {
+    goto fail;
+  }
+  if (ecrt_master_activate(master->master) != 0) {
+    goto fail;
+  }
+  if (lcec_init_domain_funcs(master) != 0) {
+    goto fail;
+  }
+  domain->process_data = ecrt_domain_data(domain->domain);
+  domain->process_data_len = ecrt_domain_size(domain->domain);
+  master->process_data = domain->process_data;
+  master->process_data_len = domain->process_data_len;
+
+  // most drivers skip their work until the slave is in OP
+  for (i = 0, slave = bus->slaves; i < count; i++, slave++) {
+    slave->state.online = 1;
+    slave->state.operational = 1;
+    slave->state.al_state = 0x08;
+  }
+
+  // synthetic process images
+  bus->images = malloc((size_t) LCEC_BENCH_IMAGES * master->process_data_len + 1);
+  if (bus->images == NULL) {
+    goto fail;
+  }
+  for (j = 0; j < LCEC_BENCH_IMAGES * master->process_data_len; j++) {
+    bus->images[j] = bench_rand();
+  }
+
+  return 0;
+
+fail:
+  bus_free(bus);
+  return -1;
+}
+
+// slave list walk of the cyclic code before the dispatch tables
+static void bus_dispatch_list(lcec_master_t *master) {
+  lcec_domain_t *domain;
+  lcec_slave_t *slave;
+
+  for (slave = master->first_slave; slave != NULL; slave = slave->next) {
+    domain = slave->domain;
+    if (slave->proc_read != NULL && domain->active && (domain->process_data_valid || !domain->hal_data->wc_skip_read)) {
+      slave->proc_read(slave, LCEC_BENCH_PERIOD);
+    }
+  }
+  for (slave = master->first_slave; slave != NULL; slave = slave->next) {
+    if (slave->proc_write != NULL && slave->domain->active) {
+      slave->proc_write(slave, LCEC_BENCH_PERIOD);
+    }
+  }
+}
+
+// per domain tables like lcec_process_inputs_master()/_outputs_master()
+static void bus_dispatch_tables(lcec_master_t *master) {
+  lcec_domain_t *domain;
+  lcec_slave_func_t *func;
+  int i;
+
+  for (domain = master->first_domain; domain != NULL; domain = domain->next) {
+    if (!domain->active) {
+      continue;
+    }
+    if (!domain->process_data_valid && domain->hal_data->wc_skip_read) {
+      continue;
+    }
+    for (i = 0, func = domain->read_funcs; i < domain->read_func_count; i++, func++) {
+      func->proc(func->slave, LCEC_BENCH_PERIOD);
+    }
+  }
+  for (domain = master->first_domain; domain != NULL; domain = domain->next) {
+    if (domain->cycle_cnt == 0) {
+      for (i = 0, func = domain->write_funcs; i < domain->write_func_count; i++, func++) {
+        func->proc(func->slave, LCEC_BENCH_PERIOD);
+      }
+    }
+  }
+}
+
+static void bus_cycle(LCEC_BENCH_BUS_T *bus, unsigned long cycle, int run) {
+  lcec_master_t *master = bus->master;
+  lcec_slave_t *slave;
+  int i;
+
+  memcpy(master->process_data, bus->images + (cycle % LCEC_BENCH_IMAGES) * master->process_data_len, master->process_data_len);
+  if (!run) {
+    return;
+  }
+
+  switch (bus->dispatch) {
+    case lcecBenchDispatchList:
+      bus_dispatch_list(master);
+      return;
+    case lcecBenchDispatchTables:
+      bus_dispatch_tables(master);
+      return;
+    default:
+      break;
+  }
+
+  for (i = 0, slave = bus->slaves; i < bus->slave_count; i++, slave++) {
+    if (slave->proc_read != NULL) {
+      slave->proc_read(slave, LCEC_BENCH_PERIOD);
+    }
+  }
+  for (i = 0, slave = bus->slaves; i < bus->slave_count; i++, slave++) {
+    if (slave->proc_write != NULL) {
+      slave->proc_write(slave, LCEC_BENCH_PERIOD);
+    }
+  }
+}
+
+static long long bus_run(LCEC_BENCH_BUS_T *bus, unsigned long cycles, int run, int perf_fd, long long *instr) {
+  long long t_start, t;
+  unsigned long c;
+
+  if (perf_fd >= 0) {
+    ioctl(perf_fd, PERF_EVENT_IOC_RESET, 0);
+    ioctl(perf_fd, PERF_EVENT_IOC_ENABLE, 0);
+  }
+  t_start = bench_time();
+  for (c = 0; c < cycles; c++) {
+    bus_cycle(bus, c, run);
+  }
+  t = bench_time() - t_start;
+  if (perf_fd >= 0) {
+    ioctl(perf_fd, PERF_EVENT_IOC_DISABLE, 0);
+    if (read(perf_fd, instr, sizeof(long long)) != sizeof(long long)) {
+      *instr = 0;
+    }
+  }
+
+  return t;
+}
+
+static void bench_type(LCEC_BENCH_BUS_T *bus, unsigned long cycles, int perf_fd, LCEC_BENCH_RESULT_T *res) {
+  long long t_base, t_run, i_base, i_run;
+
+  // warm up caches and driver state
+  bus_run(bus, LCEC_BENCH_WARMUP, 1, -1, NULL);
+
+  // image copy only as baseline
+  i_base = i_run = 0;
+  t_base = bus_run(bus, cycles, 0, perf_fd, &i_base);
+  t_run = bus_run(bus, cycles, 1, perf_fd, &i_run);
+
+  res->ns_per_slave = (double) (t_run - t_base) / ((double) cycles * bus->slave_count);
+  if (res->ns_per_slave < 0.0) {
+    res->ns_per_slave = 0.0;
+  }
+  res->instr_valid = (perf_fd >= 0);
+  res->instr_per_cycle = (double) (i_run - i_base) / (double) cycles;
+}
+
+static double run_type(const lcec_typelist_t *type, int type_idx, int comp_id, int count, unsigned long cycles, int perf_fd, const char *filter) {
+  LCEC_BENCH_BUS_T bus;
+  LCEC_BENCH_RESULT_T res;
+  const char *name;
+
+  name = type_name(type);
+  if (filter != NULL && strstr(name, filter) == NULL) {
+    return 0.0;
+  }
+
+  if (bus_init(&bus, comp_id, type_idx, &type, 1, count) != 0) {
+    fprintf(stderr, "%s: WARNING: unable to setup %s (pid 0x%08x)\n", modname, name, type->pid);
+    return 0.0;
+  }
+
+  bench_type(&bus, cycles, perf_fd, &res);
+
+  printf("%-28s %08x %08x %7d %12.1f ", name, type->vid, type->pid, bus.reg_count / count, res.ns_per_slave);
+  if (res.instr_valid) {
+    printf("%12.0f\n", res.instr_per_cycle);
+  } else {
+    printf("%12s\n", "-");
+  }
+  fflush(stdout);
+
+  bus_free(&bus);
+  return res.ns_per_slave;
+}
+
+static const lcec_typelist_t *find_type(LCEC_SLAVE_TYPE_T slave_type) {
+  const lcec_typelist_t *type;
+
+  for (type = lcec_types; type->type != lcecSlaveTypeInvalid; type++) {
+    if (type->type == slave_type) {
+      return type;
+    }
+  }
+  return NULL;
+}
+
+static int run_dispatch(int comp_id, int count, unsigned long cycles, int perf_fd) {
+  static const LCEC_BENCH_DISPATCH_T modes[] = { lcecBenchDispatchList, lcecBenchDispatchTables };
+  static const char *mode_names[] = { "slave-list", "domain-tables" };
+  const lcec_typelist_t *types[LCEC_BENCH_DISPATCH_PATTERN];
+  LCEC_BENCH_BUS_T bus;
+  LCEC_BENCH_RESULT_T res;
+  int i;
+
+  // mostly couplers, one input and one output terminal
+  for (i = 0; i < LCEC_BENCH_DISPATCH_PATTERN - 2; i++) {
+    types[i] = find_type(lcecSlaveTypeEK1100);
+  }
+  types[i++] = find_type(lcecSlaveTypeEL1008);
+  types[i++] = find_type(lcecSlaveTypeEL2008);
+  for (i = 0; i < LCEC_BENCH_DISPATCH_PATTERN; i++) {
+    if (types[i] == NULL) {
+      fprintf(stderr, "%s: ERROR: dispatch slave types not found\n", modname);
+      return -1;
+    }
+  }
+
+  if (bus_init(&bus, comp_id, 0, types, LCEC_BENCH_DISPATCH_PATTERN, count) != 0) {
+    fprintf(stderr, "%s: ERROR: unable to setup dispatch bus\n", modname);
+    return -1;
+  }
+
+  printf("# dispatch, %d slaves (%d read, %d write functions), %lu cycles\n",
+    count, bus.domain->read_func_count, bus.domain->write_func_count, cycles);
+  printf("%-28s %12s %12s %12s\n", "dispatch", "ns/cyc", "ns/slave/cyc", "instr/cyc");
+
+  for (i = 0; i < sizeof(modes) / sizeof(modes[0]); i++) {
+    bus.dispatch = modes[i];
+    bench_type(&bus, cycles, perf_fd, &res);
+    printf("%-28s %12.1f %12.2f ", mode_names[i], res.ns_per_slave * count, res.ns_per_slave);
+    if (res.instr_valid) {
+      printf("%12.0f\n", res.instr_per_cycle);
+    } else {
+      printf("%12s\n", "-");
+    }
+    fflush(stdout);
+  }
+
+  bus_free(&bus);
+  return 0;
+}
+
+static void usage(void) {
+  fprintf(stderr, "usage: %s [-n slaves-per-type] [-c cycles] [-f name-filter] [-d]\n", modname);
+}
+
+int main(int argc, char **argv) {
+  int opt;
+  int count = 8;
+  unsigned long cycles = 1000000;
+  const char *filter = NULL;
+  int dispatch = 0;
+  const lcec_typelist_t *type;
+  lcec_typelist_t generic_type = { lcecSlaveTypeGeneric, LCEC_BENCH_GENERIC_VID, LCEC_BENCH_GENERIC_PID, 0, lcec_generic_init };
+  int comp_id, perf_fd;
+  int ret;
+  double total;
+
+  while ((opt = getopt(argc, argv, "n:c:f:dh")) != -1) {
+    switch (opt) {
+      case 'n':
+        count = atoi(optarg);
+        break;
+      case 'c':
+        cycles = strtoul(optarg, NULL, 0);
+        break;
+      case 'f':
+        filter = optarg;
+        break;
+      case 'd':
+        dispatch = 1;
+        break;
+      default:
+        usage();
+        return 1;
+    }
+  }
+  if (count < 1 || cycles < 1) {
+    usage();
+    return 1;
+  }
+
+  comp_id = hal_init(modname);
+
+  perf_fd = perf_open();
+  if (perf_fd < 0) {
+    fprintf(stderr, "%s: WARNING: instruction counter not available\n", modname);
+  }
+
+  if (dispatch) {
+    ret = run_dispatch(comp_id, count, cycles, perf_fd);
+    goto out;
+  }
+
+  printf("# %d slaves per type, %lu cycles\n", count, cycles);
+  printf("%-28s %-8s %-8s %7s %12s %12s\n", "driver", "vid", "pid", "entries", "ns/slave/cyc", "instr/cyc");
+
+  total = 0.0;
+  for (type = lcec_types; type->type != lcecSlaveTypeInvalid; type++) {
+    if (type->proc_init != NULL) {
+      total += run_type(type, type - lcec_types, comp_id, count, cycles, perf_fd, filter);
+    }
+  }
+
+  generic_init_pdos();
+  generic_type.pdo_entry_count = generic_pin_count();
+  total += run_type(&generic_type, type - lcec_types, comp_id, count, cycles, perf_fd, filter);
+
+  printf("# sum of ns/slave/cycle over all types: %.1f\n", total);
+  ret = 0;
+
+out:
+  if (perf_fd >= 0) {
+    close(perf_fd);
+  }
+  hal_exit(comp_id);
+  return (ret == 0) ? 0 : 1;
+}
+
@@ -0,0 +1,84 @@
+//
+//    Copyright (C) 2026 Sascha Ittner <sascha.ittner@modusoft.de>
+//
+//    This program is free software; you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation; either version 2 of the License, or
+//    (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with this program; if not, write to the Free Software
+//    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301 USA
+//
+
+#include "lcec.h"
+#include "lcec_bitbank.h"
+
+lcec_bitbank_t *lcec_bitbank_new(struct lcec_slave *slave, int count) {
+  lcec_master_t *master = slave->master;
+  lcec_bitbank_t *bank;
+  size_t size;
+
+  if (count <= 0 || count > LCEC_BITBANK_MAX) {
+    rtapi_print_msg(RTAPI_MSG_ERR, LCEC_MSG_PFX "invalid bit bank size %d for slave %s.%s\n", count, master->name, slave->name);
+    return NULL;
+  }
+
+  // alloc hal memory
+  size = sizeof(lcec_bitbank_t) + sizeof(lcec_bitbank_pos_t) * count;
+  if ((bank = hal_malloc(size)) == NULL) {
+    rtapi_print_msg(RTAPI_MSG_ERR, LCEC_MSG_PFX "hal_malloc() for slave %s.%s failed\n", master->name, slave->name);
+    return NULL;
+  }
+  memset(bank, 0, size);
+  bank->count = count;
+
+  return bank;
+}
+
+void lcec_bitbank_prepare(lcec_bitbank_t *bank) {
+  unsigned int start;
+  int i;
+
+  // entry positions are final after the domains have been set up
+  bank->os = bank->pos[0].os + (bank->pos[0].bp >> 3);
+  bank->bp = bank->pos[0].bp & 0x07;
+  bank->bytes = (bank->bp + bank->count + 7) >> 3;
+  bank->mask = (~0ULL >> (64 - bank->count)) << bank->bp;
+  bank->continuous = 1;
+  start = (bank->os << 3) + bank->bp;
+  for (i = 1; i < bank->count; i++) {
+    if ((bank->pos[i].os << 3) + bank->pos[i].bp != start + i) {
+      bank->continuous = 0;
+      break;
+    }
+  }
+  bank->prepared = 1;
+}
+
+uint32_t lcec_bitbank_read_slow(lcec_bitbank_t *bank, uint8_t *pd) {
+  lcec_bitbank_pos_t *pos;
+  uint32_t val;
+  int i;
+
+  for (val = 0, i = 0, pos = bank->pos; i < bank->count; i++, pos++) {
+    if (EC_READ_BIT(&pd[pos->os], pos->bp)) {
+      val |= (1U << i);
+    }
+  }
+  return val;
+}
+
+void lcec_bitbank_write_slow(lcec_bitbank_t *bank, uint8_t *pd, uint32_t val) {
+  lcec_bitbank_pos_t *pos;
+  int i;
+
+  for (i = 0, pos = bank->pos; i < bank->count; i++, pos++, val >>= 1) {
+    EC_WRITE_BIT(&pd[pos->os], pos->bp, val & 1);
+  }
+}
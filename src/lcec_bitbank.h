@@ -0,0 +1,108 @@
+//
+//    Copyright (C) 2026 Sascha Ittner <sascha.ittner@modusoft.de>
+//
+//    This program is free software; you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation; either version 2 of the License, or
+//    (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with this program; if not, write to the Free Software
+//    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301 USA
+//
+#ifndef _LCEC_BITBANK_H_
+#define _LCEC_BITBANK_H_
+
+//
+// Bit banks
+//
+// Digital terminals map each channel to its own 1 bit PDO entry, but
+// the master packs them back to back. A bank collects the positions
+// of up to 32 such bits. On first cycle it checks if they form one
+// continuous range and then loads or stores all bits with a few byte
+// accesses instead of one EC_READ_BIT/EC_WRITE_BIT per channel.
+//
+
+#include "lcec.h"
+
+#define LCEC_BITBANK_MAX 32
+
+typedef struct {
+  unsigned int os;
+  unsigned int bp;
+} lcec_bitbank_pos_t;
+
+typedef struct {
+  int count;
+  int prepared;
+  int continuous;
+  unsigned int os;
+  unsigned int bp;
+  int bytes;
+  uint64_t mask;
+  lcec_bitbank_pos_t pos[];
+} lcec_bitbank_t;
+
+lcec_bitbank_t *lcec_bitbank_new(struct lcec_slave *slave, int count);
+void lcec_bitbank_prepare(lcec_bitbank_t *bank);
+uint32_t lcec_bitbank_read_slow(lcec_bitbank_t *bank, uint8_t *pd);
+void lcec_bitbank_write_slow(lcec_bitbank_t *bank, uint8_t *pd, uint32_t val);
+
+// load bytes (<= 5) as little endian word
+static inline uint64_t lcec_bitbank_load_bytes(const uint8_t *p, int bytes) {
+  uint64_t val;
+  int i;
+
+  for (val = 0, i = 0; i < bytes; i++) {
+    val |= (uint64_t) p[i] << (i << 3);
+  }
+  return val;
+}
+
+// store masked bits of a little endian word, other bits of the bytes are kept
+static inline void lcec_bitbank_store_bytes(uint8_t *p, int bytes, uint64_t mask, uint64_t data) {
+  int i;
+
+  data &= mask;
+  for (i = 0; i < bytes; i++, mask >>= 8, data >>= 8) {
+    p[i] = (p[i] & ~mask) | data;
+  }
+}
+
+// load count (<= 32) bits starting at pd[os] bit bp, bit 0 of the result is the first bit
+static inline uint32_t lcec_bitbank_load(const uint8_t *pd, unsigned int os, unsigned int bp, int count) {
+  return (lcec_bitbank_load_bytes(pd + os, (bp + count + 7) >> 3) >> bp) & (~0ULL >> (64 - count));
+}
+
+// store count (<= 32) bits starting at pd[os] bit bp, other bits of the bytes are kept
+static inline void lcec_bitbank_store(uint8_t *pd, unsigned int os, unsigned int bp, int count, uint32_t val) {
+  lcec_bitbank_store_bytes(pd + os, (bp + count + 7) >> 3, (~0ULL >> (64 - count)) << bp, (uint64_t) val << bp);
+}
+
+static inline uint32_t lcec_bitbank_read(lcec_bitbank_t *bank, uint8_t *pd) {
+  if (!bank->prepared) {
+    lcec_bitbank_prepare(bank);
+  }
+  if (!bank->continuous) {
+    return lcec_bitbank_read_slow(bank, pd);
+  }
+  return (lcec_bitbank_load_bytes(pd + bank->os, bank->bytes) & bank->mask) >> bank->bp;
+}
+
+static inline void lcec_bitbank_write(lcec_bitbank_t *bank, uint8_t *pd, uint32_t val) {
+  if (!bank->prepared) {
+    lcec_bitbank_prepare(bank);
+  }
+  if (!bank->continuous) {
+    lcec_bitbank_write_slow(bank, pd, val);
+    return;
+  }
+  lcec_bitbank_store_bytes(pd + bank->os, bank->bytes, bank->mask, (uint64_t) val << bank->bp);
+}
+
+#endif
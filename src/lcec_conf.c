@@ -21,8 +21,6 @@
 #include <string.h>
 #include <ctype.h>
 #include <expat.h>
-#include <signal.h>
-#include <sys/eventfd.h>
 
 #include "rtapi.h"
 #include "hal.h"
@@ -47,11 +45,6 @@ typedef struct {
   const LCEC_CONF_MODPARAM_DESC_T *modParams;
 } LCEC_CONF_TYPELIST_T;
 
-typedef struct {
-  hal_u32_t *master_count;
-  hal_u32_t *slave_count;
-} LCEC_CONF_HAL_T;
-
 static const LCEC_CONF_MODPARAM_DESC_T slaveStMDS5kParams[] = {
   { "isMultiturn", LCEC_STMDS5K_PARAM_MULTITURN, HAL_BIT, 0 } ,
   { "extEnc", LCEC_STMDS5K_PARAM_EXTENC, HAL_U32, LCEC_STMDS5K_EXTINC_PDOS } ,
@@ -228,11 +221,86 @@ static const LCEC_CONF_TYPELIST_T slaveTypes[] = {
   { NULL }
 };
 
-static int hal_comp_id;
-static LCEC_CONF_HAL_T *conf_hal_data;
-static int shmem_id;
+// known xml attributes, resolved by lookupAttr()
+typedef enum {
+  lcecConfAttrIdx,
+  lcecConfAttrName,
+  lcecConfAttrAppTimePeriod,
+  lcecConfAttrRefClockSyncCycles,
+  lcecConfAttrProcessDataTap,
+  lcecConfAttrRecorderDepth,
+  lcecConfAttrThreadCpu,
+  lcecConfAttrSendFirst,
+  lcecConfAttrSlaveStatesPerCycle,
+  lcecConfAttrCycleDivider,
+  lcecConfAttrType,
+  lcecConfAttrDomain,
+  lcecConfAttrVid,
+  lcecConfAttrPid,
+  lcecConfAttrConfigPdos,
+  lcecConfAttrAssignActivate,
+  lcecConfAttrSync0Cycle,
+  lcecConfAttrSync0Shift,
+  lcecConfAttrSync1Cycle,
+  lcecConfAttrSync1Shift,
+  lcecConfAttrDivider,
+  lcecConfAttrIntervals,
+  lcecConfAttrSubIdx,
+  lcecConfAttrDrive,
+  lcecConfAttrIdn,
+  lcecConfAttrData,
+  lcecConfAttrFilename,
+  lcecConfAttrDir,
+  lcecConfAttrBitLen,
+  lcecConfAttrHalType,
+  lcecConfAttrScale,
+  lcecConfAttrOffset,
+  lcecConfAttrHalPin,
+  lcecConfAttrValue,
+} LCEC_CONF_ATTR_ID_T;
+
+static const char * const attrNames[] = {
+  [lcecConfAttrIdx] = "idx",
+  [lcecConfAttrName] = "name",
+  [lcecConfAttrAppTimePeriod] = "appTimePeriod",
+  [lcecConfAttrRefClockSyncCycles] = "refClockSyncCycles",
+  [lcecConfAttrProcessDataTap] = "processDataTap",
+  [lcecConfAttrRecorderDepth] = "recorderDepth",
+  [lcecConfAttrThreadCpu] = "threadCpu",
+  [lcecConfAttrSendFirst] = "sendFirst",
+  [lcecConfAttrSlaveStatesPerCycle] = "slaveStatesPerCycle",
+  [lcecConfAttrCycleDivider] = "cycleDivider",
+  [lcecConfAttrType] = "type",
+  [lcecConfAttrDomain] = "domain",
+  [lcecConfAttrVid] = "vid",
+  [lcecConfAttrPid] = "pid",
+  [lcecConfAttrConfigPdos] = "configPdos",
+  [lcecConfAttrAssignActivate] = "assignActivate",
+  [lcecConfAttrSync0Cycle] = "sync0Cycle",
+  [lcecConfAttrSync0Shift] = "sync0Shift",
+  [lcecConfAttrSync1Cycle] = "sync1Cycle",
+  [lcecConfAttrSync1Shift] = "sync1Shift",
+  [lcecConfAttrDivider] = "divider",
+  [lcecConfAttrIntervals] = "intervals",
+  [lcecConfAttrSubIdx] = "subIdx",
+  [lcecConfAttrDrive] = "drive",
+  [lcecConfAttrIdn] = "idn",
+  [lcecConfAttrData] = "data",
+  [lcecConfAttrFilename] = "filename",
+  [lcecConfAttrDir] = "dir",
+  [lcecConfAttrBitLen] = "bitLen",
+  [lcecConfAttrHalType] = "halType",
+  [lcecConfAttrScale] = "scale",
+  [lcecConfAttrOffset] = "offset",
+  [lcecConfAttrHalPin] = "halPin",
+  [lcecConfAttrValue] = "value",
+  NULL
+};
 
-static int exitEvent;
+// seed without collisions for attrNames
+#define LCEC_CONF_ATTR_SEED 14
+
+static LCEC_CONF_ATTR_MAP_T attrMap = { .names = attrNames, .seed = LCEC_CONF_ATTR_SEED };
 
 typedef struct {
   LCEC_CONF_XML_INST_T xml;
@@ -248,10 +316,17 @@ typedef struct {
   uint8_t currComplexBitOffset;
 
   LCEC_CONF_OUTBUF_T outputBuf;
+  LCEC_CONF_OUTBUF_T sdoBuf;
+  LCEC_CONF_OUTBUF_T idnBuf;
+  LCEC_CONF_OUTBUF_T modParamBuf;
+  LCEC_CONF_STATS_T stats;
+  LCEC_CONF_ICMDS_CACHE_T *icmdsCache;
 } LCEC_CONF_XML_STATE_T;
 
 static void parseMasterAttrs(LCEC_CONF_XML_INST_T *inst, int next, const char **attr);
+static void parseDomainAttrs(LCEC_CONF_XML_INST_T *inst, int next, const char **attr);
 static void parseSlaveAttrs(LCEC_CONF_XML_INST_T *inst, int next, const char **attr);
+static void parseSlaveEnd(LCEC_CONF_XML_INST_T *inst, int next);
 static void parseDcConfAttrs(LCEC_CONF_XML_INST_T *inst, int next, const char **attr);
 static void parseWatchdogAttrs(LCEC_CONF_XML_INST_T *inst, int next, const char **attr);
 static void parseSdoConfigAttrs(LCEC_CONF_XML_INST_T *inst, int next, const char **attr);
@@ -267,7 +342,8 @@ static void parseModParamAttrs(LCEC_CONF_XML_INST_T *inst, int next, const char
 static const LCEC_CONF_XML_HANLDER_T xml_states[] = {
   { "masters", lcecConfTypeNone, lcecConfTypeMasters, NULL, NULL },
   { "master", lcecConfTypeMasters, lcecConfTypeMaster, parseMasterAttrs, NULL },
-  { "slave", lcecConfTypeMaster, lcecConfTypeSlave, parseSlaveAttrs, NULL },
+  { "domain", lcecConfTypeMaster, lcecConfTypeDomain, parseDomainAttrs, NULL },
+  { "slave", lcecConfTypeMaster, lcecConfTypeSlave, parseSlaveAttrs, parseSlaveEnd },
   { "dcConf", lcecConfTypeSlave, lcecConfTypeDcConf, parseDcConfAttrs, NULL },
   { "watchdog", lcecConfTypeSlave, lcecConfTypeWatchdog, parseWatchdogAttrs, NULL },
   { "sdoConfig", lcecConfTypeSlave, lcecConfTypeSdoConfig, parseSdoConfigAttrs, NULL },
@@ -280,155 +356,142 @@ static const LCEC_CONF_XML_HANLDER_T xml_states[] = {
   { "pdoEntry", lcecConfTypePdo, lcecConfTypePdoEntry, parsePdoEntryAttrs, NULL },
   { "complexEntry", lcecConfTypePdoEntry, lcecConfTypeComplexEntry, parseComplexEntryAttrs, NULL },
   { "modParam", lcecConfTypeSlave, lcecConfTypeModParam, parseModParamAttrs, NULL },
-  { "NULL", -1, -1, NULL, NULL }
+  { NULL, -1, -1, NULL, NULL }
 };
 
 static int parseSyncCycle(LCEC_CONF_XML_STATE_T *state, const char *nptr);
 
-static void exitHandler(int sig) {
-  uint64_t u = 1;
-  if (write(exitEvent, &u, sizeof(uint64_t)) < 0) {
-    fprintf(stderr, "%s: ERROR: error writing exit event\n", modname);
+uint64_t getConfigAbiHash(void) {
+  static const size_t sizes[] = {
+    sizeof(void *), sizeof(size_t), sizeof(hal_float_t), LCEC_CONF_STR_MAXLEN, LCEC_CONF_TOKEN_ALIGN,
+    sizeof(LCEC_CONF_HEADER_T), sizeof(LCEC_CONF_MASTER_T), sizeof(LCEC_CONF_DOMAIN_T), sizeof(LCEC_CONF_SLAVE_T),
+    sizeof(LCEC_CONF_DC_T), sizeof(LCEC_CONF_WATCHDOG_T), sizeof(LCEC_CONF_SYNCMANAGER_T), sizeof(LCEC_CONF_PDO_T),
+    sizeof(LCEC_CONF_PDOENTRY_T), sizeof(LCEC_CONF_COMPLEXENTRY_T), sizeof(LCEC_CONF_NULL_T), sizeof(LCEC_CONF_SDOCONF_T),
+    sizeof(LCEC_CONF_IDNCONF_T), sizeof(LCEC_CONF_MODPARAM_T)
+  };
+  const LCEC_CONF_TYPELIST_T *type;
+  const LCEC_CONF_MODPARAM_DESC_T *param;
+  uint32_t magic = LCEC_CONF_SHMEM_MAGIC;
+  uint64_t hash;
+
+  // stream format and token layout
+  hash = hashConfigData(0, &magic, sizeof(magic));
+  hash = hashConfigData(hash, sizes, sizeof(sizes));
+
+  // slave type and modparam ids are part of the stream
+  for (type = slaveTypes; type->name != NULL; type++) {
+    hash = hashConfigData(hash, type->name, strlen(type->name) + 1);
+    hash = hashConfigData(hash, &type->type, sizeof(type->type));
+    for (param = type->modParams; param != NULL && param->name != NULL; param++) {
+      hash = hashConfigData(hash, param->name, strlen(param->name) + 1);
+      hash = hashConfigData(hash, &param->id, sizeof(param->id));
+      hash = hashConfigData(hash, &param->type, sizeof(param->type));
+      hash = hashConfigData(hash, &param->pdoMappingCount, sizeof(param->pdoMappingCount));
+    }
   }
+
+  return hash;
 }
 
-int main(int argc, char **argv) {
-  int ret = 1;
-  char *filename;
-  int done;
-  char buffer[BUFFSIZE];
+int parseConfig(const char *filename, LCEC_CONF_OUTBUF_T *outputBuf, LCEC_CONF_STATS_T *stats) {
+  int ret;
   FILE *file;
-  LCEC_CONF_NULL_T *end;
-  void *shmem_ptr;
-  LCEC_CONF_HEADER_T *header;
-  uint64_t u;
-  LCEC_CONF_XML_STATE_T state;
 
-  // initialize component
-  hal_comp_id = hal_init(modname);
-  if (hal_comp_id < 1) {
-    fprintf(stderr, "%s: ERROR: hal_init failed\n", modname);
-    goto fail0;
+  // open file
+  file = fopen(filename, "r");
+  if (file == NULL) {
+    fprintf(stderr, "%s: ERROR: unable to open config file %s\n", modname, filename);
+    return 1;
   }
 
-  // allocate hal memory
-  conf_hal_data = hal_malloc(sizeof(LCEC_CONF_HAL_T));
-  if (conf_hal_data == NULL) {
-    fprintf(stderr, "%s: ERROR: unable to allocate HAL shared memory\n", modname);
-    goto fail1;
-  }
+  ret = parseConfigFile(file, filename, outputBuf, stats);
+  fclose(file);
+  return ret;
+}
 
-  // register pins
-  if (hal_pin_u32_newf(HAL_OUT, &(conf_hal_data->master_count), hal_comp_id, "%s.conf.master-count", LCEC_MODULE_NAME) != 0) {
-    fprintf(stderr, "%s: ERROR: unable to register pin %s.conf.master-count\n", modname, LCEC_MODULE_NAME);
-    goto fail1;
-  }
-  if (hal_pin_u32_newf(HAL_OUT, &(conf_hal_data->slave_count), hal_comp_id, "%s.conf.slave-count", LCEC_MODULE_NAME) != 0) {
-    fprintf(stderr, "%s: ERROR: unable to register pin %s.conf.slave-count\n", modname, LCEC_MODULE_NAME);
-    goto fail1;
-  }
-  *(conf_hal_data->master_count) = 0;
-  *(conf_hal_data->slave_count) = 0;
+int parseConfigFile(FILE *file, const char *filename, LCEC_CONF_OUTBUF_T *outputBuf, LCEC_CONF_STATS_T *stats) {
+  int ret = 1;
+  int done;
+  char buffer[BUFFSIZE];
+  uint64_t hash;
+  LCEC_CONF_NULL_T *end;
+  LCEC_CONF_XML_STATE_T state;
 
-  // initialize signal handling
-  exitEvent = eventfd(0, 0);
-  if (exitEvent == -1) {
-    fprintf(stderr, "%s: ERROR: unable to create exit event\n", modname);
+  // build attribute lookup
+  if (initAttrMap(&attrMap)) {
     goto fail1;
   }
-  signal(SIGINT, exitHandler);
-  signal(SIGTERM, exitHandler);
-
-  // get config file name
-  if (argc != 2) {
-    fprintf(stderr, "%s: ERROR: invalid arguments\n", modname);
-    goto fail2;
-  }
-  filename = argv[1];
-
-  // open file
-  file = fopen(filename, "r");
-  if (file == NULL) {
-    fprintf(stderr, "%s: ERROR: unable to open config file %s\n", modname, filename);
-    goto fail2;
-  }
 
   // create xml parser
   memset(&state, 0, sizeof(state));
   if (initXmlInst((LCEC_CONF_XML_INST_T *) &state, xml_states)) {
     fprintf(stderr, "%s: ERROR: Couldn't allocate memory for parser\n", modname);
-    goto fail3;
+    goto fail1;
+  }
+
+  // main config is the first input file, its hash is set after parsing
+  if (addConfigDep(&state.stats, filename, 0)) {
+    goto fail2;
   }
+  hash = hashConfigData(0, filename, strlen(filename) + 1);
 
   initOutputBuffer(&state.outputBuf);
+  initOutputBuffer(&state.sdoBuf);
+  initOutputBuffer(&state.idnBuf);
+  initOutputBuffer(&state.modParamBuf);
   for (done=0; !done;) {
     // read block
     int len = fread(buffer, 1, BUFFSIZE, file);
     if (ferror(file)) {
       fprintf(stderr, "%s: ERROR: Couldn't read from file %s\n", modname, filename);
-      goto fail4;
+      goto fail2;
     }
 
     // check for EOF
     done = feof(file);
 
+    // hash exactly what gets parsed for the config cache
+    hash = hashConfigData(hash, buffer, len);
+
     // parse current block
     if (!XML_Parse(state.xml.parser, buffer, len, done)) {
       fprintf(stderr, "%s: ERROR: Parse error at line %u: %s\n", modname,
         (unsigned int)XML_GetCurrentLineNumber(state.xml.parser),
         XML_ErrorString(XML_GetErrorCode(state.xml.parser)));
-      goto fail4;
+      goto fail2;
     }
   }
 
   // set end marker
   end = addOutputBuffer(&state.outputBuf, sizeof(LCEC_CONF_NULL_T));
   if (end == NULL) {
-      goto fail4;
+      goto fail2;
   }
   end->confType = lcecConfTypeNone;
+  state.stats.firstDep->hash = hash;
 
-  // setup shared mem for config
-  shmem_id = rtapi_shmem_new(LCEC_CONF_SHMEM_KEY, hal_comp_id, sizeof(LCEC_CONF_HEADER_T) + state.outputBuf.len);
-  if ( shmem_id < 0 ) {
-    fprintf(stderr, "%s: ERROR: couldn't allocate user/RT shared memory\n", modname);
-    goto fail4;
-  }
-  if (lcec_rtapi_shmem_getptr(shmem_id, &shmem_ptr) < 0) {
-    fprintf(stderr, "%s: ERROR: couldn't map user/RT shared memory\n", modname);
-    goto fail5;
+  // pass buffer to caller
+  *outputBuf = state.outputBuf;
+  if (stats != NULL) {
+    *stats = state.stats;
+  } else {
+    freeConfigDeps(&state.stats);
   }
 
-  // setup header
-  header = shmem_ptr;
-  shmem_ptr += sizeof(LCEC_CONF_HEADER_T);
-  header->magic = LCEC_CONF_SHMEM_MAGIC;
-  header->length = state.outputBuf.len;
-
-  // copy data and free buffer
-  copyFreeOutputBuffer(&state.outputBuf, shmem_ptr);
-
   // everything is fine
-  ret = 0;
-  hal_ready(hal_comp_id);
-
-  // wait for SIGTERM
-  if (read(exitEvent, &u, sizeof(uint64_t)) < 0) {
-    fprintf(stderr, "%s: ERROR: error reading exit event\n", modname);
-  }
+  freeIcmdsCache(&state.icmdsCache);
+  XML_ParserFree(state.xml.parser);
+  return 0;
 
-fail5:
-  rtapi_shmem_delete(shmem_id, hal_comp_id);
-fail4:
+fail2:
   copyFreeOutputBuffer(&state.outputBuf, NULL);
+  copyFreeOutputBuffer(&state.sdoBuf, NULL);
+  copyFreeOutputBuffer(&state.idnBuf, NULL);
+  copyFreeOutputBuffer(&state.modParamBuf, NULL);
+  freeConfigDeps(&state.stats);
+  freeIcmdsCache(&state.icmdsCache);
   XML_ParserFree(state.xml.parser);
-fail3:
-  fclose(file);
-fail2:
-  close(exitEvent);
 fail1:
-  hal_exit(hal_comp_id);
-fail0:
   return ret;
 }
 
@@ -442,35 +505,84 @@ static void parseMasterAttrs(LCEC_CONF_XML_INST_T *inst, int next, const char **
   }
 
   p->confType = lcecConfTypeMaster;
+  p->threadCpu = -1;
   while (*attr) {
     const char *name = *(attr++);
     const char *val = *(attr++);
+    int id = lookupAttr(&attrMap, name);
 
     // parse index
-    if (strcmp(name, "idx") == 0) {
+    if (id == lcecConfAttrIdx) {
       p->index = atoi(val);
       continue;
     }
 
     // parse name
-    if (strcmp(name, "name") == 0) {
+    if (id == lcecConfAttrName) {
       strncpy(p->name, val, LCEC_CONF_STR_MAXLEN);
       p->name[LCEC_CONF_STR_MAXLEN - 1] = 0;
       continue;
     }
 
     // parse appTimePeriod
-    if (strcmp(name, "appTimePeriod") == 0) {
+    if (id == lcecConfAttrAppTimePeriod) {
       p->appTimePeriod = atol(val);
       continue;
     }
 
     // parse refClockSyncCycles
-    if (strcmp(name, "refClockSyncCycles") == 0) {
+    if (id == lcecConfAttrRefClockSyncCycles) {
       p->refClockSyncCycles = atoll(val);
       continue;
     }
 
+    // parse processDataTap
+    if (id == lcecConfAttrProcessDataTap) {
+      p->processDataTap = (strcasecmp(val, "true") == 0);
+      continue;
+    }
+
+    // parse recorderDepth
+    if (id == lcecConfAttrRecorderDepth) {
+      p->recorderDepth = atoi(val);
+      if (p->recorderDepth < 0) {
+        fprintf(stderr, "%s: ERROR: Invalid master recorderDepth %d\n", modname, p->recorderDepth);
+        XML_StopParser(inst->parser, 0);
+        return;
+      }
+      continue;
+    }
+
+    // parse threadCpu (the helper thread busy waits while the
+    // HAL thread runs, this must be an isolated cpu other than
+    // the one of the RTAPI thread calling the lcec functions)
+    if (id == lcecConfAttrThreadCpu) {
+      p->threadCpu = atoi(val);
+      if (p->threadCpu < 0 || p->threadCpu >= sysconf(_SC_NPROCESSORS_CONF)) {
+        fprintf(stderr, "%s: ERROR: Invalid master threadCpu %d\n", modname, p->threadCpu);
+        XML_StopParser(inst->parser, 0);
+        return;
+      }
+      continue;
+    }
+
+    // parse sendFirst
+    if (id == lcecConfAttrSendFirst) {
+      p->sendFirst = (strcasecmp(val, "true") == 0);
+      continue;
+    }
+
+    // parse slaveStatesPerCycle
+    if (id == lcecConfAttrSlaveStatesPerCycle) {
+      p->slaveStatesPerCycle = atoi(val);
+      if (p->slaveStatesPerCycle < 0) {
+        fprintf(stderr, "%s: ERROR: Invalid master slaveStatesPerCycle %d\n", modname, p->slaveStatesPerCycle);
+        XML_StopParser(inst->parser, 0);
+        return;
+      }
+      continue;
+    }
+
     // handle error
     fprintf(stderr, "%s: ERROR: Invalid master attribute %s\n", modname, name);
     XML_StopParser(inst->parser, 0);
@@ -482,10 +594,58 @@ static void parseMasterAttrs(LCEC_CONF_XML_INST_T *inst, int next, const char **
     snprintf(p->name, LCEC_CONF_STR_MAXLEN, "%d", p->index);
   }
 
-  (*(conf_hal_data->master_count))++;
+  state->stats.masterCount++;
   state->currMaster = p;
 }
 
+static void parseDomainAttrs(LCEC_CONF_XML_INST_T *inst, int next, const char **attr) {
+  LCEC_CONF_XML_STATE_T *state = (LCEC_CONF_XML_STATE_T *) inst;
+
+  LCEC_CONF_DOMAIN_T *p = addOutputBuffer(&state->outputBuf, sizeof(LCEC_CONF_DOMAIN_T));
+  if (p == NULL) {
+    XML_StopParser(inst->parser, 0);
+    return;
+  }
+
+  p->confType = lcecConfTypeDomain;
+  p->cycleDivider = 1;
+  while (*attr) {
+    const char *name = *(attr++);
+    const char *val = *(attr++);
+    int id = lookupAttr(&attrMap, name);
+
+    // parse name
+    if (id == lcecConfAttrName) {
+      strncpy(p->name, val, LCEC_CONF_STR_MAXLEN);
+      p->name[LCEC_CONF_STR_MAXLEN - 1] = 0;
+      continue;
+    }
+
+    // parse cycleDivider
+    if (id == lcecConfAttrCycleDivider) {
+      p->cycleDivider = atoi(val);
+      if (p->cycleDivider < 1) {
+        fprintf(stderr, "%s: ERROR: Invalid domain cycleDivider %d\n", modname, p->cycleDivider);
+        XML_StopParser(inst->parser, 0);
+        return;
+      }
+      continue;
+    }
+
+    // handle error
+    fprintf(stderr, "%s: ERROR: Invalid domain attribute %s\n", modname, name);
+    XML_StopParser(inst->parser, 0);
+    return;
+  }
+
+  // name is required
+  if (p->name[0] == 0) {
+    fprintf(stderr, "%s: ERROR: Domain has no name attribute\n", modname);
+    XML_StopParser(inst->parser, 0);
+    return;
+  }
+}
+
 static void parseSlaveAttrs(LCEC_CONF_XML_INST_T *inst, int next, const char **attr) {
   LCEC_CONF_XML_STATE_T *state = (LCEC_CONF_XML_STATE_T *) inst;
 
@@ -504,9 +664,10 @@ static void parseSlaveAttrs(LCEC_CONF_XML_INST_T *inst, int next, const char **a
   while(*iter) {
     const char *name = *(iter++);
     const char *val = *(iter++);
+    int id = lookupAttr(&attrMap, name);
 
     // parse slave type
-    if (strcmp(name, "type") == 0) {
+    if (id == lcecConfAttrType) {
       for (slaveType = slaveTypes; slaveType->name != NULL; slaveType++) {
         if (strcmp(val, slaveType->name) == 0) {
           break;
@@ -525,41 +686,49 @@ static void parseSlaveAttrs(LCEC_CONF_XML_INST_T *inst, int next, const char **a
   while (*attr) {
     const char *name = *(attr++);
     const char *val = *(attr++);
+    int id = lookupAttr(&attrMap, name);
 
     // skip slave type (already parsed)
-    if (strcmp(name, "type") == 0) {
+    if (id == lcecConfAttrType) {
       continue;
     }
 
     // parse index
-    if (strcmp(name, "idx") == 0) {
+    if (id == lcecConfAttrIdx) {
       p->index = atoi(val);
       continue;
     }
 
     // parse name
-    if (strcmp(name, "name") == 0) {
+    if (id == lcecConfAttrName) {
       strncpy(p->name, val, LCEC_CONF_STR_MAXLEN);
       p->name[LCEC_CONF_STR_MAXLEN - 1] = 0;
       continue;
     }
 
+    // parse domain
+    if (id == lcecConfAttrDomain) {
+      strncpy(p->domain, val, LCEC_CONF_STR_MAXLEN);
+      p->domain[LCEC_CONF_STR_MAXLEN - 1] = 0;
+      continue;
+    }
+
     // generic only attributes
     if (p->type == lcecSlaveTypeGeneric) {
       // parse vid (hex value)
-      if (strcmp(name, "vid") == 0) {
+      if (id == lcecConfAttrVid) {
         p->vid = strtol(val, NULL, 16);
         continue;
       }
 
       // parse pid (hex value)
-      if (strcmp(name, "pid") == 0) {
+      if (id == lcecConfAttrPid) {
         p->pid = strtol(val, NULL, 16);
         continue;
       }
 
       // parse configPdos
-      if (strcmp(name, "configPdos") == 0) {
+      if (id == lcecConfAttrConfigPdos) {
         p->configPdos = (strcasecmp(val, "true") == 0);
         continue;
       }
@@ -583,11 +752,23 @@ static void parseSlaveAttrs(LCEC_CONF_XML_INST_T *inst, int next, const char **a
     return;
   }
 
-  (*(conf_hal_data->slave_count))++;
+  state->stats.slaveCount++;
   state->currSlaveType = slaveType;
   state->currSlave = p;
 }
 
+static void parseSlaveEnd(LCEC_CONF_XML_INST_T *inst, int next) {
+  LCEC_CONF_XML_STATE_T *state = (LCEC_CONF_XML_STATE_T *) inst;
+
+  // append grouped SDO, IDN and modparam tokens
+  if (moveOutputBuffer(&state->outputBuf, &state->sdoBuf) ||
+      moveOutputBuffer(&state->outputBuf, &state->idnBuf) ||
+      moveOutputBuffer(&state->outputBuf, &state->modParamBuf)) {
+    XML_StopParser(inst->parser, 0);
+    return;
+  }
+}
+
 static void parseDcConfAttrs(LCEC_CONF_XML_INST_T *inst, int next, const char **attr) {
   LCEC_CONF_XML_STATE_T *state = (LCEC_CONF_XML_STATE_T *) inst;
 
@@ -601,33 +782,34 @@ static void parseDcConfAttrs(LCEC_CONF_XML_INST_T *inst, int next, const char **
   while (*attr) {
     const char *name = *(attr++);
     const char *val = *(attr++);
+    int id = lookupAttr(&attrMap, name);
 
     // parse assignActivate (hex value)
-    if (strcmp(name, "assignActivate") == 0) {
+    if (id == lcecConfAttrAssignActivate) {
       p->assignActivate = strtol(val, NULL, 16);
       continue;
     }
 
     // parse sync0Cycle
-    if (strcmp(name, "sync0Cycle") == 0) {
+    if (id == lcecConfAttrSync0Cycle) {
       p->sync0Cycle = parseSyncCycle(state, val);
       continue;
     }
 
     // parse sync0Shift
-    if (strcmp(name, "sync0Shift") == 0) {
+    if (id == lcecConfAttrSync0Shift) {
       p->sync0Shift = atoi(val);
       continue;
     }
 
     // parse sync1Cycle
-    if (strcmp(name, "sync1Cycle") == 0) {
+    if (id == lcecConfAttrSync1Cycle) {
       p->sync1Cycle = parseSyncCycle(state, val);
       continue;
     }
 
     // parse sync1Shift
-    if (strcmp(name, "sync1Shift") == 0) {
+    if (id == lcecConfAttrSync1Shift) {
       p->sync1Shift = atoi(val);
       continue;
     }
@@ -652,15 +834,16 @@ static void parseWatchdogAttrs(LCEC_CONF_XML_INST_T *inst, int next, const char
   while (*attr) {
     const char *name = *(attr++);
     const char *val = *(attr++);
+    int id = lookupAttr(&attrMap, name);
 
     // parse divider
-    if (strcmp(name, "divider") == 0) {
+    if (id == lcecConfAttrDivider) {
       p->divider = atoi(val);
       continue;
     }
 
     // parse intervals
-    if (strcmp(name, "intervals") == 0) {
+    if (id == lcecConfAttrIntervals) {
       p->intervals = atoi(val);
       continue;
     }
@@ -676,7 +859,7 @@ static void parseSdoConfigAttrs(LCEC_CONF_XML_INST_T *inst, int next, const char
   LCEC_CONF_XML_STATE_T *state = (LCEC_CONF_XML_STATE_T *) inst;
 
   int tmp;
-  LCEC_CONF_SDOCONF_T *p = addOutputBuffer(&state->outputBuf, sizeof(LCEC_CONF_SDOCONF_T));
+  LCEC_CONF_SDOCONF_T *p = addOutputBuffer(&state->sdoBuf, sizeof(LCEC_CONF_SDOCONF_T));
   if (p == NULL) {
     XML_StopParser(inst->parser, 0);
     return;
@@ -688,9 +871,10 @@ static void parseSdoConfigAttrs(LCEC_CONF_XML_INST_T *inst, int next, const char
   while (*attr) {
     const char *name = *(attr++);
     const char *val = *(attr++);
+    int id = lookupAttr(&attrMap, name);
 
     // parse index
-    if (strcmp(name, "idx") == 0) {
+    if (id == lcecConfAttrIdx) {
       tmp = strtol(val, NULL, 16);
       if (tmp < 0 || tmp >= 0xffff) {
         fprintf(stderr, "%s: ERROR: Invalid sdoConfig idx %d\n", modname, tmp);
@@ -702,7 +886,7 @@ static void parseSdoConfigAttrs(LCEC_CONF_XML_INST_T *inst, int next, const char
     }
 
     // parse subIdx
-    if (strcmp(name, "subIdx") == 0) {
+    if (id == lcecConfAttrSubIdx) {
       if (strcasecmp(val, "complete") == 0) {
         p->subindex = LCEC_CONF_SDO_COMPLETE_SUBIDX;
         continue;
@@ -745,7 +929,7 @@ static void parseIdnConfigAttrs(LCEC_CONF_XML_INST_T *inst, int next, const char
   LCEC_CONF_XML_STATE_T *state = (LCEC_CONF_XML_STATE_T *) inst;
 
   int tmp;
-  LCEC_CONF_IDNCONF_T *p = addOutputBuffer(&state->outputBuf, sizeof(LCEC_CONF_IDNCONF_T));
+  LCEC_CONF_IDNCONF_T *p = addOutputBuffer(&state->idnBuf, sizeof(LCEC_CONF_IDNCONF_T));
   if (p == NULL) {
     XML_StopParser(inst->parser, 0);
     return;
@@ -758,9 +942,10 @@ static void parseIdnConfigAttrs(LCEC_CONF_XML_INST_T *inst, int next, const char
   while (*attr) {
     const char *name = *(attr++);
     const char *val = *(attr++);
+    int id = lookupAttr(&attrMap, name);
 
     // parse index
-    if (strcmp(name, "drive") == 0) {
+    if (id == lcecConfAttrDrive) {
       tmp = atoi(val);
       if (tmp < 0 || tmp > 7) {
         fprintf(stderr, "%s: ERROR: Invalid idnConfig drive %d\n", modname, tmp);
@@ -773,7 +958,7 @@ static void parseIdnConfigAttrs(LCEC_CONF_XML_INST_T *inst, int next, const char
     }
 
     // parse idn
-    if (strcmp(name, "idn") == 0) {
+    if (id == lcecConfAttrIdn) {
       char pfx = val[0];
       if (pfx == 0) {
         fprintf(stderr, "%s: ERROR: Missing idnConfig idn value\n", modname);
@@ -820,7 +1005,7 @@ static void parseIdnConfigAttrs(LCEC_CONF_XML_INST_T *inst, int next, const char
     }
 
     // parse state
-    if (strcmp(name, "drive") == 0) {
+    if (id == lcecConfAttrDrive) {
       if (strcmp(val, "PREOP") == 0) {
         p->state = EC_AL_STATE_PREOP;
       } else if (strcmp(val, "SAFEOP") == 0) {
@@ -867,9 +1052,10 @@ static void parseDataRawAttrs(LCEC_CONF_XML_INST_T *inst, int next, const char *
   while (*attr) {
     const char *name = *(attr++);
     const char *val = *(attr++);
+    int id = lookupAttr(&attrMap, name);
 
     // parse data
-    if (strcmp(name, "data") == 0) {
+    if (id == lcecConfAttrData) {
       len = parseHex(val, -1, NULL);
       if (len < 0) {
         fprintf(stderr, "%s: ERROR: Invalid dataRaw data\n", modname);
@@ -877,7 +1063,7 @@ static void parseDataRawAttrs(LCEC_CONF_XML_INST_T *inst, int next, const char *
         return;
       }
       if (len > 0) {
-        p = (uint8_t *) addOutputBuffer(&state->outputBuf, len);
+        p = (uint8_t *) appendOutputBuffer(inst->state == lcecConfTypeSdoConfig ? &state->sdoBuf : &state->idnBuf, len);
         if (p != NULL) {
           parseHex(val, -1, p);
           switch (inst->state) {
@@ -906,13 +1092,15 @@ static void parseInitCmdsAttrs(LCEC_CONF_XML_INST_T *inst, int next, const char
   LCEC_CONF_XML_STATE_T *state = (LCEC_CONF_XML_STATE_T *) inst;
 
   const char *filename = NULL;
+  uint64_t hash;
 
   while (*attr) {
     const char *name = *(attr++);
     const char *val = *(attr++);
+    int id = lookupAttr(&attrMap, name);
 
     // parse filename
-    if (strcmp(name, "filename") == 0) {
+    if (id == lcecConfAttrFilename) {
       filename = val;
       continue;
     }
@@ -931,7 +1119,13 @@ static void parseInitCmdsAttrs(LCEC_CONF_XML_INST_T *inst, int next, const char
   }
 
   // try to parse initCmds
-  if (parseIcmds(state->currSlave, &state->outputBuf, filename)) {
+  if (parseIcmds(state->currSlave, &state->sdoBuf, &state->idnBuf, &state->icmdsCache, filename, &hash)) {
+    XML_StopParser(inst->parser, 0);
+    return;
+  }
+
+  // remember input file for config cache
+  if (addConfigDep(&state->stats, filename, hash)) {
     XML_StopParser(inst->parser, 0);
     return;
   }
@@ -962,9 +1156,10 @@ static void parseSyncManagerAttrs(LCEC_CONF_XML_INST_T *inst, int next, const ch
   while (*attr) {
     const char *name = *(attr++);
     const char *val = *(attr++);
+    int id = lookupAttr(&attrMap, name);
 
     // parse index
-    if (strcmp(name, "idx") == 0) {
+    if (id == lcecConfAttrIdx) {
       tmp = atoi(val);
       if (tmp < 0 || tmp >= EC_MAX_SYNC_MANAGERS) {
         fprintf(stderr, "%s: ERROR: Invalid syncManager idx %d\n", modname, tmp);
@@ -976,7 +1171,7 @@ static void parseSyncManagerAttrs(LCEC_CONF_XML_INST_T *inst, int next, const ch
     }
 
     // parse dir
-    if (strcmp(name, "dir") == 0) {
+    if (id == lcecConfAttrDir) {
       if (strcasecmp(val, "in") == 0) {
         p->dir = EC_DIR_INPUT;
         continue;
@@ -1029,9 +1224,10 @@ static void parsePdoAttrs(LCEC_CONF_XML_INST_T *inst, int next, const char **att
   while (*attr) {
     const char *name = *(attr++);
     const char *val = *(attr++);
+    int id = lookupAttr(&attrMap, name);
 
     // parse index
-    if (strcmp(name, "idx") == 0) {
+    if (id == lcecConfAttrIdx) {
       tmp = strtol(val, NULL, 16);
       if (tmp < 0 || tmp >= 0xffff) {
         fprintf(stderr, "%s: ERROR: Invalid pdo idx %d\n", modname, tmp);
@@ -1079,9 +1275,10 @@ static void parsePdoEntryAttrs(LCEC_CONF_XML_INST_T *inst, int next, const char
   while (*attr) {
     const char *name = *(attr++);
     const char *val = *(attr++);
+    int id = lookupAttr(&attrMap, name);
 
     // parse index
-    if (strcmp(name, "idx") == 0) {
+    if (id == lcecConfAttrIdx) {
       tmp = strtol(val, NULL, 16);
       if (tmp < 0 || tmp >= 0xffff) {
         fprintf(stderr, "%s: ERROR: Invalid pdoEntry idx %d\n", modname, tmp);
@@ -1093,7 +1290,7 @@ static void parsePdoEntryAttrs(LCEC_CONF_XML_INST_T *inst, int next, const char
     }
 
     // parse subIdx
-    if (strcmp(name, "subIdx") == 0) {
+    if (id == lcecConfAttrSubIdx) {
       tmp = strtol(val, NULL, 16);
       if (tmp < 0 || tmp >= 0xff) {
         fprintf(stderr, "%s: ERROR: Invalid pdoEntry subIdx %d\n", modname, tmp);
@@ -1105,7 +1302,7 @@ static void parsePdoEntryAttrs(LCEC_CONF_XML_INST_T *inst, int next, const char
     }
 
     // parse bitLen
-    if (strcmp(name, "bitLen") == 0) {
+    if (id == lcecConfAttrBitLen) {
       tmp = atoi(val);
       if (tmp <= 0 || tmp > LCEC_CONF_GENERIC_MAX_BITLEN) {
         fprintf(stderr, "%s: ERROR: Invalid pdoEntry bitLen %d\n", modname, tmp);
@@ -1117,7 +1314,7 @@ static void parsePdoEntryAttrs(LCEC_CONF_XML_INST_T *inst, int next, const char
     }
 
     // parse halType
-    if (strcmp(name, "halType") == 0) {
+    if (id == lcecConfAttrHalType) {
       if (strcasecmp(val, "bit") == 0) {
         p->halType = HAL_BIT;
         continue;
@@ -1132,6 +1329,16 @@ static void parsePdoEntryAttrs(LCEC_CONF_XML_INST_T *inst, int next, const char
         p->halType = HAL_U32;
         continue;
       }
+      if (strcasecmp(val, "s64") == 0) {
+        p->subType = lcecPdoEntTypeInt64;
+        p->halType = LCEC_HAL_S64;
+        continue;
+      }
+      if (strcasecmp(val, "u64") == 0) {
+        p->subType = lcecPdoEntTypeInt64;
+        p->halType = LCEC_HAL_U64;
+        continue;
+      }
       if (strcasecmp(val, "float") == 0) {
         p->subType = lcecPdoEntTypeFloatSigned;
         p->halType = HAL_FLOAT;
@@ -1142,6 +1349,11 @@ static void parsePdoEntryAttrs(LCEC_CONF_XML_INST_T *inst, int next, const char
         p->halType = HAL_FLOAT;
         continue;
       }
+      if (strcasecmp(val, "float-ieee") == 0) {
+        p->subType = lcecPdoEntTypeFloatIeee;
+        p->halType = HAL_FLOAT;
+        continue;
+      }
       if (strcasecmp(val, "complex") == 0) {
         p->subType = lcecPdoEntTypeComplex;
         continue;
@@ -1152,21 +1364,21 @@ static void parsePdoEntryAttrs(LCEC_CONF_XML_INST_T *inst, int next, const char
     }
 
     // parse scale
-    if (strcmp(name, "scale") == 0) {
+    if (id == lcecConfAttrScale) {
       floatReq = 1;
       p->floatScale = atof(val);
       continue;
     }
 
     // parse offset
-    if (strcmp(name, "offset") == 0) {
+    if (id == lcecConfAttrOffset) {
       floatReq = 1;
       p->floatOffset = atof(val);
       continue;
     }
 
     // parse halPin
-    if (strcmp(name, "halPin") == 0) {
+    if (id == lcecConfAttrHalPin) {
       strncpy(p->halPin, val, LCEC_CONF_STR_MAXLEN);
       p->halPin[LCEC_CONF_STR_MAXLEN - 1] = 0;
       continue;
@@ -1212,6 +1424,13 @@ static void parsePdoEntryAttrs(LCEC_CONF_XML_INST_T *inst, int next, const char
     return;
   }
 
+  // IEEE floats are REAL or LREAL
+  if (p->subType == lcecPdoEntTypeFloatIeee && p->bitLength != 32 && p->bitLength != 64) {
+    fprintf(stderr, "%s: ERROR: pdoEntry bitLen %d is invalid for pin type 'float-ieee'\n", modname, p->bitLength);
+    XML_StopParser(inst->parser, 0);
+    return;
+  }
+
   (state->currSlave->pdoEntryCount)++;
   if (p->halPin[0] != 0) {
     (state->currSlave->pdoMappingCount)++;
@@ -1239,11 +1458,12 @@ static void parseComplexEntryAttrs(LCEC_CONF_XML_INST_T *inst, int next, const c
   while (*attr) {
     const char *name = *(attr++);
     const char *val = *(attr++);
+    int id = lookupAttr(&attrMap, name);
 
     // parse bitLen
-    if (strcmp(name, "bitLen") == 0) {
+    if (id == lcecConfAttrBitLen) {
       tmp = atoi(val);
-      if (tmp <= 0 || tmp > LCEC_CONF_GENERIC_MAX_SUBPINS) {
+      if (tmp <= 0 || tmp > LCEC_CONF_GENERIC_MAX_COMPLEX_BITLEN) {
         fprintf(stderr, "%s: ERROR: Invalid complexEntry bitLen %d\n", modname, tmp);
         XML_StopParser(inst->parser, 0);
         return;
@@ -1258,7 +1478,7 @@ static void parseComplexEntryAttrs(LCEC_CONF_XML_INST_T *inst, int next, const c
     }
 
     // parse halType
-    if (strcmp(name, "halType") == 0) {
+    if (id == lcecConfAttrHalType) {
       if (strcasecmp(val, "bit") == 0) {
         p->subType = lcecPdoEntTypeSimple;
         p->halType = HAL_BIT;
@@ -1274,6 +1494,16 @@ static void parseComplexEntryAttrs(LCEC_CONF_XML_INST_T *inst, int next, const c
         p->halType = HAL_U32;
         continue;
       }
+      if (strcasecmp(val, "s64") == 0) {
+        p->subType = lcecPdoEntTypeInt64;
+        p->halType = LCEC_HAL_S64;
+        continue;
+      }
+      if (strcasecmp(val, "u64") == 0) {
+        p->subType = lcecPdoEntTypeInt64;
+        p->halType = LCEC_HAL_U64;
+        continue;
+      }
       if (strcasecmp(val, "float") == 0) {
         p->subType = lcecPdoEntTypeFloatSigned;
         p->halType = HAL_FLOAT;
@@ -1284,27 +1514,32 @@ static void parseComplexEntryAttrs(LCEC_CONF_XML_INST_T *inst, int next, const c
         p->halType = HAL_FLOAT;
         continue;
       }
+      if (strcasecmp(val, "float-ieee") == 0) {
+        p->subType = lcecPdoEntTypeFloatIeee;
+        p->halType = HAL_FLOAT;
+        continue;
+      }
       fprintf(stderr, "%s: ERROR: Invalid complexEntry halType %s\n", modname, val);
       XML_StopParser(inst->parser, 0);
       return;
     }
 
     // parse scale
-    if (strcmp(name, "scale") == 0) {
+    if (id == lcecConfAttrScale) {
       floatReq = 1;
       p->floatScale = atof(val);
       continue;
     }
 
     // parse offset
-    if (strcmp(name, "offset") == 0) {
+    if (id == lcecConfAttrOffset) {
       floatReq = 1;
       p->floatOffset = atof(val);
       continue;
     }
 
     // parse halPin
-    if (strcmp(name, "halPin") == 0) {
+    if (id == lcecConfAttrHalPin) {
       strncpy(p->halPin, val, LCEC_CONF_STR_MAXLEN);
       p->halPin[LCEC_CONF_STR_MAXLEN - 1] = 0;
       continue;
@@ -1330,6 +1565,20 @@ static void parseComplexEntryAttrs(LCEC_CONF_XML_INST_T *inst, int next, const c
     return;
   }
 
+  // only 64 bit types may use more than 32 bits
+  if (p->bitLength > LCEC_CONF_GENERIC_MAX_SUBPINS && p->subType != lcecPdoEntTypeInt64 && p->subType != lcecPdoEntTypeFloatIeee) {
+    fprintf(stderr, "%s: ERROR: complexEntry bitLen %d needs a 64 bit pin type\n", modname, p->bitLength);
+    XML_StopParser(inst->parser, 0);
+    return;
+  }
+
+  // IEEE floats are REAL or LREAL
+  if (p->subType == lcecPdoEntTypeFloatIeee && p->bitLength != 32 && p->bitLength != 64) {
+    fprintf(stderr, "%s: ERROR: complexEntry bitLen %d is invalid for pin type 'float-ieee'\n", modname, p->bitLength);
+    XML_StopParser(inst->parser, 0);
+    return;
+  }
+
   if (p->halPin[0] != 0) {
     (state->currSlave->pdoMappingCount)++;
   }
@@ -1348,7 +1597,7 @@ static void parseModParamAttrs(LCEC_CONF_XML_INST_T *inst, int next, const char
     return;
   }
 
-  LCEC_CONF_MODPARAM_T *p = addOutputBuffer(&state->outputBuf, sizeof(LCEC_CONF_MODPARAM_T));
+  LCEC_CONF_MODPARAM_T *p = addOutputBuffer(&state->modParamBuf, sizeof(LCEC_CONF_MODPARAM_T));
   if (p == NULL) {
     XML_StopParser(inst->parser, 0);
     return;
@@ -1361,15 +1610,16 @@ static void parseModParamAttrs(LCEC_CONF_XML_INST_T *inst, int next, const char
   while (*attr) {
     const char *name = *(attr++);
     const char *val = *(attr++);
+    int id = lookupAttr(&attrMap, name);
 
     // get name
-    if (strcmp(name, "name") == 0) {
+    if (id == lcecConfAttrName) {
       pname = val;
       continue;
     }
 
     // get value
-    if (strcmp(name, "value") == 0) {
+    if (id == lcecConfAttrValue) {
       pval = val;
       continue;
     }
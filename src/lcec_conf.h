@@ -23,19 +23,51 @@
 
 #define LCEC_MODULE_NAME "lcec"
 
+// the magic has to be changed with every change of the token
+// types or structs below, so mismatched lcec_conf and lcec binaries
+// refuse the config instead of misreading it
 #define LCEC_CONF_SHMEM_KEY   0xACB572C7
-#define LCEC_CONF_SHMEM_MAGIC 0x036ED5A3
+#define LCEC_CONF_SHMEM_MAGIC 0x036ED5A7
+
+// copy: lcec copies the token stream and releases the shmem on load
+// reference: lcec references the tokens in the shmem until unloaded
+#define LCEC_CONF_MODE_COPY      0
+#define LCEC_CONF_MODE_REFERENCE 1
 
 #define LCEC_CONF_STR_MAXLEN 48
 
+// config tokens start aligned in the stream,
+// SDO/IDN data directly follows its token
+#define LCEC_CONF_TOKEN_ALIGN 8
+#define LCEC_CONF_TOKEN_PAD(offset) ((LCEC_CONF_TOKEN_ALIGN - ((offset) & (LCEC_CONF_TOKEN_ALIGN - 1))) & (LCEC_CONF_TOKEN_ALIGN - 1))
+
+// the stream directly follows the header in the page aligned shmem, so
+// tokens are aligned in memory too and the RT module references them
+// there or in its own aligned copy. SDO, IDN and modparam tokens of a slave are grouped by
+// lcec_conf and can be walked until the token type changes.
+#define LCEC_CONF_TOKEN_NEXT(token, size) ((void *) ((char *) (token) + (size) + LCEC_CONF_TOKEN_PAD((uintptr_t) (token) + (size))))
+
 #define LCEC_CONF_SDO_COMPLETE_SUBIDX -1
 #define LCEC_CONF_GENERIC_MAX_SUBPINS 32
 #define LCEC_CONF_GENERIC_MAX_BITLEN  255
+#define LCEC_CONF_GENERIC_MAX_COMPLEX_BITLEN 64
+
+// hack to identify LinuxCNC >= 2.9, which has 64 bit pins. older
+// versions get 64 bit values split into a hi and a lo 32 bit pin.
+#if defined RTAPI_SERIAL && RTAPI_SERIAL >= 2
+#define LCEC_HAL_64BIT
+#define LCEC_HAL_S64 HAL_S64
+#define LCEC_HAL_U64 HAL_U64
+#else
+#define LCEC_HAL_S64 HAL_S32
+#define LCEC_HAL_U64 HAL_U32
+#endif
 
 typedef enum {
   lcecConfTypeNone = 0,
   lcecConfTypeMasters,
   lcecConfTypeMaster,
+  lcecConfTypeDomain,
   lcecConfTypeSlave,
   lcecConfTypeDcConf,
   lcecConfTypeWatchdog,
@@ -55,7 +87,9 @@ typedef enum {
   lcecPdoEntTypeSimple,
   lcecPdoEntTypeFloatSigned,
   lcecPdoEntTypeFloatUnsigned,
-  lcecPdoEntTypeComplex
+  lcecPdoEntTypeComplex,
+  lcecPdoEntTypeInt64,
+  lcecPdoEntTypeFloatIeee
 } LCEC_PDOENT_TYPE_T;
 
 typedef enum {
@@ -164,6 +198,8 @@ typedef enum {
 
 typedef struct {
   uint32_t magic;
+  uint32_t mode;
+  uint32_t inUse;
   size_t length;
 } LCEC_CONF_HEADER_T;
 
@@ -172,9 +208,20 @@ typedef struct {
   int index;
   uint32_t appTimePeriod;
   int refClockSyncCycles;
+  int slaveStatesPerCycle;
+  int sendFirst;
+  int threadCpu;
+  int processDataTap;
+  int recorderDepth;
   char name[LCEC_CONF_STR_MAXLEN];
 } LCEC_CONF_MASTER_T;
 
+typedef struct {
+  LCEC_CONF_TYPE_T confType;
+  int cycleDivider;
+  char name[LCEC_CONF_STR_MAXLEN];
+} LCEC_CONF_DOMAIN_T;
+
 typedef struct {
   LCEC_CONF_TYPE_T confType;
   int index;
@@ -190,6 +237,7 @@ typedef struct {
   size_t idnConfigLength;
   unsigned int modParamCount;
   char name[LCEC_CONF_STR_MAXLEN];
+  char domain[LCEC_CONF_STR_MAXLEN];
 } LCEC_CONF_SLAVE_T;
 
 typedef struct {
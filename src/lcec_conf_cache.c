@@ -0,0 +1,322 @@
+//
+//  Copyright (C) 2026 Sascha Ittner <sascha.ittner@modusoft.de>
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation; either version 2 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301 USA
+//
+
+//
+// Binary config cache
+//
+// lcec_conf -c <cachefile> stores the token stream of a successfully
+// parsed config in <cachefile>. On the next start the cache is used
+// instead of parsing the XML files, as long as the contents of all
+// input files (the main config and every initCmds file) and the build
+// ABI are unchanged. Otherwise the config is parsed and the cache is
+// rewritten.
+//
+// File format (host byte order, all offsets are 8 byte aligned):
+//
+//   LCEC_CONF_CACHE_HEADER_T
+//     magic          LCEC_CONF_CACHE_MAGIC ("LCCC")
+//     version        LCEC_CONF_CACHE_VERSION
+//     abiHash        getConfigAbiHash() of the writer combined with the
+//                    size and mtime of its executable
+//     inputHash      hash over all input files (see below)
+//     masterCount    number of masters in the config
+//     slaveCount     number of slaves in the config
+//     depCount       number of input files
+//     depLength      size of the input file table in bytes
+//     streamLength   size of the token stream in bytes
+//     checksum       hash over the rest of the file, starting with this
+//                    header with checksum set to zero
+//   input file table
+//     depCount zero terminated file names as given to lcec_conf or in
+//     the initCmds filename attribute, the main config first; padded
+//     with zeros to the next 8 byte boundary
+//   token stream
+//     streamLength bytes, exactly as placed after LCEC_CONF_HEADER_T
+//     in the lcec_conf/lcec shared memory
+//
+// Hashes are 64 bit FNV-1a. Every input file is hashed as file name
+// including its zero terminator, followed by the file contents. The
+// writer takes the contents as read by the parser, so a file edited
+// while lcec_conf runs can't end up in the cache with the wrong hash.
+// inputHash is the hash over these file hashes in table order.
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <string.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+
+#include "lcec_conf.h"
+#include "lcec_conf_priv.h"
+
+#define LCEC_CONF_CACHE_ALIGN(len) (((len) + 7) & ~((size_t) 7))
+
+#define FNV64_OFFSET 0xcbf29ce484222325ULL
+#define FNV64_PRIME  0x00000100000001b3ULL
+
+uint64_t hashConfigData(uint64_t hash, const void *data, size_t len) {
+  const uint8_t *p = data;
+
+  if (hash == 0) {
+    hash = FNV64_OFFSET;
+  }
+
+  for (; len > 0; len--, p++) {
+    hash = (hash ^ *p) * FNV64_PRIME;
+  }
+
+  return hash;
+}
+
+int addConfigDep(LCEC_CONF_STATS_T *stats, const char *filename, uint64_t hash) {
+  LCEC_CONF_DEP_T *dep;
+
+  // shared initCmds files are listed only once, a file modified
+  // between two uses has no single content the cache could match
+  for (dep = stats->firstDep; dep != NULL; dep = dep->next) {
+    if (strcmp(dep->filename, filename) == 0) {
+      if (dep->hash != hash) {
+        stats->depChanged = 1;
+      }
+      return 0;
+    }
+  }
+
+  dep = calloc(1, sizeof(LCEC_CONF_DEP_T) + strlen(filename) + 1);
+  if (dep == NULL) {
+    fprintf(stderr, "%s: ERROR: Couldn't allocate memory for input file list\n", modname);
+    return 1;
+  }
+  dep->hash = hash;
+  strcpy(dep->filename, filename);
+
+  if (stats->lastDep != NULL) {
+    stats->lastDep->next = dep;
+  } else {
+    stats->firstDep = dep;
+  }
+  stats->lastDep = dep;
+
+  return 0;
+}
+
+void freeConfigDeps(LCEC_CONF_STATS_T *stats) {
+  LCEC_CONF_DEP_T *dep;
+
+  while (stats->firstDep != NULL) {
+    dep = stats->firstDep;
+    stats->firstDep = dep->next;
+    free(dep);
+  }
+  stats->lastDep = NULL;
+  stats->depChanged = 0;
+}
+
+static uint64_t getCacheChecksum(const LCEC_CONF_CACHE_HEADER_T *header, const void *data, size_t len) {
+  LCEC_CONF_CACHE_HEADER_T tmp;
+
+  tmp = *header;
+  tmp.checksum = 0;
+  return hashConfigData(hashConfigData(0, &tmp, sizeof(tmp)), data, len);
+}
+
+static uint64_t getCacheAbiHash(void) {
+  struct stat st;
+  uint64_t hash;
+
+  hash = getConfigAbiHash();
+
+  // parser changes may alter the stream for the same input
+  if (stat("/proc/self/exe", &st) == 0) {
+    hash = hashConfigData(hash, &st.st_size, sizeof(st.st_size));
+    hash = hashConfigData(hash, &st.st_mtime, sizeof(st.st_mtime));
+  }
+
+  return hash;
+}
+
+static int hashInputFile(uint64_t *hash, const char *filename) {
+  char buffer[65536];
+  ssize_t len;
+  int fd;
+
+  fd = open(filename, O_RDONLY);
+  if (fd < 0) {
+    return 1;
+  }
+
+  *hash = hashConfigData(0, filename, strlen(filename) + 1);
+  while ((len = read(fd, buffer, sizeof(buffer))) > 0) {
+    *hash = hashConfigData(*hash, buffer, len);
+  }
+
+  close(fd);
+  return (len < 0);
+}
+
+int loadConfigCache(const char *cachename, const char *filename, LCEC_CONF_CACHE_T *cache) {
+  const LCEC_CONF_CACHE_HEADER_T *header;
+  const char *dep, *dep_end;
+  struct stat st;
+  uint64_t hash, file_hash;
+  uint32_t i;
+  size_t dep_len;
+  int fd;
+
+  memset(cache, 0, sizeof(LCEC_CONF_CACHE_T));
+
+  // map cache file
+  fd = open(cachename, O_RDONLY);
+  if (fd < 0) {
+    return 1;
+  }
+  if (fstat(fd, &st) != 0 || st.st_size < sizeof(LCEC_CONF_CACHE_HEADER_T)) {
+    close(fd);
+    return 1;
+  }
+  cache->map = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE | MAP_POPULATE, fd, 0);
+  close(fd);
+  if (cache->map == MAP_FAILED) {
+    cache->map = NULL;
+    return 1;
+  }
+  cache->mapLength = st.st_size;
+
+  // check header
+  header = cache->map;
+  if (header->magic != LCEC_CONF_CACHE_MAGIC || header->version != LCEC_CONF_CACHE_VERSION ||
+      header->abiHash != getCacheAbiHash()) {
+    goto miss;
+  }
+  dep_len = LCEC_CONF_CACHE_ALIGN((size_t) header->depLength);
+  if (dep_len > cache->mapLength - sizeof(LCEC_CONF_CACHE_HEADER_T) ||
+      header->streamLength != cache->mapLength - sizeof(LCEC_CONF_CACHE_HEADER_T) - dep_len) {
+    goto miss;
+  }
+  if (header->checksum != getCacheChecksum(header, header + 1, cache->mapLength - sizeof(LCEC_CONF_CACHE_HEADER_T))) {
+    fprintf(stderr, "%s: WARNING: config cache %s is corrupted, ignoring it\n", modname, cachename);
+    goto miss;
+  }
+
+  // check input files, main config first
+  dep = (const char *) (header + 1);
+  dep_end = dep + header->depLength;
+  if (header->depCount == 0 || header->depLength == 0 || dep_end[-1] != 0 || strcmp(dep, filename) != 0) {
+    goto miss;
+  }
+  hash = 0;
+  for (i = 0; i < header->depCount; i++) {
+    if (dep >= dep_end || hashInputFile(&file_hash, dep)) {
+      goto miss;
+    }
+    hash = hashConfigData(hash, &file_hash, sizeof(file_hash));
+    dep += strlen(dep) + 1;
+  }
+  if (dep != dep_end || hash != header->inputHash) {
+    goto miss;
+  }
+
+  cache->stream = (const uint8_t *) (header + 1) + dep_len;
+  cache->length = header->streamLength;
+  cache->stats.masterCount = header->masterCount;
+  cache->stats.slaveCount = header->slaveCount;
+  return 0;
+
+miss:
+  closeConfigCache(cache);
+  return 1;
+}
+
+void closeConfigCache(LCEC_CONF_CACHE_T *cache) {
+  if (cache->map != NULL) {
+    munmap(cache->map, cache->mapLength);
+  }
+  memset(cache, 0, sizeof(LCEC_CONF_CACHE_T));
+}
+
+int saveConfigCache(const char *cachename, const LCEC_CONF_STATS_T *stats, const void *stream, size_t length) {
+  static const uint8_t pad[8] = { 0 };
+  LCEC_CONF_CACHE_HEADER_T header;
+  const LCEC_CONF_DEP_T *dep;
+  char *tmpname;
+  FILE *file;
+  int err;
+
+  if (stats->depChanged) {
+    fprintf(stderr, "%s: WARNING: input files changed while parsing, not updating config cache %s\n", modname, cachename);
+    return 1;
+  }
+
+  // setup header
+  memset(&header, 0, sizeof(header));
+  header.magic = LCEC_CONF_CACHE_MAGIC;
+  header.version = LCEC_CONF_CACHE_VERSION;
+  header.abiHash = getCacheAbiHash();
+  header.masterCount = stats->masterCount;
+  header.slaveCount = stats->slaveCount;
+  header.streamLength = length;
+  for (dep = stats->firstDep; dep != NULL; dep = dep->next) {
+    header.inputHash = hashConfigData(header.inputHash, &dep->hash, sizeof(dep->hash));
+    header.depCount++;
+    header.depLength += strlen(dep->filename) + 1;
+  }
+
+  // write to temp file and rename, so readers never see partial files
+  tmpname = malloc(strlen(cachename) + 5);
+  if (tmpname == NULL) {
+    fprintf(stderr, "%s: ERROR: Couldn't allocate memory for config cache name\n", modname);
+    return 1;
+  }
+  sprintf(tmpname, "%s.tmp", cachename);
+
+  file = fopen(tmpname, "w");
+  if (file == NULL) {
+    fprintf(stderr, "%s: ERROR: unable to create config cache %s\n", modname, tmpname);
+    free(tmpname);
+    return 1;
+  }
+
+  // checksum over header, input file table and stream
+  header.checksum = getCacheChecksum(&header, NULL, 0);
+  for (dep = stats->firstDep; dep != NULL; dep = dep->next) {
+    header.checksum = hashConfigData(header.checksum, dep->filename, strlen(dep->filename) + 1);
+  }
+  header.checksum = hashConfigData(header.checksum, pad, LCEC_CONF_CACHE_ALIGN((size_t) header.depLength) - header.depLength);
+  header.checksum = hashConfigData(header.checksum, stream, length);
+
+  fwrite(&header, sizeof(header), 1, file);
+  for (dep = stats->firstDep; dep != NULL; dep = dep->next) {
+    fwrite(dep->filename, strlen(dep->filename) + 1, 1, file);
+  }
+  fwrite(pad, LCEC_CONF_CACHE_ALIGN((size_t) header.depLength) - header.depLength, 1, file);
+  fwrite(stream, length, 1, file);
+
+  err = ferror(file);
+  if (fclose(file) != 0 || err || rename(tmpname, cachename) != 0) {
+    fprintf(stderr, "%s: ERROR: unable to write config cache %s\n", modname, cachename);
+    unlink(tmpname);
+    free(tmpname);
+    return 1;
+  }
+
+  free(tmpname);
+  return 0;
+}
@@ -0,0 +1,199 @@
+//
+//    Copyright (C) 2026 Sascha Ittner <sascha.ittner@modusoft.de>
+//
+//    This program is free software; you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation; either version 2 of the License, or
+//    (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with this program; if not, write to the Free Software
+//    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301 USA
+//
+
+//
+// Fuzz harness for the config path
+//
+// The first input byte selects the target, the rest is the payload:
+//   even   payload is XML, parsed by the lcec_conf parser; the resulting
+//          token stream is then loaded by the RT side lcec_parse_config()
+//   odd    payload is used as raw token stream for lcec_parse_config()
+//
+// Built with -DLCEC_FUZZ_LIBFUZZER the file only provides
+// LLVMFuzzerTestOneInput() for libFuzzer. Otherwise a main() is added
+// that runs every file given on the command line (or stdin if none) once,
+// which works with AFL and for reproducing crashes:
+//   make -f sim.mk lcec_conf_fuzz
+//   ./lcec_conf_fuzz -max_len=65536 corpus/ ../examples/
+//   make -f sim.mk lcec_conf_fuzz FUZZ_CC=afl-clang-fast FUZZ_CFLAGS="-g -O1"
+//   afl-fuzz -i corpus -o findings ./lcec_conf_fuzz
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+#include "lcec.h"
+#include "lcec_conf_priv.h"
+#include "lcec_fakehal.h"
+
+int lcec_parse_config(void);
+void lcec_clear_config(void);
+
+int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size);
+
+static int publish_config(const void *conf, size_t len) {
+  LCEC_CONF_HEADER_T *header;
+  void *shmem_ptr;
+  int shmem_id;
+
+  shmem_id = rtapi_shmem_new(LCEC_CONF_SHMEM_KEY, 0, sizeof(LCEC_CONF_HEADER_T) + len);
+  if (shmem_id < 0) {
+    return -1;
+  }
+  if (lcec_rtapi_shmem_getptr(shmem_id, &shmem_ptr) < 0) {
+    rtapi_shmem_delete(shmem_id, 0);
+    return -1;
+  }
+
+  header = shmem_ptr;
+  header->magic = LCEC_CONF_SHMEM_MAGIC;
+  header->length = len;
+  if (conf != NULL) {
+    memcpy(shmem_ptr + sizeof(LCEC_CONF_HEADER_T), conf, len);
+  }
+
+  return shmem_id;
+}
+
+static void load_config(int shmem_id) {
+  if (lcec_parse_config() >= 0) {
+    lcec_clear_config();
+  }
+
+  lcec_fakehal_reset();
+  rtapi_shmem_delete(shmem_id, 0);
+}
+
+static void fuzz_xml(const uint8_t *data, size_t size) {
+  LCEC_CONF_OUTBUF_T outputBuf;
+  void *shmem_ptr;
+  FILE *file;
+  int shmem_id;
+
+  // fmemopen() does not accept empty buffers
+  if (size == 0) {
+    return;
+  }
+
+  file = fmemopen((void *) data, size, "r");
+  if (file == NULL) {
+    return;
+  }
+  if (parseConfigFile(file, "fuzz", &outputBuf, NULL)) {
+    fclose(file);
+    return;
+  }
+  fclose(file);
+
+  shmem_id = publish_config(NULL, outputBuf.len);
+  if (shmem_id < 0 || lcec_rtapi_shmem_getptr(shmem_id, &shmem_ptr) < 0) {
+    copyFreeOutputBuffer(&outputBuf, NULL);
+    return;
+  }
+  copyFreeOutputBuffer(&outputBuf, shmem_ptr + sizeof(LCEC_CONF_HEADER_T));
+
+  load_config(shmem_id);
+}
+
+static void fuzz_stream(const uint8_t *data, size_t size) {
+  int shmem_id;
+
+  shmem_id = publish_config(data, size);
+  if (shmem_id < 0) {
+    return;
+  }
+
+  load_config(shmem_id);
+}
+
+int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size) {
+  modname = "lcec_conf_fuzz";
+  lcec_fakehal_msg_level = RTAPI_MSG_NONE;
+
+  if (size == 0) {
+    return 0;
+  }
+
+  if (data[0] & 1) {
+    fuzz_stream(data + 1, size - 1);
+  } else {
+    fuzz_xml(data + 1, size - 1);
+  }
+
+  return 0;
+}
+
+#ifndef LCEC_FUZZ_LIBFUZZER
+static int run_file(FILE *file) {
+  uint8_t *data = NULL;
+  uint8_t *p;
+  size_t size = 0;
+  size_t alloc = 0;
+  size_t len;
+
+  do {
+    if (size == alloc) {
+      alloc = alloc ? alloc * 2 : 65536;
+      p = realloc(data, alloc);
+      if (p == NULL) {
+        free(data);
+        return -1;
+      }
+      data = p;
+    }
+    len = fread(data + size, 1, alloc - size, file);
+    size += len;
+  } while (len > 0);
+
+  if (ferror(file)) {
+    free(data);
+    return -1;
+  }
+
+  LLVMFuzzerTestOneInput(data, size);
+  free(data);
+  return 0;
+}
+
+int main(int argc, char **argv) {
+  FILE *file;
+  int i;
+
+  if (argc < 2) {
+    return run_file(stdin) ? 1 : 0;
+  }
+
+  for (i = 1; i < argc; i++) {
+    file = fopen(argv[i], "r");
+    if (file == NULL) {
+      fprintf(stderr, "lcec_conf_fuzz: ERROR: unable to open %s\n", argv[i]);
+      return 1;
+    }
+    if (run_file(file)) {
+      fprintf(stderr, "lcec_conf_fuzz: ERROR: unable to read %s\n", argv[i]);
+      fclose(file);
+      return 1;
+    }
+    fclose(file);
+  }
+
+  return 0;
+}
+#endif
@@ -17,10 +17,12 @@
 //
 
 #include <stdio.h>
+#include <stdlib.h>
 #include <unistd.h>
 #include <string.h>
 #include <ctype.h>
 #include <expat.h>
+#include <sys/stat.h>
 
 #include "lcec_conf.h"
 #include "lcec_conf_priv.h"
@@ -55,8 +57,10 @@ typedef enum {
 typedef struct {
   LCEC_CONF_XML_INST_T xml;
 
-  LCEC_CONF_SLAVE_T *currSlave;
-  LCEC_CONF_OUTBUF_T *outputBuf;
+  LCEC_CONF_ICMDS_CACHE_T *currEntry;
+  LCEC_CONF_OUTBUF_T sdoBuf;
+  LCEC_CONF_OUTBUF_T idnBuf;
+  LCEC_CONF_OUTBUF_T *dataBuf;
 
   LCEC_CONF_SDOCONF_T *currSdoConf;
   LCEC_CONF_IDNCONF_T *currIdnConf;
@@ -93,69 +97,178 @@ static const LCEC_CONF_XML_HANLDER_T xml_states[] = {
   { "Elements", icmdTypeSoeIcmd, icmdTypeSoeIcmdElements, NULL, NULL },
   { "Attribute", icmdTypeSoeIcmd, icmdTypeSoeIcmdAttribute, NULL, NULL },
   { "Data", icmdTypeSoeIcmd, icmdTypeSoeIcmdData, NULL, NULL },
-  { "NULL", -1, -1, NULL, NULL }
+  { NULL, -1, -1, NULL, NULL }
 };
 
 static long int parse_int(LCEC_CONF_ICMDS_STATE_T *state, const char *s, int len, long int min, long int max);
 static int parse_data(LCEC_CONF_ICMDS_STATE_T *state, const char *s, int len);
 
-int parseIcmds(LCEC_CONF_SLAVE_T *slave, LCEC_CONF_OUTBUF_T *outputBuf, const char *filename) {
+static int flattenTokens(LCEC_CONF_ICMDS_CACHE_T *entry, LCEC_CONF_OUTBUF_T *buf, void **tokens, size_t *length) {
+  *length = buf->len;
+  if (*length > 0) {
+    *tokens = malloc(*length);
+    if (*tokens == NULL) {
+      fprintf(stderr, "%s: ERROR: Couldn't allocate memory for initCmds %s\n", modname, entry->filename);
+      return 1;
+    }
+  }
+  copyFreeOutputBuffer(buf, *tokens);
+  initOutputBuffer(buf);
+
+  return 0;
+}
+
+static int parseIcmdsFile(LCEC_CONF_ICMDS_CACHE_T *entry, FILE *file) {
   int ret = 1;
   int done;
   char buffer[BUFFSIZE];
-  FILE *file;
   LCEC_CONF_ICMDS_STATE_T state;
 
-  // open file
-  file = fopen(filename, "r");
-  if (file == NULL) {
-    fprintf(stderr, "%s: ERROR: unable to open config file %s\n", modname, filename);
-    goto fail1;
-  }
-
   // create xml parser
   memset(&state, 0, sizeof(state));
   if (initXmlInst((LCEC_CONF_XML_INST_T *) &state, xml_states)) {
     fprintf(stderr, "%s: ERROR: Couldn't allocate memory for parser\n", modname);
-    goto fail2;
+    goto fail1;
   }
 
   // setup handlers
   XML_SetCharacterDataHandler(state.xml.parser, xml_data_handler);
 
-  state.currSlave = slave;
-  state.outputBuf = outputBuf;
+  // SDO and IDN tokens are collected in private buffers starting at
+  // an aligned offset, so they could be replayed at any other one
+  initOutputBuffer(&state.sdoBuf);
+  initOutputBuffer(&state.idnBuf);
+  state.currEntry = entry;
+  entry->hash = hashConfigData(0, entry->filename, strlen(entry->filename) + 1);
   for (done=0; !done;) {
     // read block
     int len = fread(buffer, 1, BUFFSIZE, file);
     if (ferror(file)) {
-      fprintf(stderr, "%s: ERROR: Couldn't read from file %s\n", modname, filename);
-      goto fail3;
+      fprintf(stderr, "%s: ERROR: Couldn't read from file %s\n", modname, entry->filename);
+      goto fail2;
     }
 
     // check for EOF
     done = feof(file);
 
+    // hash exactly what gets parsed for the config cache
+    entry->hash = hashConfigData(entry->hash, buffer, len);
+
     // parse current block
     if (!XML_Parse(state.xml.parser, buffer, len, done)) {
       fprintf(stderr, "%s: ERROR: Parse error at line %u: %s\n", modname,
         (unsigned int)XML_GetCurrentLineNumber(state.xml.parser),
         XML_ErrorString(XML_GetErrorCode(state.xml.parser)));
-      goto fail3;
+      goto fail2;
     }
   }
 
+  // flatten tokens
+  if (flattenTokens(entry, &state.sdoBuf, &entry->sdoTokens, &entry->sdoLength) ||
+      flattenTokens(entry, &state.idnBuf, &entry->idnTokens, &entry->idnLength)) {
+    goto fail2;
+  }
+
   // everything is fine
   ret = 0;
 
-fail3:
-  XML_ParserFree(state.xml.parser);
 fail2:
-  fclose(file);
+  copyFreeOutputBuffer(&state.sdoBuf, NULL);
+  copyFreeOutputBuffer(&state.idnBuf, NULL);
+  XML_ParserFree(state.xml.parser);
 fail1:
   return ret;
 }
 
+static int replayTokens(LCEC_CONF_OUTBUF_T *buf, const void *tokens, size_t length) {
+  void *p;
+
+  if (length == 0) {
+    return 0;
+  }
+
+  p = addOutputBuffer(buf, length);
+  if (p == NULL) {
+    return 1;
+  }
+  memcpy(p, tokens, length);
+
+  return 0;
+}
+
+int parseIcmds(LCEC_CONF_SLAVE_T *slave, LCEC_CONF_OUTBUF_T *sdoBuf, LCEC_CONF_OUTBUF_T *idnBuf, LCEC_CONF_ICMDS_CACHE_T **cache, const char *filename, uint64_t *hash) {
+  struct stat st;
+  FILE *file;
+  LCEC_CONF_ICMDS_CACHE_T *entry;
+
+  // open file
+  file = fopen(filename, "r");
+  if (file == NULL) {
+    fprintf(stderr, "%s: ERROR: unable to open config file %s\n", modname, filename);
+    return 1;
+  }
+  if (fstat(fileno(file), &st)) {
+    fprintf(stderr, "%s: ERROR: unable to stat config file %s\n", modname, filename);
+    fclose(file);
+    return 1;
+  }
+
+  // lookup already parsed file
+  for (entry = *cache; entry != NULL; entry = entry->next) {
+    if (strcmp(entry->filename, filename) == 0 &&
+        entry->mtime.tv_sec == st.st_mtim.tv_sec && entry->mtime.tv_nsec == st.st_mtim.tv_nsec) {
+      break;
+    }
+  }
+
+  // parse file on first use
+  if (entry == NULL) {
+    entry = calloc(1, sizeof(LCEC_CONF_ICMDS_CACHE_T) + strlen(filename) + 1);
+    if (entry == NULL) {
+      fprintf(stderr, "%s: ERROR: Couldn't allocate memory for initCmds %s\n", modname, filename);
+      fclose(file);
+      return 1;
+    }
+    strcpy(entry->filename, filename);
+    entry->mtime = st.st_mtim;
+
+    if (parseIcmdsFile(entry, file)) {
+      free(entry->sdoTokens);
+      free(entry->idnTokens);
+      free(entry);
+      fclose(file);
+      return 1;
+    }
+
+    entry->next = *cache;
+    *cache = entry;
+  }
+  fclose(file);
+
+  // replay tokens for this slave
+  if (replayTokens(sdoBuf, entry->sdoTokens, entry->sdoLength) ||
+      replayTokens(idnBuf, entry->idnTokens, entry->idnLength)) {
+    return 1;
+  }
+  slave->sdoConfigLength += entry->sdoConfigLength;
+  slave->idnConfigLength += entry->idnConfigLength;
+  *hash = entry->hash;
+
+  return 0;
+}
+
+void freeIcmdsCache(LCEC_CONF_ICMDS_CACHE_T **cache) {
+  LCEC_CONF_ICMDS_CACHE_T *entry;
+
+  while (*cache != NULL) {
+    entry = *cache;
+    *cache = entry->next;
+    free(entry->sdoTokens);
+    free(entry->idnTokens);
+    free(entry);
+  }
+}
+
 static void xml_data_handler(void *data, const XML_Char *s, int len) {
   LCEC_CONF_XML_INST_T *inst = (LCEC_CONF_XML_INST_T *) data;
   LCEC_CONF_ICMDS_STATE_T *state = (LCEC_CONF_ICMDS_STATE_T *) inst;
@@ -218,7 +331,8 @@ static void xml_data_handler(void *data, const XML_Char *s, int len) {
 static void icmdTypeCoeIcmdStart(LCEC_CONF_XML_INST_T *inst, int next, const char **attr) {
   LCEC_CONF_ICMDS_STATE_T *state = (LCEC_CONF_ICMDS_STATE_T *) inst;
 
-  state->currSdoConf = addOutputBuffer(state->outputBuf, sizeof(LCEC_CONF_SDOCONF_T));
+  state->dataBuf = &state->sdoBuf;
+  state->currSdoConf = addOutputBuffer(state->dataBuf, sizeof(LCEC_CONF_SDOCONF_T));
 
   if (state->currSdoConf == NULL) {
     XML_StopParser(inst->parser, 0);
@@ -258,14 +372,15 @@ static void icmdTypeCoeIcmdEnd(LCEC_CONF_XML_INST_T *inst, int next) {
     return;
   }
 
-  state->currSlave->sdoConfigLength += sizeof(LCEC_CONF_SDOCONF_T) + state->currSdoConf->length;
+  state->currEntry->sdoConfigLength += sizeof(LCEC_CONF_SDOCONF_T) + state->currSdoConf->length;
 }
 
 
 static void icmdTypeSoeIcmdStart(LCEC_CONF_XML_INST_T *inst, int next, const char **attr) {
   LCEC_CONF_ICMDS_STATE_T *state = (LCEC_CONF_ICMDS_STATE_T *) inst;
 
-  state->currIdnConf = addOutputBuffer(state->outputBuf, sizeof(LCEC_CONF_IDNCONF_T));
+  state->dataBuf = &state->idnBuf;
+  state->currIdnConf = addOutputBuffer(state->dataBuf, sizeof(LCEC_CONF_IDNCONF_T));
 
   if (state->currIdnConf == NULL) {
     XML_StopParser(inst->parser, 0);
@@ -293,7 +408,7 @@ static void icmdTypeSoeIcmdEnd(LCEC_CONF_XML_INST_T *inst, int next) {
     return;
   }
 
-  state->currSlave->idnConfigLength += sizeof(LCEC_CONF_IDNCONF_T) + state->currIdnConf->length;
+  state->currEntry->idnConfigLength += sizeof(LCEC_CONF_IDNCONF_T) + state->currIdnConf->length;
 }
 
 static long int parse_int(LCEC_CONF_ICMDS_STATE_T *state, const char *s, int len, long int min, long int max) {
@@ -339,7 +454,7 @@ static int parse_data(LCEC_CONF_ICMDS_STATE_T *state, const char *s, int len) {
   }
 
   // allocate memory
-  p = (uint8_t *) addOutputBuffer(state->outputBuf, size);
+  p = (uint8_t *) appendOutputBuffer(state->dataBuf, size);
   if (p == NULL) {
     XML_StopParser(state->xml.parser, 0);
     return 0;
@@ -0,0 +1,197 @@
+//
+//  Copyright (C) 2012 Sascha Ittner <sascha.ittner@modusoft.de>
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation; either version 2 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301 USA
+//
+
+#include <stdio.h>
+#include <unistd.h>
+#include <string.h>
+#include <signal.h>
+#include <sys/eventfd.h>
+
+#include "rtapi.h"
+#include "hal.h"
+
+#include "lcec_rtapi.h"
+#include "lcec_conf.h"
+#include "lcec_conf_priv.h"
+
+typedef struct {
+  hal_u32_t *master_count;
+  hal_u32_t *slave_count;
+} LCEC_CONF_HAL_T;
+
+static int hal_comp_id;
+static LCEC_CONF_HAL_T *conf_hal_data;
+static int shmem_id;
+
+static int exitEvent;
+
+static void exitHandler(int sig) {
+  uint64_t u = 1;
+  if (write(exitEvent, &u, sizeof(uint64_t)) < 0) {
+    fprintf(stderr, "%s: ERROR: error writing exit event\n", modname);
+  }
+}
+
+int main(int argc, char **argv) {
+  int ret = 1;
+  int opt;
+  char *filename;
+  char *cachename = NULL;
+  uint32_t mode = LCEC_CONF_MODE_COPY;
+  void *shmem_ptr;
+  LCEC_CONF_HEADER_T *header;
+  uint64_t u;
+  LCEC_CONF_OUTBUF_T outputBuf;
+  LCEC_CONF_STATS_T stats;
+  LCEC_CONF_CACHE_T cache;
+  size_t length;
+
+  // initialize component
+  hal_comp_id = hal_init(modname);
+  if (hal_comp_id < 1) {
+    fprintf(stderr, "%s: ERROR: hal_init failed\n", modname);
+    goto fail0;
+  }
+
+  // allocate hal memory
+  conf_hal_data = hal_malloc(sizeof(LCEC_CONF_HAL_T));
+  if (conf_hal_data == NULL) {
+    fprintf(stderr, "%s: ERROR: unable to allocate HAL shared memory\n", modname);
+    goto fail1;
+  }
+
+  // register pins
+  if (hal_pin_u32_newf(HAL_OUT, &(conf_hal_data->master_count), hal_comp_id, "%s.conf.master-count", LCEC_MODULE_NAME) != 0) {
+    fprintf(stderr, "%s: ERROR: unable to register pin %s.conf.master-count\n", modname, LCEC_MODULE_NAME);
+    goto fail1;
+  }
+  if (hal_pin_u32_newf(HAL_OUT, &(conf_hal_data->slave_count), hal_comp_id, "%s.conf.slave-count", LCEC_MODULE_NAME) != 0) {
+    fprintf(stderr, "%s: ERROR: unable to register pin %s.conf.slave-count\n", modname, LCEC_MODULE_NAME);
+    goto fail1;
+  }
+  *(conf_hal_data->master_count) = 0;
+  *(conf_hal_data->slave_count) = 0;
+
+  // initialize signal handling
+  exitEvent = eventfd(0, 0);
+  if (exitEvent == -1) {
+    fprintf(stderr, "%s: ERROR: unable to create exit event\n", modname);
+    goto fail1;
+  }
+  signal(SIGINT, exitHandler);
+  signal(SIGTERM, exitHandler);
+
+  // get config file name and options
+  while ((opt = getopt(argc, argv, "c:r")) != -1) {
+    switch (opt) {
+      case 'c':
+        cachename = optarg;
+        break;
+      case 'r':
+        mode = LCEC_CONF_MODE_REFERENCE;
+        break;
+      default:
+        fprintf(stderr, "%s: ERROR: invalid arguments\n", modname);
+        goto fail2;
+    }
+  }
+  if (optind != argc - 1) {
+    fprintf(stderr, "%s: ERROR: invalid arguments\n", modname);
+    goto fail2;
+  }
+  filename = argv[optind];
+
+  // use cached config if inputs are unchanged, else parse config file
+  initOutputBuffer(&outputBuf);
+  memset(&stats, 0, sizeof(stats));
+  memset(&cache, 0, sizeof(cache));
+  if (cachename != NULL && loadConfigCache(cachename, filename, &cache) == 0) {
+    length = cache.length;
+    stats = cache.stats;
+  } else {
+    if (parseConfig(filename, &outputBuf, &stats)) {
+      goto fail2;
+    }
+    length = outputBuf.len;
+  }
+  *(conf_hal_data->master_count) = stats.masterCount;
+  *(conf_hal_data->slave_count) = stats.slaveCount;
+
+  // setup shared mem for config
+  shmem_id = rtapi_shmem_new(LCEC_CONF_SHMEM_KEY, hal_comp_id, sizeof(LCEC_CONF_HEADER_T) + length);
+  if ( shmem_id < 0 ) {
+    fprintf(stderr, "%s: ERROR: couldn't allocate user/RT shared memory\n", modname);
+    goto fail3;
+  }
+  if (lcec_rtapi_shmem_getptr(shmem_id, &shmem_ptr) < 0) {
+    fprintf(stderr, "%s: ERROR: couldn't map user/RT shared memory\n", modname);
+    goto fail4;
+  }
+
+  // never overwrite a config the RT module references in place. A
+  // segment left behind by a crashed lcec_conf is not in use and reused.
+  header = shmem_ptr;
+  if (header->magic == LCEC_CONF_SHMEM_MAGIC && header->inUse) {
+    fprintf(stderr, "%s: ERROR: user/RT shared memory still in use by %s\n", modname, LCEC_MODULE_NAME);
+    goto fail4;
+  }
+
+  // setup header
+  shmem_ptr += sizeof(LCEC_CONF_HEADER_T);
+  header->magic = LCEC_CONF_SHMEM_MAGIC;
+  header->mode = mode;
+  header->inUse = 0;
+  header->length = length;
+
+  // copy data and free buffer
+  if (cache.map != NULL) {
+    memcpy(shmem_ptr, cache.stream, length);
+    closeConfigCache(&cache);
+  } else {
+    copyFreeOutputBuffer(&outputBuf, shmem_ptr);
+
+    // update cache, failing here is not fatal
+    if (cachename != NULL) {
+      saveConfigCache(cachename, &stats, shmem_ptr, length);
+    }
+  }
+  freeConfigDeps(&stats);
+
+  // everything is fine
+  ret = 0;
+  hal_ready(hal_comp_id);
+
+  // wait for SIGTERM
+  if (read(exitEvent, &u, sizeof(uint64_t)) < 0) {
+    fprintf(stderr, "%s: ERROR: error reading exit event\n", modname);
+  }
+
+fail4:
+  rtapi_shmem_delete(shmem_id, hal_comp_id);
+fail3:
+  copyFreeOutputBuffer(&outputBuf, NULL);
+  closeConfigCache(&cache);
+  freeConfigDeps(&stats);
+fail2:
+  close(exitEvent);
+fail1:
+  hal_exit(hal_comp_id);
+fail0:
+  return ret;
+}
+
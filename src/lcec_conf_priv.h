@@ -18,16 +18,29 @@
 #ifndef _LCEC_CONF_PRIV_H_
 #define _LCEC_CONF_PRIV_H_
 
+#include <stdio.h>
+#include <time.h>
 #include <expat.h>
 
 #define BUFFSIZE 8192
 
+#define LCEC_CONF_OUTBUF_CHUNK_SIZE (256 * 1024)
+
+#define LCEC_CONF_XML_HASH_BITS 8
+#define LCEC_CONF_XML_HASH_SIZE (1 << LCEC_CONF_XML_HASH_BITS)
+
+#define LCEC_CONF_ATTR_HASH_BITS 8
+#define LCEC_CONF_ATTR_HASH_SIZE (1 << LCEC_CONF_ATTR_HASH_BITS)
+
 struct LCEC_CONF_XML_HANLDER;
 
 typedef struct LCEC_CONF_XML_INST {
   XML_Parser parser;
   const struct LCEC_CONF_XML_HANLDER *states;
   int state;
+  // state table index + 1, hashed by (state_from, el) and (state_to, el)
+  uint16_t startHash[LCEC_CONF_XML_HASH_SIZE];
+  uint16_t endHash[LCEC_CONF_XML_HASH_SIZE];
 } LCEC_CONF_XML_INST_T;
 
 typedef struct LCEC_CONF_XML_HANLDER {
@@ -38,27 +51,112 @@ typedef struct LCEC_CONF_XML_HANLDER {
   void (*end_handler)(struct LCEC_CONF_XML_INST *inst, int next);
 } LCEC_CONF_XML_HANLDER_T;
 
-typedef struct LCEC_CONF_OUTBUF_ITEM {
-  size_t len;
-  struct LCEC_CONF_OUTBUF_ITEM *next;
-} LCEC_CONF_OUTBUF_ITEM_T;
+// attribute names are mapped to their table index by a
+// collision free hash. The seed is preset with the map, initAttrMap()
+// searches a new one only if it collides (update the preset then).
+typedef struct {
+  const char * const *names;
+  uint32_t seed;
+  int ready;
+  int16_t slots[LCEC_CONF_ATTR_HASH_SIZE];
+} LCEC_CONF_ATTR_MAP_T;
+
+// tokens are bump allocated from zeroed chunks, so pointers
+// returned by addOutputBuffer() stay valid until the buffer is freed
+typedef struct LCEC_CONF_OUTBUF_CHUNK {
+  struct LCEC_CONF_OUTBUF_CHUNK *next;
+  size_t size;
+  size_t start;
+  size_t used;
+  uint8_t data[];
+} LCEC_CONF_OUTBUF_CHUNK_T;
 
 typedef struct {
-  LCEC_CONF_OUTBUF_ITEM_T *head;
-  LCEC_CONF_OUTBUF_ITEM_T *tail;
+  LCEC_CONF_OUTBUF_CHUNK_T *head;
+  LCEC_CONF_OUTBUF_CHUNK_T *tail;
   size_t len;
 } LCEC_CONF_OUTBUF_T;
 
+typedef struct LCEC_CONF_DEP {
+  struct LCEC_CONF_DEP *next;
+  uint64_t hash;
+  char filename[];
+} LCEC_CONF_DEP_T;
+
+typedef struct {
+  unsigned int masterCount;
+  unsigned int slaveCount;
+  LCEC_CONF_DEP_T *firstDep;
+  LCEC_CONF_DEP_T *lastDep;
+  int depChanged;
+} LCEC_CONF_STATS_T;
+
+#define LCEC_CONF_CACHE_MAGIC   0x4343434C
+#define LCEC_CONF_CACHE_VERSION 2
+
+// binary config cache file header, see lcec_conf_cache.c
+typedef struct {
+  uint32_t magic;
+  uint32_t version;
+  uint64_t abiHash;
+  uint64_t inputHash;
+  uint32_t masterCount;
+  uint32_t slaveCount;
+  uint32_t depCount;
+  uint32_t depLength;
+  uint64_t streamLength;
+  uint64_t checksum;
+} LCEC_CONF_CACHE_HEADER_T;
+
+typedef struct {
+  void *map;
+  size_t mapLength;
+  const void *stream;
+  size_t length;
+  LCEC_CONF_STATS_T stats;
+} LCEC_CONF_CACHE_T;
+
+// parsed initCmds files, replayed for every slave referencing them
+typedef struct LCEC_CONF_ICMDS_CACHE {
+  struct LCEC_CONF_ICMDS_CACHE *next;
+  struct timespec mtime;
+  uint64_t hash;
+  size_t sdoConfigLength;
+  size_t idnConfigLength;
+  size_t sdoLength;
+  size_t idnLength;
+  void *sdoTokens;
+  void *idnTokens;
+  char filename[];
+} LCEC_CONF_ICMDS_CACHE_T;
+
 extern char *modname;
 
 void initOutputBuffer(LCEC_CONF_OUTBUF_T *buf);
 void *addOutputBuffer(LCEC_CONF_OUTBUF_T *buf, size_t len);
+void *appendOutputBuffer(LCEC_CONF_OUTBUF_T *buf, size_t len);
 void copyFreeOutputBuffer(LCEC_CONF_OUTBUF_T *buf, void *dest);
+int moveOutputBuffer(LCEC_CONF_OUTBUF_T *dest, LCEC_CONF_OUTBUF_T *src);
 
-int parseIcmds(LCEC_CONF_SLAVE_T *slave, LCEC_CONF_OUTBUF_T *outputBuf, const char *filename);
+int parseConfig(const char *filename, LCEC_CONF_OUTBUF_T *outputBuf, LCEC_CONF_STATS_T *stats);
+int parseConfigFile(FILE *file, const char *filename, LCEC_CONF_OUTBUF_T *outputBuf, LCEC_CONF_STATS_T *stats);
+int parseIcmds(LCEC_CONF_SLAVE_T *slave, LCEC_CONF_OUTBUF_T *sdoBuf, LCEC_CONF_OUTBUF_T *idnBuf, LCEC_CONF_ICMDS_CACHE_T **cache, const char *filename, uint64_t *hash);
+void freeIcmdsCache(LCEC_CONF_ICMDS_CACHE_T **cache);
 
 int initXmlInst(LCEC_CONF_XML_INST_T *inst, const LCEC_CONF_XML_HANLDER_T *states);
 
+int initAttrMap(LCEC_CONF_ATTR_MAP_T *map);
+int lookupAttr(const LCEC_CONF_ATTR_MAP_T *map, const char *name);
+
 int parseHex(const char *s, int slen, uint8_t *buf);
 
+uint64_t hashConfigData(uint64_t hash, const void *data, size_t len);
+uint64_t getConfigAbiHash(void);
+
+int addConfigDep(LCEC_CONF_STATS_T *stats, const char *filename, uint64_t hash);
+void freeConfigDeps(LCEC_CONF_STATS_T *stats);
+int loadConfigCache(const char *cachename, const char *filename, LCEC_CONF_CACHE_T *cache);
+void closeConfigCache(LCEC_CONF_CACHE_T *cache);
+int saveConfigCache(const char *cachename, const LCEC_CONF_STATS_T *stats, const void *stream, size_t length);
+
 #endif
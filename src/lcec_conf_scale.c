@@ -0,0 +1,236 @@
+//
+//    Copyright (C) 2026 Sascha Ittner <sascha.ittner@modusoft.de>
+//
+//    This program is free software; you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation; either version 2 of the License, or
+//    (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with this program; if not, write to the Free Software
+//    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301 USA
+//
+
+//
+// Config parser scaling test
+//
+// Generates configs with a growing number of generic slaves (each with
+// the given number of PDO entries, half outputs and half inputs), runs
+// them through the lcec_conf parser and loads the resulting token stream
+// with the RT side lcec_parse_config().
+//
+// One CSV row is printed per bus size:
+//   xml_bytes       size of the generated XML file
+//   parse_us        XML parsing into the output buffer
+//   chunks          output buffer chunks
+//   stream_bytes    length of the token stream
+//   heap_bytes      heap held by the output buffer after parsing
+//   copy_us         copyFreeOutputBuffer() into the shared memory
+//   load_us         lcec_parse_config() on the RT side
+//   maxrss_kb       peak resident set size of the process so far
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <time.h>
+#include <malloc.h>
+#include <sys/stat.h>
+#include <sys/resource.h>
+
+#include "lcec.h"
+#include "lcec_conf_priv.h"
+#include "lcec_fakehal.h"
+
+#define LCEC_SCALE_ENTRIES  32
+#define LCEC_SCALE_MAX_RUNS 16
+
+int lcec_parse_config(void);
+void lcec_clear_config(void);
+
+static const char *entry_types[] = { "bit", "u32", "s32", "float" };
+static const int entry_bits[] = { 1, 16, 32, 16 };
+
+static long long now_ns(void) {
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+static void write_entries(FILE *f, int base, int count) {
+  int i;
+
+  for (i = 0; i < count; i++) {
+    fprintf(f, "          <pdoEntry idx=\"%04x\" subIdx=\"%02x\" bitLen=\"%d\" halPin=\"pin-%d\" halType=\"%s\"/>\n",
+      base + (i >> 8), (i & 0xff) + 1, entry_bits[i & 3], i, entry_types[i & 3]);
+  }
+}
+
+static int write_config(const char *filename, int slaves, int entries) {
+  FILE *f;
+  int i;
+
+  f = fopen(filename, "w");
+  if (f == NULL) {
+    return -1;
+  }
+
+  fprintf(f, "<masters>\n");
+  fprintf(f, "  <master idx=\"0\" appTimePeriod=\"1000000\" refClockSyncCycles=\"1000\">\n");
+  for (i = 0; i < slaves; i++) {
+    fprintf(f, "    <slave idx=\"%d\" type=\"generic\" vid=\"00000999\" pid=\"00000001\" configPdos=\"true\">\n", i);
+    fprintf(f, "      <syncManager idx=\"2\" dir=\"out\">\n        <pdo idx=\"1600\">\n");
+    write_entries(f, 0x2000, entries / 2);
+    fprintf(f, "        </pdo>\n      </syncManager>\n");
+    fprintf(f, "      <syncManager idx=\"3\" dir=\"in\">\n        <pdo idx=\"1a00\">\n");
+    write_entries(f, 0x3000, entries - entries / 2);
+    fprintf(f, "        </pdo>\n      </syncManager>\n");
+    fprintf(f, "    </slave>\n");
+  }
+  fprintf(f, "  </master>\n");
+  fprintf(f, "</masters>\n");
+
+  return fclose(f);
+}
+
+static int run_size(int slaves, int entries, const char *conf_name) {
+  LCEC_CONF_OUTBUF_T outputBuf;
+  LCEC_CONF_OUTBUF_CHUNK_T *chunk;
+  LCEC_CONF_HEADER_T *header;
+  struct mallinfo2 mi;
+  struct rusage ru;
+  struct stat st;
+  void *shmem_ptr;
+  int shmem_id;
+  size_t heap_base, heap_bytes, chunks, stream_bytes;
+  long long t0, parse_ns, copy_ns, load_ns;
+
+  if (write_config(conf_name, slaves, entries) != 0 || stat(conf_name, &st) != 0) {
+    fprintf(stderr, "%s: ERROR: unable to write %s\n", modname, conf_name);
+    return -1;
+  }
+
+  // parse into output buffer
+  malloc_trim(0);
+  mi = mallinfo2();
+  heap_base = mi.uordblks + mi.hblkhd;
+  t0 = now_ns();
+  if (parseConfig(conf_name, &outputBuf, NULL)) {
+    return -1;
+  }
+  parse_ns = now_ns() - t0;
+  mi = mallinfo2();
+  heap_bytes = mi.uordblks + mi.hblkhd - heap_base;
+
+  stream_bytes = outputBuf.len;
+  chunks = 0;
+  for (chunk = outputBuf.head; chunk != NULL; chunk = chunk->next) {
+    chunks++;
+  }
+
+  // publish
+  shmem_id = rtapi_shmem_new(LCEC_CONF_SHMEM_KEY, 0, sizeof(LCEC_CONF_HEADER_T) + outputBuf.len);
+  if (shmem_id < 0 || lcec_rtapi_shmem_getptr(shmem_id, &shmem_ptr) < 0) {
+    fprintf(stderr, "%s: ERROR: couldn't allocate config shared memory\n", modname);
+    copyFreeOutputBuffer(&outputBuf, NULL);
+    return -1;
+  }
+  header = shmem_ptr;
+  header->magic = LCEC_CONF_SHMEM_MAGIC;
+  header->length = outputBuf.len;
+  t0 = now_ns();
+  copyFreeOutputBuffer(&outputBuf, shmem_ptr + sizeof(LCEC_CONF_HEADER_T));
+  copy_ns = now_ns() - t0;
+
+  // load on RT side
+  t0 = now_ns();
+  if (lcec_parse_config() != slaves) {
+    fprintf(stderr, "%s: ERROR: RT side config load failed\n", modname);
+    lcec_fakehal_reset();
+    rtapi_shmem_delete(shmem_id, 0);
+    return -1;
+  }
+  load_ns = now_ns() - t0;
+  lcec_clear_config();
+  lcec_fakehal_reset();
+  rtapi_shmem_delete(shmem_id, 0);
+
+  getrusage(RUSAGE_SELF, &ru);
+  printf("%d,%d,%lld,%lld,%zu,%zu,%zu,%lld,%lld,%ld\n",
+    slaves, entries, (long long) st.st_size, parse_ns / 1000, chunks, stream_bytes, heap_bytes,
+    copy_ns / 1000, load_ns / 1000, ru.ru_maxrss);
+  fflush(stdout);
+
+  return 0;
+}
+
+static void usage(void) {
+  fprintf(stderr, "usage: %s [-s slaves[,slaves...]] [-e entries-per-slave]\n", modname);
+}
+
+int main(int argc, char **argv) {
+  int opt;
+  int sizes[LCEC_SCALE_MAX_RUNS] = { 1000, 2000, 5000, 10000 };
+  int size_count = 4;
+  int entries = LCEC_SCALE_ENTRIES;
+  int i, ret;
+  char *tok, *save;
+  char conf_name[] = "/tmp/lcec_conf_scale_XXXXXX";
+
+  modname = "lcec_conf_scale";
+
+  while ((opt = getopt(argc, argv, "s:e:h")) != -1) {
+    switch (opt) {
+      case 's':
+        size_count = 0;
+        for (tok = strtok_r(optarg, ",", &save); tok != NULL && size_count < LCEC_SCALE_MAX_RUNS; tok = strtok_r(NULL, ",", &save)) {
+          sizes[size_count++] = atoi(tok);
+        }
+        break;
+      case 'e':
+        entries = atoi(optarg);
+        break;
+      default:
+        usage();
+        return 1;
+    }
+  }
+  if (size_count == 0 || entries < 2 || entries > 1024) {
+    usage();
+    return 1;
+  }
+  for (i = 0; i < size_count; i++) {
+    if (sizes[i] < 1) {
+      usage();
+      return 1;
+    }
+  }
+
+  ret = mkstemp(conf_name);
+  if (ret < 0) {
+    fprintf(stderr, "%s: ERROR: unable to create temporary config file\n", modname);
+    return 1;
+  }
+  close(ret);
+
+  printf("slaves,entries,xml_bytes,parse_us,chunks,stream_bytes,heap_bytes,copy_us,load_us,maxrss_kb\n");
+  fflush(stdout);
+
+  ret = 0;
+  for (i = 0; i < size_count; i++) {
+    if (run_size(sizes[i], entries, conf_name) != 0) {
+      ret = 1;
+      break;
+    }
+  }
+
+  unlink(conf_name);
+  return ret;
+}
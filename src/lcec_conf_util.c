@@ -36,47 +36,145 @@ void initOutputBuffer(LCEC_CONF_OUTBUF_T *buf) {
   buf->len = 0;
 }
 
-void *addOutputBuffer(LCEC_CONF_OUTBUF_T *buf, size_t len) {
-
-  void *p = calloc(1, sizeof(LCEC_CONF_OUTBUF_ITEM_T) + len);
-  if (p == NULL) {
-    fprintf(stderr, "%s: ERROR: Couldn't allocate memory for config token\n", modname);
-    return NULL;
-  }
+static void *allocOutputBuffer(LCEC_CONF_OUTBUF_T *buf, size_t pad, size_t len) {
+  LCEC_CONF_OUTBUF_CHUNK_T *chunk = buf->tail;
+  size_t size;
+  void *p;
 
-  // setup header
-  LCEC_CONF_OUTBUF_ITEM_T *header = p;
-  p += sizeof(LCEC_CONF_OUTBUF_ITEM_T);
-  header->len = len;
-  buf->len += len;
+  // start new chunk if token does not fit. Data starts at the stream
+  // offset modulo the token alignment, so tokens are aligned in the
+  // chunk like in the final stream (the chunk header size is a
+  // multiple of 8).
+  if (chunk == NULL || chunk->size - chunk->used < pad + len) {
+    size = (pad + len > LCEC_CONF_OUTBUF_CHUNK_SIZE) ? pad + len : LCEC_CONF_OUTBUF_CHUNK_SIZE;
+    size += LCEC_CONF_TOKEN_ALIGN;
+    chunk = calloc(1, sizeof(LCEC_CONF_OUTBUF_CHUNK_T) + size);
+    if (chunk == NULL) {
+      fprintf(stderr, "%s: ERROR: Couldn't allocate memory for config token\n", modname);
+      return NULL;
+    }
+    chunk->size = size;
+    chunk->start = buf->len & (LCEC_CONF_TOKEN_ALIGN - 1);
+    chunk->used = chunk->start;
 
-  // update list
-  if (buf->head == NULL) {
-    buf->head = header;
-  }
-  if (buf->tail != NULL) {
-    buf->tail->next = header;
+    // update list
+    if (buf->head == NULL) {
+      buf->head = chunk;
+    }
+    if (buf->tail != NULL) {
+      buf->tail->next = chunk;
+    }
+    buf->tail = chunk;
   }
-  buf->tail = header;
+
+  // bump allocate token, padding stays zeroed
+  p = chunk->data + chunk->used + pad;
+  chunk->used += pad + len;
+  buf->len += pad + len;
 
   return p;
 }
 
+void *addOutputBuffer(LCEC_CONF_OUTBUF_T *buf, size_t len) {
+  return allocOutputBuffer(buf, LCEC_CONF_TOKEN_PAD(buf->len), len);
+}
+
+void *appendOutputBuffer(LCEC_CONF_OUTBUF_T *buf, size_t len) {
+  return allocOutputBuffer(buf, 0, len);
+}
+
 void copyFreeOutputBuffer(LCEC_CONF_OUTBUF_T *buf, void *dest) {
-  void *p;
+  LCEC_CONF_OUTBUF_CHUNK_T *chunk;
 
   while (buf->head != NULL) {
-    p = buf->head;
+    chunk = buf->head;
     if (dest != NULL) {
-      memcpy(dest, p + sizeof(LCEC_CONF_OUTBUF_ITEM_T), buf->head->len);
-      dest += buf->head->len;
+      memcpy(dest, chunk->data + chunk->start, chunk->used - chunk->start);
+      dest += chunk->used - chunk->start;
     }
-    buf->head = buf->head->next;
-    free(p);
+    buf->head = chunk->next;
+    free(chunk);
+  }
+  buf->tail = NULL;
+}
+
+static uint32_t xmlHash(uint32_t seed, const char *s) {
+  uint32_t h = 2166136261u ^ (seed * 0x9e3779b1u);
+
+  // FNV-1a
+  for (; *s != 0; s++) {
+    h = (h ^ (uint8_t) *s) * 16777619u;
+  }
+  return h ^ (h >> 16);
+}
+
+static int addXmlHash(uint16_t *table, int state, const char *el, int idx) {
+  uint32_t slot;
+  int n;
+
+  // open addressing with linear probing
+  slot = xmlHash(state, el);
+  for (n = 0; n < LCEC_CONF_XML_HASH_SIZE; n++, slot++) {
+    if (table[slot & (LCEC_CONF_XML_HASH_SIZE - 1)] == 0) {
+      table[slot & (LCEC_CONF_XML_HASH_SIZE - 1)] = idx + 1;
+      return 0;
+    }
+  }
+
+  return 1;
+}
+
+static const LCEC_CONF_XML_HANLDER_T *findXmlHash(const LCEC_CONF_XML_INST_T *inst, const uint16_t *table, int end, const char *el) {
+  const LCEC_CONF_XML_HANLDER_T *state;
+  uint32_t slot;
+  int idx;
+
+  for (slot = xmlHash(inst->state, el); (idx = table[slot & (LCEC_CONF_XML_HASH_SIZE - 1)]) != 0; slot++) {
+    state = &inst->states[idx - 1];
+    if (inst->state == (end ? state->state_to : state->state_from) && strcmp(el, state->el) == 0) {
+      return state;
+    }
+  }
+
+  return NULL;
+}
+
+int moveOutputBuffer(LCEC_CONF_OUTBUF_T *dest, LCEC_CONF_OUTBUF_T *src) {
+  void *p;
+
+  if (src->len == 0) {
+    return 0;
   }
+
+  // src starts aligned, so its tokens stay aligned in dest
+  p = addOutputBuffer(dest, src->len);
+  if (p == NULL) {
+    return 1;
+  }
+  copyFreeOutputBuffer(src, p);
+  initOutputBuffer(src);
+
+  return 0;
 }
 
 int initXmlInst(LCEC_CONF_XML_INST_T *inst, const LCEC_CONF_XML_HANLDER_T *states) {
+  const LCEC_CONF_XML_HANLDER_T *state;
+
+  // build transition lookup tables, keep them at most half full
+  memset(inst->startHash, 0, sizeof(inst->startHash));
+  memset(inst->endHash, 0, sizeof(inst->endHash));
+  for (state = states; state->el != NULL; state++) {
+    if ((state - states) >= LCEC_CONF_XML_HASH_SIZE / 2) {
+      fprintf(stderr, "%s: ERROR: Too many xml states\n", modname);
+      return 1;
+    }
+    if (addXmlHash(inst->startHash, state->state_from, state->el, state - states) ||
+        addXmlHash(inst->endHash, state->state_to, state->el, state - states)) {
+      fprintf(stderr, "%s: ERROR: xml state lookup table full\n", modname);
+      return 1;
+    }
+  }
+
   // create xml parser
   inst->parser = XML_ParserCreate(NULL);
   if (inst->parser == NULL) {
@@ -98,14 +196,13 @@ static void xml_start_handler(void *data, const char *el, const char **attr) {
   LCEC_CONF_XML_INST_T *inst = (LCEC_CONF_XML_INST_T *) data;
   const LCEC_CONF_XML_HANLDER_T *state;
 
-  for (state = inst->states; state->el != NULL; state++) {
-    if (inst->state == state->state_from && (strcmp(el, state->el) == 0)) {
-      if (state->start_handler != NULL) {
-        state->start_handler(inst, state->state_to, attr);
-      }
-      inst->state = state->state_to;
-      return;
-    } 
+  state = findXmlHash(inst, inst->startHash, 0, el);
+  if (state != NULL) {
+    if (state->start_handler != NULL) {
+      state->start_handler(inst, state->state_to, attr);
+    }
+    inst->state = state->state_to;
+    return;
   }
 
   fprintf(stderr, "%s: ERROR: unexpected node %s found\n", modname, el);
@@ -116,20 +213,71 @@ static void xml_end_handler(void *data, const char *el) {
   LCEC_CONF_XML_INST_T *inst = (LCEC_CONF_XML_INST_T *) data;
   const LCEC_CONF_XML_HANLDER_T *state;
 
-  for (state = inst->states; state->el != NULL; state++) {
-    if (inst->state == state->state_to && (strcmp(el, state->el) == 0)) {
-      if (state->end_handler != NULL) {
-        state->end_handler(inst, state->state_from);
-      }
-      inst->state = state->state_from;
-      return;
-    } 
+  state = findXmlHash(inst, inst->endHash, 1, el);
+  if (state != NULL) {
+    if (state->end_handler != NULL) {
+      state->end_handler(inst, state->state_from);
+    }
+    inst->state = state->state_from;
+    return;
   }
 
   fprintf(stderr, "%s: ERROR: unexpected close tag %s found\n", modname, el);
   XML_StopParser(inst->parser, 0);
 }
 
+static int fillAttrSlots(LCEC_CONF_ATTR_MAP_T *map) {
+  const char * const *name;
+  int16_t *slot;
+
+  memset(map->slots, 0xff, sizeof(map->slots));
+  for (name = map->names; *name != NULL; name++) {
+    slot = &map->slots[xmlHash(map->seed, *name) & (LCEC_CONF_ATTR_HASH_SIZE - 1)];
+    if (*slot >= 0) {
+      return 1;
+    }
+    *slot = name - map->names;
+  }
+
+  return 0;
+}
+
+int initAttrMap(LCEC_CONF_ATTR_MAP_T *map) {
+  // names are constant, build once
+  if (map->ready) {
+    return 0;
+  }
+
+  // preset seed, search for another one if it collides
+  // after the names were changed
+  if (map->seed == 0 || fillAttrSlots(map)) {
+    for (map->seed = 1; map->seed < 0x10000; map->seed++) {
+      if (!fillAttrSlots(map)) {
+        break;
+      }
+    }
+    if (map->seed >= 0x10000) {
+      fprintf(stderr, "%s: ERROR: Unable to build attribute map\n", modname);
+      return 1;
+    }
+  }
+
+  map->ready = 1;
+  return 0;
+}
+
+int lookupAttr(const LCEC_CONF_ATTR_MAP_T *map, const char *name) {
+  int idx;
+
+  // a single compare to reject unknown names
+  idx = map->slots[xmlHash(map->seed, name) & (LCEC_CONF_ATTR_HASH_SIZE - 1)];
+  if (idx < 0 || strcmp(name, map->names[idx]) != 0) {
+    return -1;
+  }
+
+  return idx;
+}
+
 int parseHex(const char *s, int slen, uint8_t *buf) {
   char c;
   int len;
@@ -18,14 +18,18 @@
 
 #include "lcec.h"
 #include "lcec_el1xxx.h"
+#include "lcec_bitbank.h"
 
 typedef struct {
   hal_bit_t *in;
   hal_bit_t *in_not;
-  unsigned int pdo_os;
-  unsigned int pdo_bp;
 } lcec_el1xxx_pin_t;
 
+typedef struct {
+  lcec_bitbank_t *bank;
+  lcec_el1xxx_pin_t pins[];
+} lcec_el1xxx_data_t;
+
 static const lcec_pindesc_t slave_pins[] = {
   { HAL_BIT, HAL_OUT, offsetof(lcec_el1xxx_pin_t, in), "%s.%s.%s.din-%d" },
   { HAL_BIT, HAL_OUT, offsetof(lcec_el1xxx_pin_t, in_not), "%s.%s.%s.din-%d-not" },
@@ -36,8 +40,9 @@ void lcec_el1xxx_read(struct lcec_slave *slave, long period);
 
 int lcec_el1xxx_init(int comp_id, struct lcec_slave *slave, ec_pdo_entry_reg_t *pdo_entry_regs) {
   lcec_master_t *master = slave->master;
-  lcec_el1xxx_pin_t *hal_data;
+  lcec_el1xxx_data_t *hal_data;
   lcec_el1xxx_pin_t *pin;
+  lcec_bitbank_t *bank;
   int i;
   int err;
 
@@ -45,17 +50,23 @@ int lcec_el1xxx_init(int comp_id, struct lcec_slave *slave, ec_pdo_entry_reg_t *
   slave->proc_read = lcec_el1xxx_read;
 
   // alloc hal memory
-  if ((hal_data = hal_malloc(sizeof(lcec_el1xxx_pin_t) * slave->pdo_entry_count)) == NULL) {
+  if ((hal_data = hal_malloc(sizeof(lcec_el1xxx_data_t) + sizeof(lcec_el1xxx_pin_t) * slave->pdo_entry_count)) == NULL) {
     rtapi_print_msg(RTAPI_MSG_ERR, LCEC_MSG_PFX "hal_malloc() for slave %s.%s failed\n", master->name, slave->name);
     return -EIO;
   }
-  memset(hal_data, 0, sizeof(lcec_el1xxx_pin_t) * slave->pdo_entry_count);
+  memset(hal_data, 0, sizeof(lcec_el1xxx_data_t) + sizeof(lcec_el1xxx_pin_t) * slave->pdo_entry_count);
   slave->hal_data = hal_data;
 
+  // one entry per channel
+  if ((bank = lcec_bitbank_new(slave, slave->pdo_entry_count)) == NULL) {
+    return -EIO;
+  }
+  hal_data->bank = bank;
+
   // initialize pins
-  for (i=0, pin=hal_data; i<slave->pdo_entry_count; i++, pin++) {
+  for (i=0, pin=hal_data->pins; i<slave->pdo_entry_count; i++, pin++) {
     // initialize POD entry
-    LCEC_PDO_INIT(pdo_entry_regs, slave->index, slave->vid, slave->pid, 0x6000 + (i << 4), 0x01, &pin->pdo_os, &pin->pdo_bp);
+    LCEC_PDO_INIT(pdo_entry_regs, slave->index, slave->vid, slave->pid, 0x6000 + (i << 4), 0x01, &bank->pos[i].os, &bank->pos[i].bp);
 
     // export pins
     if ((err = lcec_pin_newf_list(pin, slave_pins, LCEC_MODULE_NAME, master->name, slave->name, i)) != 0) {
@@ -68,9 +79,10 @@ int lcec_el1xxx_init(int comp_id, struct lcec_slave *slave, ec_pdo_entry_reg_t *
 
 void lcec_el1xxx_read(struct lcec_slave *slave, long period) {
   lcec_master_t *master = slave->master;
-  lcec_el1xxx_pin_t *hal_data = (lcec_el1xxx_pin_t *) slave->hal_data;
+  lcec_el1xxx_data_t *hal_data = (lcec_el1xxx_data_t *) slave->hal_data;
   uint8_t *pd = master->process_data;
   lcec_el1xxx_pin_t *pin;
+  uint32_t val;
   int i, s;
 
   // wait for slave to be operational
@@ -79,8 +91,9 @@ void lcec_el1xxx_read(struct lcec_slave *slave, long period) {
   }
 
   // check inputs
-  for (i=0, pin=hal_data; i<slave->pdo_entry_count; i++, pin++) {
-    s = EC_READ_BIT(&pd[pin->pdo_os], pin->pdo_bp);
+  val = lcec_bitbank_read(hal_data->bank, pd);
+  for (i=0, pin=hal_data->pins; i<slave->pdo_entry_count; i++, pin++, val >>= 1) {
+    s = val & 1;
     *(pin->in) = s;
     *(pin->in_not) = !s;
   }
@@ -18,20 +18,25 @@
 
 #include "lcec.h"
 #include "lcec_el2xxx.h"
+#include "lcec_bitbank.h"
 
 typedef struct {
   hal_bit_t *out;
   hal_bit_t invert;
-  unsigned int pdo_os;
-  unsigned int pdo_bp;
 } lcec_el2xxx_pin_t;
 
+typedef struct {
+  lcec_bitbank_t *bank;
+  lcec_el2xxx_pin_t pins[];
+} lcec_el2xxx_data_t;
+
 void lcec_el2xxx_write(struct lcec_slave *slave, long period);
 
 int lcec_el2xxx_init(int comp_id, struct lcec_slave *slave, ec_pdo_entry_reg_t *pdo_entry_regs) {
   lcec_master_t *master = slave->master;
-  lcec_el2xxx_pin_t *hal_data;
+  lcec_el2xxx_data_t *hal_data;
   lcec_el2xxx_pin_t *pin;
+  lcec_bitbank_t *bank;
   int i;
   int err;
 
@@ -39,17 +44,23 @@ int lcec_el2xxx_init(int comp_id, struct lcec_slave *slave, ec_pdo_entry_reg_t *
   slave->proc_write = lcec_el2xxx_write;
 
   // alloc hal memory
-  if ((hal_data = hal_malloc(sizeof(lcec_el2xxx_pin_t) * slave->pdo_entry_count)) == NULL) {
+  if ((hal_data = hal_malloc(sizeof(lcec_el2xxx_data_t) + sizeof(lcec_el2xxx_pin_t) * slave->pdo_entry_count)) == NULL) {
     rtapi_print_msg(RTAPI_MSG_ERR, LCEC_MSG_PFX "hal_malloc() for slave %s.%s failed\n", master->name, slave->name);
     return -EIO;
   }
-  memset(hal_data, 0, sizeof(lcec_el2xxx_pin_t) * slave->pdo_entry_count);
+  memset(hal_data, 0, sizeof(lcec_el2xxx_data_t) + sizeof(lcec_el2xxx_pin_t) * slave->pdo_entry_count);
   slave->hal_data = hal_data;
 
+  // one entry per channel
+  if ((bank = lcec_bitbank_new(slave, slave->pdo_entry_count)) == NULL) {
+    return -EIO;
+  }
+  hal_data->bank = bank;
+
   // initialize pins
-  for (i=0, pin=hal_data; i<slave->pdo_entry_count; i++, pin++) {
+  for (i=0, pin=hal_data->pins; i<slave->pdo_entry_count; i++, pin++) {
     // initialize POD entry
-    LCEC_PDO_INIT(pdo_entry_regs, slave->index, slave->vid, slave->pid, 0x7000 + (i << 4), 0x01, &pin->pdo_os, &pin->pdo_bp);
+    LCEC_PDO_INIT(pdo_entry_regs, slave->index, slave->vid, slave->pid, 0x7000 + (i << 4), 0x01, &bank->pos[i].os, &bank->pos[i].bp);
 
     // export pins
     if ((err = lcec_pin_newf(HAL_BIT, HAL_IN, (void **) &(pin->out), "%s.%s.%s.dout-%d", LCEC_MODULE_NAME, master->name, slave->name, i)) != 0) {
@@ -69,18 +80,22 @@ int lcec_el2xxx_init(int comp_id, struct lcec_slave *slave, ec_pdo_entry_reg_t *
 
 void lcec_el2xxx_write(struct lcec_slave *slave, long period) {
   lcec_master_t *master = slave->master;
-  lcec_el2xxx_pin_t *hal_data = (lcec_el2xxx_pin_t *) slave->hal_data;
+  lcec_el2xxx_data_t *hal_data = (lcec_el2xxx_data_t *) slave->hal_data;
   uint8_t *pd = master->process_data;
   lcec_el2xxx_pin_t *pin;
+  uint32_t val;
   int i, s;
 
   // set outputs
-  for (i=0, pin=hal_data; i<slave->pdo_entry_count; i++, pin++) {
+  for (i=0, val=0, pin=hal_data->pins; i<slave->pdo_entry_count; i++, pin++) {
     s = *(pin->out);
     if (pin->invert) {
       s = !s;
     }
-    EC_WRITE_BIT(&pd[pin->pdo_os], pin->pdo_bp, s);
+    if (s) {
+      val |= (1U << i);
+    }
   }
+  lcec_bitbank_write(hal_data->bank, pd, val);
 }
 
@@ -179,7 +179,7 @@ int lcec_el6900_init(int comp_id, struct lcec_slave *slave, ec_pdo_entry_reg_t *
   slave->proc_write = lcec_el6900_write;
 
   // count fsoe slaves
-  for (fsoe_idx = 0, p = slave->modparams; p != NULL && p->id >= 0; p++) {
+  for (fsoe_idx = 0, p = slave->modparams; p != NULL && p->confType == lcecConfTypeModParam; p = LCEC_CONF_TOKEN_NEXT(p, sizeof(*p))) {
     if (p->id == LCEC_EL6900_PARAM_SLAVEID) {
       fsoe_idx++;
     }
@@ -228,7 +228,7 @@ int lcec_el6900_init(int comp_id, struct lcec_slave *slave, ec_pdo_entry_reg_t *
   }
 
   // map and export fsoe slave data
-  for (fsoe_idx = 0, fsoe_data = hal_data->fsoe, p = slave->modparams; p != NULL && p->id >= 0; p++) {
+  for (fsoe_idx = 0, fsoe_data = hal_data->fsoe, p = slave->modparams; p != NULL && p->confType == lcecConfTypeModParam; p = LCEC_CONF_TOKEN_NEXT(p, sizeof(*p))) {
     if (p->id == LCEC_EL6900_PARAM_SLAVEID) {
       // find slave
       index = p->value.u32;
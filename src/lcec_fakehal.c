@@ -0,0 +1,342 @@
+//
+//    Copyright (C) 2026 Sascha Ittner <sascha.ittner@modusoft.de>
+//
+//    This program is free software; you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation; either version 2 of the License, or
+//    (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with this program; if not, write to the Free Software
+//    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301 USA
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "lcec.h"
+#include "lcec_fakehal.h"
+
+#define LCEC_FAKEHAL_SHMEM_MAX 64
+#define LCEC_FAKEHAL_HASH_BITS 12
+
+typedef struct {
+  int key;
+  int refs;
+  unsigned long size;
+  void *ptr;
+} LCEC_FAKEHAL_SHMEM_T;
+
+typedef union lcec_fakehal_mem {
+  union lcec_fakehal_mem *next;
+  long double align;
+} LCEC_FAKEHAL_MEM_T;
+
+int lcec_fakehal_msg_level = RTAPI_MSG_ERR;
+
+static LCEC_FAKEHAL_PIN_T *first_pin = NULL;
+static LCEC_FAKEHAL_PIN_T *last_pin = NULL;
+static LCEC_FAKEHAL_PIN_T *pin_hash[1 << LCEC_FAKEHAL_HASH_BITS];
+static LCEC_FAKEHAL_FUNCT_T *first_funct = NULL;
+static LCEC_FAKEHAL_SHMEM_T shmem[LCEC_FAKEHAL_SHMEM_MAX];
+static LCEC_FAKEHAL_MEM_T *first_mem = NULL;
+static int next_comp_id = 1;
+static long long fake_time = 0;
+static int fake_time_valid = 0;
+
+static unsigned int lcec_fakehal_hash(const char *name) {
+  uint32_t h = 2166136261u;
+
+  // FNV-1a
+  for (; *name != 0; name++) {
+    h = (h ^ (uint8_t) *name) * 16777619u;
+  }
+  return h & ((1 << LCEC_FAKEHAL_HASH_BITS) - 1);
+}
+
+static int lcec_fakehal_add_pin(const char *name, hal_type_t type, int dir, int is_param, volatile void *data) {
+  LCEC_FAKEHAL_PIN_T *pin;
+
+  if (lcec_fakehal_find_pin(name) != NULL) {
+    fprintf(stderr, "fakehal: duplicate pin/param %s\n", name);
+    return -EINVAL;
+  }
+
+  pin = calloc(1, sizeof(LCEC_FAKEHAL_PIN_T));
+  if (pin == NULL) {
+    return -ENOMEM;
+  }
+  strncpy(pin->name, name, HAL_NAME_LEN);
+  pin->type = type;
+  pin->dir = dir;
+  pin->is_param = is_param;
+  pin->data = data;
+  pin->hash_next = pin_hash[lcec_fakehal_hash(pin->name)];
+  pin_hash[lcec_fakehal_hash(pin->name)] = pin;
+
+  if (last_pin != NULL) {
+    last_pin->next = pin;
+  } else {
+    first_pin = pin;
+  }
+  last_pin = pin;
+
+  return 0;
+}
+
+LCEC_FAKEHAL_PIN_T *lcec_fakehal_first_pin(void) {
+  return first_pin;
+}
+
+LCEC_FAKEHAL_PIN_T *lcec_fakehal_find_pin(const char *name) {
+  LCEC_FAKEHAL_PIN_T *pin;
+
+  for (pin = pin_hash[lcec_fakehal_hash(name)]; pin != NULL; pin = pin->hash_next) {
+    if (strcmp(pin->name, name) == 0) {
+      return pin;
+    }
+  }
+
+  return NULL;
+}
+
+LCEC_FAKEHAL_FUNCT_T *lcec_fakehal_find_funct(const char *name) {
+  LCEC_FAKEHAL_FUNCT_T *funct;
+
+  for (funct = first_funct; funct != NULL; funct = funct->next) {
+    if (strcmp(funct->name, name) == 0) {
+      return funct;
+    }
+  }
+
+  return NULL;
+}
+
+void lcec_fakehal_reset(void) {
+  LCEC_FAKEHAL_PIN_T *pin, *next_pin;
+  LCEC_FAKEHAL_FUNCT_T *funct, *next_funct;
+  LCEC_FAKEHAL_MEM_T *mem, *next_mem;
+
+  for (pin = first_pin; pin != NULL; pin = next_pin) {
+    next_pin = pin->next;
+    if (!pin->is_param) {
+      free((void *) pin->data);
+    }
+    free(pin);
+  }
+  first_pin = NULL;
+  last_pin = NULL;
+  memset(pin_hash, 0, sizeof(pin_hash));
+
+  for (funct = first_funct; funct != NULL; funct = next_funct) {
+    next_funct = funct->next;
+    free(funct);
+  }
+  first_funct = NULL;
+
+  for (mem = first_mem; mem != NULL; mem = next_mem) {
+    next_mem = mem->next;
+    free(mem);
+  }
+  first_mem = NULL;
+}
+
+int hal_init(const char *name) {
+  return next_comp_id++;
+}
+
+int hal_exit(int comp_id) {
+  return 0;
+}
+
+int hal_ready(int comp_id) {
+  return 0;
+}
+
+void *hal_malloc(long int size) {
+  LCEC_FAKEHAL_MEM_T *mem;
+
+  // keep track of blocks for lcec_fakehal_reset()
+  mem = calloc(1, sizeof(LCEC_FAKEHAL_MEM_T) + size);
+  if (mem == NULL) {
+    return NULL;
+  }
+  mem->next = first_mem;
+  first_mem = mem;
+
+  return mem + 1;
+}
+
+int hal_pin_new(const char *name, hal_type_t type, hal_pin_dir_t dir, void **data_ptr_addr, int comp_id) {
+  void *data;
+  int err;
+
+  // every pin gets its own storage, as if it was unconnected
+  data = calloc(1, sizeof(hal_u64_t));
+  if (data == NULL) {
+    return -ENOMEM;
+  }
+
+  err = lcec_fakehal_add_pin(name, type, dir, 0, data);
+  if (err) {
+    free(data);
+    return err;
+  }
+
+  *data_ptr_addr = data;
+  return 0;
+}
+
+int hal_param_new(const char *name, hal_type_t type, hal_param_dir_t dir, volatile void *data_addr, int comp_id) {
+  return lcec_fakehal_add_pin(name, type, dir, 1, data_addr);
+}
+
+int hal_export_funct(const char *name, void (*funct) (void *, long), void *arg, int uses_fp, int reentrant, int comp_id) {
+  LCEC_FAKEHAL_FUNCT_T *f;
+
+  f = calloc(1, sizeof(LCEC_FAKEHAL_FUNCT_T));
+  if (f == NULL) {
+    return -ENOMEM;
+  }
+  strncpy(f->name, name, HAL_NAME_LEN);
+  f->funct = funct;
+  f->arg = arg;
+  f->next = first_funct;
+  first_funct = f;
+
+  return 0;
+}
+
+void rtapi_print_msg(msg_level_t level, const char *fmt, ...) {
+  va_list ap;
+
+  if (level > lcec_fakehal_msg_level) {
+    return;
+  }
+
+  va_start(ap, fmt);
+  vfprintf(stderr, fmt, ap);
+  va_end(ap);
+}
+
+int rtapi_snprintf(char *buf, unsigned long size, const char *fmt, ...) {
+  va_list ap;
+  int ret;
+
+  va_start(ap, fmt);
+  ret = vsnprintf(buf, size, fmt, ap);
+  va_end(ap);
+
+  return ret;
+}
+
+int rtapi_vsnprintf(char *buf, unsigned long size, const char *fmt, va_list ap) {
+  return vsnprintf(buf, size, fmt, ap);
+}
+
+void lcec_fakehal_set_time(long long time) {
+  fake_time = time;
+  fake_time_valid = 1;
+}
+
+long long rtapi_get_time(void) {
+  struct timespec ts;
+
+  if (fake_time_valid) {
+    return fake_time;
+  }
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+#ifdef RTAPI_TASK_PLL_SUPPORT
+long long rtapi_task_pll_get_reference(void) {
+  return rtapi_get_time();
+}
+
+int rtapi_task_pll_set_correction(long value) {
+  return 0;
+}
+#endif
+
+int rtapi_shmem_new(int key, int module_id, unsigned long size) {
+  LCEC_FAKEHAL_SHMEM_T *free_slot = NULL;
+  void *ptr;
+  int i;
+
+  for (i = 0; i < LCEC_FAKEHAL_SHMEM_MAX; i++) {
+    if (shmem[i].refs == 0) {
+      if (free_slot == NULL) {
+        free_slot = &shmem[i];
+      }
+      continue;
+    }
+    if (shmem[i].key != key) {
+      continue;
+    }
+
+    // existing segment, grow if needed
+    if (size > shmem[i].size) {
+      ptr = realloc(shmem[i].ptr, size);
+      if (ptr == NULL) {
+        return -ENOMEM;
+      }
+      memset(ptr + shmem[i].size, 0, size - shmem[i].size);
+      shmem[i].ptr = ptr;
+      shmem[i].size = size;
+    }
+    shmem[i].refs++;
+    return i;
+  }
+
+  if (free_slot == NULL) {
+    return -ENOMEM;
+  }
+  free_slot->ptr = calloc(1, size);
+  if (free_slot->ptr == NULL) {
+    return -ENOMEM;
+  }
+  free_slot->key = key;
+  free_slot->size = size;
+  free_slot->refs = 1;
+  return free_slot - shmem;
+}
+
+int rtapi_shmem_delete(int shmem_id, int module_id) {
+  if (shmem_id < 0 || shmem_id >= LCEC_FAKEHAL_SHMEM_MAX || shmem[shmem_id].refs == 0) {
+    return -EINVAL;
+  }
+
+  if (--(shmem[shmem_id].refs) == 0) {
+    free(shmem[shmem_id].ptr);
+    shmem[shmem_id].ptr = NULL;
+  }
+  return 0;
+}
+
+#if defined RTAPI_SERIAL && RTAPI_SERIAL >= 2
+int rtapi_shmem_getptr(int shmem_id, void **ptr, unsigned long *size) {
+#else
+int rtapi_shmem_getptr(int shmem_id, void **ptr) {
+#endif
+  if (shmem_id < 0 || shmem_id >= LCEC_FAKEHAL_SHMEM_MAX || shmem[shmem_id].refs == 0) {
+    return -EINVAL;
+  }
+
+  *ptr = shmem[shmem_id].ptr;
+#if defined RTAPI_SERIAL && RTAPI_SERIAL >= 2
+  if (size != NULL) {
+    *size = shmem[shmem_id].size;
+  }
+#endif
+  return 0;
+}
+
@@ -0,0 +1,60 @@
+//
+//    Copyright (C) 2026 Sascha Ittner <sascha.ittner@modusoft.de>
+//
+//    This program is free software; you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation; either version 2 of the License, or
+//    (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with this program; if not, write to the Free Software
+//    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301 USA
+//
+#ifndef _LCEC_FAKEHAL_H_
+#define _LCEC_FAKEHAL_H_
+
+//
+// Minimal in-process replacement for the HAL/RTAPI library used by the
+// user space test tools (bench, replay). Pins and params are backed by
+// plain memory, exported functions are only recorded, shared memory is
+// process local.
+//
+
+#include "hal.h"
+
+typedef struct lcec_fakehal_pin {
+  struct lcec_fakehal_pin *next;
+  struct lcec_fakehal_pin *hash_next;
+  char name[HAL_NAME_LEN + 1];
+  hal_type_t type;
+  int dir;
+  int is_param;
+  volatile void *data;
+} LCEC_FAKEHAL_PIN_T;
+
+typedef struct lcec_fakehal_funct {
+  struct lcec_fakehal_funct *next;
+  char name[HAL_NAME_LEN + 1];
+  void (*funct) (void *arg, long period);
+  void *arg;
+} LCEC_FAKEHAL_FUNCT_T;
+
+extern int lcec_fakehal_msg_level;
+
+LCEC_FAKEHAL_PIN_T *lcec_fakehal_first_pin(void);
+LCEC_FAKEHAL_PIN_T *lcec_fakehal_find_pin(const char *name);
+LCEC_FAKEHAL_FUNCT_T *lcec_fakehal_find_funct(const char *name);
+
+// drop all pins, functions and HAL memory (after the driver has exited)
+void lcec_fakehal_reset(void);
+
+// switch rtapi_get_time() to a virtual clock for reproducible runs
+void lcec_fakehal_set_time(long long time);
+
+#endif
+
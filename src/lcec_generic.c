@@ -18,283 +18,807 @@
 
 #include "lcec.h"
 #include "lcec_generic.h"
+#include "lcec_bitbank.h"
+
+// pin records are packed into one block, keep them 8 byte aligned
+#define LCEC_GENERIC_ALIGN(x) (((x) + 7) & ~((size_t) 7))
+
+// data access classes, pins are resolved to one of them
+// once the process data offsets are known
+enum {
+  lcecGenericAcc8 = 0,
+  lcecGenericAcc16,
+  lcecGenericAcc32,
+  lcecGenericAcc64,
+  lcecGenericAccField,
+  lcecGenericAccBits
+};
+
+typedef struct {
+  lcec_generic_proc_t read_s32;
+  lcec_generic_proc_t read_u32;
+  lcec_generic_proc_t read_float_s;
+  lcec_generic_proc_t read_float_u;
+  lcec_generic_proc_t write_s32;
+  lcec_generic_proc_t write_u32;
+  lcec_generic_proc_t write_float_s;
+  lcec_generic_proc_t write_float_u;
+} lcec_generic_procs_t;
+
+typedef struct {
+  lcec_generic_proc_t read_s64;
+  lcec_generic_proc_t read_u64;
+  lcec_generic_proc_t read_real;
+  lcec_generic_proc_t read_lreal;
+  lcec_generic_proc_t write_s64;
+  lcec_generic_proc_t write_u64;
+  lcec_generic_proc_t write_real;
+  lcec_generic_proc_t write_lreal;
+} lcec_generic_wide_procs_t;
 
 void lcec_generic_read(struct lcec_slave *slave, long period);
 void lcec_generic_write(struct lcec_slave *slave, long period);
 
-hal_s32_t lcec_generic_read_s32(uint8_t *pd, lcec_generic_pin_t *hal_data);
-hal_u32_t lcec_generic_read_u32(uint8_t *pd, lcec_generic_pin_t *hal_data);
-void lcec_generic_write_s32(uint8_t *pd, lcec_generic_pin_t *hal_data, hal_s32_t sval);
-void lcec_generic_write_u32(uint8_t *pd, lcec_generic_pin_t *hal_data, hal_u32_t uval);
+static void lcec_generic_prepare(struct lcec_slave *slave);
+
+static size_t lcec_generic_pin_size(lcec_generic_pin_conf_t *conf) {
+  int n;
+
+  if (conf->type == HAL_BIT && conf->bitLength != 1) {
+    n = (conf->bitLength < LCEC_CONF_GENERIC_MAX_SUBPINS) ? conf->bitLength : LCEC_CONF_GENERIC_MAX_SUBPINS;
+    return LCEC_GENERIC_ALIGN(sizeof(lcec_generic_bits_pin_t) + sizeof(void *) * n);
+  }
+
+  if (conf->type == HAL_FLOAT) {
+    return LCEC_GENERIC_ALIGN(sizeof(lcec_generic_float_pin_t));
+  }
+
+#ifndef LCEC_HAL_64BIT
+  if (conf->subType == lcecPdoEntTypeInt64) {
+    return LCEC_GENERIC_ALIGN(sizeof(lcec_generic_split_pin_t));
+  }
+#endif
+
+  return LCEC_GENERIC_ALIGN(sizeof(lcec_generic_pin_t));
+}
 
 int lcec_generic_init(int comp_id, struct lcec_slave *slave, ec_pdo_entry_reg_t *pdo_entry_regs) {
   lcec_master_t *master = slave->master;
-  lcec_generic_pin_t *hal_data = (lcec_generic_pin_t *) slave->hal_data;
-  int i, j;
+  lcec_generic_pin_conf_t *conf;
+  lcec_generic_data_t *hal_data;
+  lcec_generic_pin_t *pin, **read_list, **write_list;
+  lcec_generic_float_pin_t *float_pin;
+  lcec_generic_bits_pin_t *bits_pin;
+#ifndef LCEC_HAL_64BIT
+  lcec_generic_split_pin_t *split_pin;
+#endif
+  uint8_t *rec;
+  size_t size;
+  int i, j, read_max;
   int err;
 
   // initialize callbacks
   slave->proc_read = lcec_generic_read;
   slave->proc_write = lcec_generic_write;
 
+  // get size of pin lists and records
+  size = LCEC_GENERIC_ALIGN(sizeof(lcec_generic_data_t)) + LCEC_GENERIC_ALIGN(sizeof(lcec_generic_pin_t *) * slave->pdo_entry_count);
+  for (i=0, read_max=0, conf=slave->generic_pin_conf; i < slave->pdo_entry_count; i++, conf++) {
+    size += lcec_generic_pin_size(conf);
+    if (conf->dir == HAL_OUT) {
+      read_max++;
+    }
+  }
+
+  // alloc hal memory
+  if ((hal_data = hal_malloc(size)) == NULL) {
+    rtapi_print_msg(RTAPI_MSG_ERR, LCEC_MSG_PFX "hal_malloc() for slave %s.%s failed\n", master->name, slave->name);
+    return -EIO;
+  }
+  memset(hal_data, 0, size);
+  slave->hal_data = hal_data;
+
+  // split pins by direction, inputs are read
+  // from the process data, outputs written to it
+  read_list = (lcec_generic_pin_t **) ((uint8_t *) hal_data + LCEC_GENERIC_ALIGN(sizeof(lcec_generic_data_t)));
+  write_list = read_list + read_max;
+  hal_data->read_pins = read_list;
+  hal_data->write_pins = write_list;
+  rec = (uint8_t *) read_list + LCEC_GENERIC_ALIGN(sizeof(lcec_generic_pin_t *) * slave->pdo_entry_count);
+
   // initialize pins
-  for (i=0; i < slave->pdo_entry_count; i++, hal_data++) {
+  for (i=0, conf=slave->generic_pin_conf; i < slave->pdo_entry_count; i++, conf++) {
+    pin = (lcec_generic_pin_t *) rec;
+    rec += lcec_generic_pin_size(conf);
+    pin->bitOffset = conf->bitOffset;
+    pin->bitLength = conf->bitLength;
+
     // PDO mapping
-    LCEC_PDO_INIT(pdo_entry_regs, slave->index, slave->vid, slave->pid, hal_data->pdo_idx, hal_data->pdo_sidx, &hal_data->pdo_os, &hal_data->pdo_bp);
+    LCEC_PDO_INIT(pdo_entry_regs, slave->index, slave->vid, slave->pid, conf->pdo_idx, conf->pdo_sidx, &pin->data_os, &pin->data_bp);
+
+    // add to list, pins that don't get exported
+    // keep type none and are dropped on first cycle
+    if (conf->dir == HAL_OUT) {
+      *(read_list++) = pin;
+    } else {
+      *(write_list++) = pin;
+    }
+
+    // 64 bit values and IEEE floats
+    if (conf->subType == lcecPdoEntTypeInt64 || conf->subType == lcecPdoEntTypeFloatIeee) {
+      // check data size
+      if (conf->bitLength > 64 || (conf->subType == lcecPdoEntTypeFloatIeee && conf->bitLength != 32 && conf->bitLength != 64)) {
+        rtapi_print_msg(RTAPI_MSG_WARN, LCEC_MSG_PFX "unable to export pin %s.%s.%s.%s: invalid process data bitlen!\n", LCEC_MODULE_NAME, master->name, slave->name, conf->name);
+        continue;
+      }
+
+      if (conf->subType == lcecPdoEntTypeFloatIeee) {
+        err = lcec_pin_newf(conf->type, conf->dir, &pin->pin, "%s.%s.%s.%s", LCEC_MODULE_NAME, master->name, slave->name, conf->name);
+        if (err != 0) {
+          return err;
+        }
+        float_pin = (lcec_generic_float_pin_t *) pin;
+        float_pin->floatScale = conf->floatScale;
+        float_pin->floatOffset = conf->floatOffset;
+        pin->type = lcecGenericTypeFloatIeee;
+      } else {
+#ifdef LCEC_HAL_64BIT
+        err = lcec_pin_newf(conf->type, conf->dir, &pin->pin, "%s.%s.%s.%s", LCEC_MODULE_NAME, master->name, slave->name, conf->name);
+        if (err != 0) {
+          return err;
+        }
+#else
+        split_pin = (lcec_generic_split_pin_t *) pin;
+        err = lcec_pin_newf(conf->type, conf->dir, &pin->pin, "%s.%s.%s.%s-hi", LCEC_MODULE_NAME, master->name, slave->name, conf->name);
+        if (err != 0) {
+          return err;
+        }
+        err = lcec_pin_newf(HAL_U32, conf->dir, &split_pin->lo, "%s.%s.%s.%s-lo", LCEC_MODULE_NAME, master->name, slave->name, conf->name);
+        if (err != 0) {
+          return err;
+        }
+#endif
+        pin->type = (conf->type == LCEC_HAL_S64) ? lcecGenericTypeS64 : lcecGenericTypeU64;
+      }
+      continue;
+    }
 
-    switch (hal_data->type) {
+    switch (conf->type) {
       case HAL_BIT:
-        if (hal_data->bitLength == 1) {
+        if (conf->bitLength == 1) {
           // single bit pin
-          err = lcec_pin_newf(hal_data->type, hal_data->dir, &hal_data->pin[0], "%s.%s.%s.%s", LCEC_MODULE_NAME, master->name, slave->name, hal_data->name);
+          err = lcec_pin_newf(conf->type, conf->dir, &pin->pin, "%s.%s.%s.%s", LCEC_MODULE_NAME, master->name, slave->name, conf->name);
           if (err != 0) {
             return err;
           }
+          pin->type = lcecGenericTypeBit;
         } else {
           // bit pin array
-          for (j=0; j < LCEC_CONF_GENERIC_MAX_SUBPINS && j < hal_data->bitLength; j++) {
-            err = lcec_pin_newf(hal_data->type, hal_data->dir, &hal_data->pin[j], "%s.%s.%s.%s-%d", LCEC_MODULE_NAME, master->name, slave->name, hal_data->name, j);
+          bits_pin = (lcec_generic_bits_pin_t *) pin;
+          for (j=0; j < LCEC_CONF_GENERIC_MAX_SUBPINS && j < conf->bitLength; j++) {
+            err = lcec_pin_newf(conf->type, conf->dir, &bits_pin->bits[j], "%s.%s.%s.%s-%d", LCEC_MODULE_NAME, master->name, slave->name, conf->name, j);
             if (err != 0) {
               return err;
             }
           }
+          pin->type = lcecGenericTypeBits;
+          pin->bitLength = j;
         }
         break;
 
       case HAL_S32:
       case HAL_U32:
         // check data size
-        if (hal_data->bitLength > 32) {
-          rtapi_print_msg(RTAPI_MSG_WARN, LCEC_MSG_PFX "unable to export pin %s.%s.%s.%s: invalid process data bitlen!\n", LCEC_MODULE_NAME, master->name, slave->name, hal_data->name);
+        if (conf->bitLength > 32) {
+          rtapi_print_msg(RTAPI_MSG_WARN, LCEC_MSG_PFX "unable to export pin %s.%s.%s.%s: invalid process data bitlen!\n", LCEC_MODULE_NAME, master->name, slave->name, conf->name);
           continue;
         }
 
         // export pin
-        err = lcec_pin_newf(hal_data->type, hal_data->dir, &hal_data->pin[0], "%s.%s.%s.%s", LCEC_MODULE_NAME, master->name, slave->name, hal_data->name);
+        err = lcec_pin_newf(conf->type, conf->dir, &pin->pin, "%s.%s.%s.%s", LCEC_MODULE_NAME, master->name, slave->name, conf->name);
         if (err != 0) {
           return err;
         }
+        pin->type = (conf->type == HAL_S32) ? lcecGenericTypeS32 : lcecGenericTypeU32;
         break;
 
       case HAL_FLOAT:
         // check data size
-        if (hal_data->bitLength > 32) {
-          rtapi_print_msg(RTAPI_MSG_WARN, LCEC_MSG_PFX "unable to export pin %s.%s.%s.%s: invalid process data bitlen!\n", LCEC_MODULE_NAME, master->name, slave->name, hal_data->name);
+        if (conf->bitLength > 32) {
+          rtapi_print_msg(RTAPI_MSG_WARN, LCEC_MSG_PFX "unable to export pin %s.%s.%s.%s: invalid process data bitlen!\n", LCEC_MODULE_NAME, master->name, slave->name, conf->name);
           continue;
         }
 
         // export pin
-        err = lcec_pin_newf(hal_data->type, hal_data->dir, &hal_data->pin[0], "%s.%s.%s.%s", LCEC_MODULE_NAME, master->name, slave->name, hal_data->name);
+        err = lcec_pin_newf(conf->type, conf->dir, &pin->pin, "%s.%s.%s.%s", LCEC_MODULE_NAME, master->name, slave->name, conf->name);
         if (err != 0) {
           return err;
         }
+        float_pin = (lcec_generic_float_pin_t *) pin;
+        float_pin->floatScale = conf->floatScale;
+        float_pin->floatOffset = conf->floatOffset;
+        pin->type = (conf->subType == lcecPdoEntTypeFloatUnsigned) ? lcecGenericTypeFloatUnsigned : lcecGenericTypeFloat;
         break;
 
       default:
-        rtapi_print_msg(RTAPI_MSG_WARN, LCEC_MSG_PFX "unsupported pin type %d!\n", hal_data->type);
+        rtapi_print_msg(RTAPI_MSG_WARN, LCEC_MSG_PFX "unsupported pin type %d!\n", conf->type);
+        continue;
     }
   }
 
+  hal_data->read_count = read_list - hal_data->read_pins;
+  hal_data->write_count = write_list - hal_data->write_pins;
+
   return 0;
 }
 
 void lcec_generic_read(struct lcec_slave *slave, long period) {
   lcec_master_t *master = slave->master;
-  lcec_generic_pin_t *hal_data = (lcec_generic_pin_t *) slave->hal_data;
+  lcec_generic_data_t *hal_data = (lcec_generic_data_t *) slave->hal_data;
   uint8_t *pd = master->process_data;
-  int i, j, offset;
-  hal_float_t fval;
+  lcec_generic_pin_t *pin;
+  int i;
+
+  // resolve accessors on first cycle
+  if (!hal_data->prepared) {
+    lcec_generic_prepare(slave);
+  }
 
   // read data
-  for (i=0; i < slave->pdo_entry_count; i++, hal_data++) {
-    // skip wrong direction and uninitialized pins
-    if (hal_data->dir != HAL_OUT || hal_data->pin[0] == NULL) {
-      continue;
-    }
+  for (i=0; i < hal_data->read_count; i++) {
+    pin = hal_data->read_pins[i];
+    pin->proc(pin, pd);
+  }
+}
 
-    switch (hal_data->type) {
-      case HAL_BIT:
-        offset = ((hal_data->pdo_os << 3) | (hal_data->pdo_bp & 0x07)) + hal_data->bitOffset;
-        for (j=0; j < LCEC_CONF_GENERIC_MAX_SUBPINS && hal_data->pin[j] != NULL; j++, offset++) {
-          *((hal_bit_t *) hal_data->pin[j]) = EC_READ_BIT(&pd[offset >> 3], offset & 0x07);
-        }
-        break;
+void lcec_generic_write(struct lcec_slave *slave, long period) {
+  lcec_master_t *master = slave->master;
+  lcec_generic_data_t *hal_data = (lcec_generic_data_t *) slave->hal_data;
+  uint8_t *pd = master->process_data;
+  lcec_generic_pin_t *pin;
+  int i;
 
-      case HAL_S32:
-        *((hal_s32_t *) hal_data->pin[0]) = lcec_generic_read_s32(pd, hal_data);
-        break;
+  // resolve accessors on first cycle
+  if (!hal_data->prepared) {
+    lcec_generic_prepare(slave);
+  }
 
-      case HAL_U32:
-        *((hal_u32_t *) hal_data->pin[0]) = lcec_generic_read_u32(pd, hal_data);
-        break;
+  // write data
+  for (i=0; i < hal_data->write_count; i++) {
+    pin = hal_data->write_pins[i];
+    pin->proc(pin, pd);
+  }
+}
 
-      case HAL_FLOAT:
-        if (hal_data->subType == lcecPdoEntTypeFloatUnsigned) {
-          fval = lcec_generic_read_u32(pd, hal_data);
-        } else {
-          fval = lcec_generic_read_s32(pd, hal_data);
-        }
+static inline hal_s32_t lcec_generic_clamp_s32(lcec_generic_pin_t *hal_data, hal_s32_t sval) {
+  hal_s32_t lim = ((1LL << hal_data->bitLength) >> 1) - 1LL;
+  if (sval > lim) sval = lim;
+  lim = ~lim;
+  if (sval < lim) sval = lim;
+  return sval;
+}
 
-        fval *= hal_data->floatScale;
-        fval += hal_data->floatOffset;
-        *((hal_float_t *) hal_data->pin[0]) = fval;
-        break;
+static inline hal_u32_t lcec_generic_clamp_u32(lcec_generic_pin_t *hal_data, hal_u32_t uval) {
+  hal_u32_t lim = (1LL << hal_data->bitLength) - 1LL;
+  if (uval > lim) uval = lim;
+  return uval;
+}
 
-      default:
-        continue;
-    }
-  }
+// byte aligned 8/16/32 bit data
+static inline hal_s32_t lcec_generic_get_s_8(lcec_generic_pin_t *hal_data, uint8_t *pd) {
+  return EC_READ_S8(&pd[hal_data->data_os]);
 }
 
-void lcec_generic_write(struct lcec_slave *slave, long period) {
-  lcec_master_t *master = slave->master;
-  lcec_generic_pin_t *hal_data = (lcec_generic_pin_t *) slave->hal_data;
-  uint8_t *pd = master->process_data;
-  int i, j, offset;
-  hal_float_t fval;
+static inline hal_u32_t lcec_generic_get_u_8(lcec_generic_pin_t *hal_data, uint8_t *pd) {
+  return EC_READ_U8(&pd[hal_data->data_os]);
+}
 
-  // write data
-  for (i=0; i<slave->pdo_entry_count; i++, hal_data++) {
-    // skip wrong direction and uninitialized pins
-    if (hal_data->dir != HAL_IN || hal_data->pin[0] == NULL) {
-      continue;
-    }
+static inline void lcec_generic_set_s_8(lcec_generic_pin_t *hal_data, uint8_t *pd, hal_s32_t sval) {
+  if (sval > 127) sval = 127;
+  if (sval < -128) sval = -128;
+  EC_WRITE_S8(&pd[hal_data->data_os], sval);
+}
 
-    switch (hal_data->type) {
-      case HAL_BIT:
-        offset = ((hal_data->pdo_os << 3) | (hal_data->pdo_bp & 0x07)) + hal_data->bitOffset;
-        for (j=0; j < LCEC_CONF_GENERIC_MAX_SUBPINS && hal_data->pin[j] != NULL; j++, offset++) {
-          EC_WRITE_BIT(&pd[offset >> 3], offset & 0x07, *((hal_bit_t *) hal_data->pin[j]));
-        }
-        break;
+static inline void lcec_generic_set_u_8(lcec_generic_pin_t *hal_data, uint8_t *pd, hal_u32_t uval) {
+  if (uval > 0xff) uval = 0xff;
+  EC_WRITE_U8(&pd[hal_data->data_os], uval);
+}
 
-      case HAL_S32:
-        lcec_generic_write_s32(pd, hal_data, *((hal_s32_t *) hal_data->pin[0]));
-        break;
+static inline hal_s32_t lcec_generic_get_s_16(lcec_generic_pin_t *hal_data, uint8_t *pd) {
+  return EC_READ_S16(&pd[hal_data->data_os]);
+}
 
-      case HAL_U32:
-        lcec_generic_write_u32(pd, hal_data, *((hal_u32_t *) hal_data->pin[0]));
-        break;
+static inline hal_u32_t lcec_generic_get_u_16(lcec_generic_pin_t *hal_data, uint8_t *pd) {
+  return EC_READ_U16(&pd[hal_data->data_os]);
+}
 
-      case HAL_FLOAT:
-        fval = *((hal_float_t *) hal_data->pin[0]);
-        fval += hal_data->floatOffset;
-        fval *= hal_data->floatScale;
+static inline void lcec_generic_set_s_16(lcec_generic_pin_t *hal_data, uint8_t *pd, hal_s32_t sval) {
+  if (sval > 32767) sval = 32767;
+  if (sval < -32768) sval = -32768;
+  EC_WRITE_S16(&pd[hal_data->data_os], sval);
+}
 
-        if (hal_data->subType == lcecPdoEntTypeFloatUnsigned) {
-          lcec_generic_write_u32(pd, hal_data, (hal_u32_t) fval);
-        } else {
-          lcec_generic_write_s32(pd, hal_data, (hal_s32_t) fval);
-        }
-        break;
+static inline void lcec_generic_set_u_16(lcec_generic_pin_t *hal_data, uint8_t *pd, hal_u32_t uval) {
+  if (uval > 0xffff) uval = 0xffff;
+  EC_WRITE_U16(&pd[hal_data->data_os], uval);
+}
 
-      default:
-        continue;
+static inline hal_s32_t lcec_generic_get_s_32(lcec_generic_pin_t *hal_data, uint8_t *pd) {
+  return EC_READ_S32(&pd[hal_data->data_os]);
+}
+
+static inline hal_u32_t lcec_generic_get_u_32(lcec_generic_pin_t *hal_data, uint8_t *pd) {
+  return EC_READ_U32(&pd[hal_data->data_os]);
+}
+
+static inline void lcec_generic_set_s_32(lcec_generic_pin_t *hal_data, uint8_t *pd, hal_s32_t sval) {
+  EC_WRITE_S32(&pd[hal_data->data_os], sval);
+}
+
+static inline void lcec_generic_set_u_32(lcec_generic_pin_t *hal_data, uint8_t *pd, hal_u32_t uval) {
+  EC_WRITE_U32(&pd[hal_data->data_os], uval);
+}
+
+// bit fields up to 32 bits: one unaligned 64 bit access, the field
+// is moved to the top of the word and shifted back to sign extend
+static inline hal_s32_t lcec_generic_get_s_field(lcec_generic_pin_t *hal_data, uint8_t *pd) {
+  return ((int64_t) (EC_READ_U64(&pd[hal_data->data_os]) << (64 - hal_data->data_bp - hal_data->bitLength))) >> (64 - hal_data->bitLength);
+}
+
+static inline uint64_t lcec_generic_get_raw_field(lcec_generic_pin_t *hal_data, uint8_t *pd) {
+  return (EC_READ_U64(&pd[hal_data->data_os]) << (64 - hal_data->data_bp - hal_data->bitLength)) >> (64 - hal_data->bitLength);
+}
+
+static inline hal_u32_t lcec_generic_get_u_field(lcec_generic_pin_t *hal_data, uint8_t *pd) {
+  return lcec_generic_get_raw_field(hal_data, pd);
+}
+
+static inline void lcec_generic_put_field(lcec_generic_pin_t *hal_data, uint8_t *pd, uint64_t val) {
+  uint8_t *p = &pd[hal_data->data_os];
+  uint64_t mask = (~0ULL >> (64 - hal_data->bitLength)) << hal_data->data_bp;
+
+  EC_WRITE_U64(p, (EC_READ_U64(p) & ~mask) | ((val << hal_data->data_bp) & mask));
+}
+
+static inline void lcec_generic_set_s_field(lcec_generic_pin_t *hal_data, uint8_t *pd, hal_s32_t sval) {
+  lcec_generic_put_field(hal_data, pd, (uint64_t) lcec_generic_clamp_s32(hal_data, sval));
+}
+
+static inline void lcec_generic_set_u_field(lcec_generic_pin_t *hal_data, uint8_t *pd, hal_u32_t uval) {
+  lcec_generic_put_field(hal_data, pd, lcec_generic_clamp_u32(hal_data, uval));
+}
+
+// bit by bit fallback for fields the 64 bit window can't cover
+static inline uint64_t lcec_generic_get_raw_bits(lcec_generic_pin_t *hal_data, uint8_t *pd) {
+  int i, offset;
+  uint64_t uval;
+
+  offset = (hal_data->data_os << 3) + hal_data->data_bp;
+  for (uval=0, i=0; i < hal_data->bitLength; i++, offset++) {
+    if (EC_READ_BIT(&pd[offset >> 3], offset & 0x07)) {
+      uval |= (1ULL << i);
     }
   }
+  return uval;
+}
+
+static inline hal_u32_t lcec_generic_get_u_bits(lcec_generic_pin_t *hal_data, uint8_t *pd) {
+  return lcec_generic_get_raw_bits(hal_data, pd);
 }
 
-hal_s32_t lcec_generic_read_s32(uint8_t *pd, lcec_generic_pin_t *hal_data) {
+static inline hal_s32_t lcec_generic_get_s_bits(lcec_generic_pin_t *hal_data, uint8_t *pd) {
+  hal_u32_t uval = lcec_generic_get_u_bits(hal_data, pd);
+
+  if (hal_data->bitLength < 32 && (uval & (1U << (hal_data->bitLength - 1)))) {
+    uval |= ~0U << hal_data->bitLength;
+  }
+  return uval;
+}
+
+static inline void lcec_generic_put_bits(lcec_generic_pin_t *hal_data, uint8_t *pd, uint64_t uval) {
   int i, offset;
-  hal_s32_t sval;
-
-  if (hal_data->pdo_bp == 0 && hal_data->bitOffset == 0) {
-    switch (hal_data->bitLength) {
-      case 8:
-        return EC_READ_S8(&pd[hal_data->pdo_os]);
-      case 16:
-        return EC_READ_S16(&pd[hal_data->pdo_os]);
-      case 32:
-        return EC_READ_S32(&pd[hal_data->pdo_os]);
-    }
+
+  offset = (hal_data->data_os << 3) + hal_data->data_bp;
+  for (i=0; i < hal_data->bitLength; i++, offset++) {
+    EC_WRITE_BIT(&pd[offset >> 3], offset & 0x07, uval & 1);
+    uval >>= 1;
   }
+}
 
-  offset = ((hal_data->pdo_os << 3) | (hal_data->pdo_bp & 0x07)) + hal_data->bitOffset;
-  for (sval=0, i=0; i < hal_data->bitLength; i++, offset++) {
-    if (EC_READ_BIT(&pd[offset >> 3], offset & 0x07)) {
-      sval |= (1 << i);
-    }
+static inline void lcec_generic_set_s_bits(lcec_generic_pin_t *hal_data, uint8_t *pd, hal_s32_t sval) {
+  lcec_generic_put_bits(hal_data, pd, lcec_generic_clamp_s32(hal_data, sval));
+}
+
+static inline void lcec_generic_set_u_bits(lcec_generic_pin_t *hal_data, uint8_t *pd, hal_u32_t uval) {
+  lcec_generic_put_bits(hal_data, pd, lcec_generic_clamp_u32(hal_data, uval));
+}
+
+#define LCEC_GENERIC_PROCS(acc) \
+static void lcec_generic_read_s32_##acc(lcec_generic_pin_t *hal_data, uint8_t *pd) { \
+  *((hal_s32_t *) hal_data->pin) = lcec_generic_get_s_##acc(hal_data, pd); \
+} \
+static void lcec_generic_read_u32_##acc(lcec_generic_pin_t *hal_data, uint8_t *pd) { \
+  *((hal_u32_t *) hal_data->pin) = lcec_generic_get_u_##acc(hal_data, pd); \
+} \
+static void lcec_generic_read_float_s_##acc(lcec_generic_pin_t *hal_data, uint8_t *pd) { \
+  hal_float_t fval = lcec_generic_get_s_##acc(hal_data, pd); \
+  fval *= ((lcec_generic_float_pin_t *) hal_data)->floatScale; \
+  fval += ((lcec_generic_float_pin_t *) hal_data)->floatOffset; \
+  *((hal_float_t *) hal_data->pin) = fval; \
+} \
+static void lcec_generic_read_float_u_##acc(lcec_generic_pin_t *hal_data, uint8_t *pd) { \
+  hal_float_t fval = lcec_generic_get_u_##acc(hal_data, pd); \
+  fval *= ((lcec_generic_float_pin_t *) hal_data)->floatScale; \
+  fval += ((lcec_generic_float_pin_t *) hal_data)->floatOffset; \
+  *((hal_float_t *) hal_data->pin) = fval; \
+} \
+static void lcec_generic_write_s32_##acc(lcec_generic_pin_t *hal_data, uint8_t *pd) { \
+  lcec_generic_set_s_##acc(hal_data, pd, *((hal_s32_t *) hal_data->pin)); \
+} \
+static void lcec_generic_write_u32_##acc(lcec_generic_pin_t *hal_data, uint8_t *pd) { \
+  lcec_generic_set_u_##acc(hal_data, pd, *((hal_u32_t *) hal_data->pin)); \
+} \
+static void lcec_generic_write_float_s_##acc(lcec_generic_pin_t *hal_data, uint8_t *pd) { \
+  hal_float_t fval = *((hal_float_t *) hal_data->pin); \
+  fval += ((lcec_generic_float_pin_t *) hal_data)->floatOffset; \
+  fval *= ((lcec_generic_float_pin_t *) hal_data)->floatScale; \
+  lcec_generic_set_s_##acc(hal_data, pd, (hal_s32_t) fval); \
+} \
+static void lcec_generic_write_float_u_##acc(lcec_generic_pin_t *hal_data, uint8_t *pd) { \
+  hal_float_t fval = *((hal_float_t *) hal_data->pin); \
+  fval += ((lcec_generic_float_pin_t *) hal_data)->floatOffset; \
+  fval *= ((lcec_generic_float_pin_t *) hal_data)->floatScale; \
+  lcec_generic_set_u_##acc(hal_data, pd, (hal_u32_t) fval); \
+}
+
+#define LCEC_GENERIC_PROCS_ENTRY(acc) { \
+  lcec_generic_read_s32_##acc, lcec_generic_read_u32_##acc, \
+  lcec_generic_read_float_s_##acc, lcec_generic_read_float_u_##acc, \
+  lcec_generic_write_s32_##acc, lcec_generic_write_u32_##acc, \
+  lcec_generic_write_float_s_##acc, lcec_generic_write_float_u_##acc }
+
+LCEC_GENERIC_PROCS(8)
+LCEC_GENERIC_PROCS(16)
+LCEC_GENERIC_PROCS(32)
+LCEC_GENERIC_PROCS(field)
+LCEC_GENERIC_PROCS(bits)
+
+static const lcec_generic_procs_t lcec_generic_procs[] = {
+  [lcecGenericAcc8] = LCEC_GENERIC_PROCS_ENTRY(8),
+  [lcecGenericAcc16] = LCEC_GENERIC_PROCS_ENTRY(16),
+  [lcecGenericAcc32] = LCEC_GENERIC_PROCS_ENTRY(32),
+  [lcecGenericAccField] = LCEC_GENERIC_PROCS_ENTRY(field),
+  [lcecGenericAccBits] = LCEC_GENERIC_PROCS_ENTRY(bits)
+};
+
+// 64 bit values and IEEE floats, raw access to the byte
+// aligned 32/64 bit data, the 64 bit window or bit by bit
+static inline uint64_t lcec_generic_get_raw_32(lcec_generic_pin_t *hal_data, uint8_t *pd) {
+  return EC_READ_U32(&pd[hal_data->data_os]);
+}
+
+static inline void lcec_generic_put_raw_32(lcec_generic_pin_t *hal_data, uint8_t *pd, uint64_t val) {
+  EC_WRITE_U32(&pd[hal_data->data_os], val);
+}
+
+static inline uint64_t lcec_generic_get_raw_64(lcec_generic_pin_t *hal_data, uint8_t *pd) {
+  return EC_READ_U64(&pd[hal_data->data_os]);
+}
+
+static inline void lcec_generic_put_raw_64(lcec_generic_pin_t *hal_data, uint8_t *pd, uint64_t val) {
+  EC_WRITE_U64(&pd[hal_data->data_os], val);
+}
+
+#define lcec_generic_put_raw_field lcec_generic_put_field
+#define lcec_generic_put_raw_bits lcec_generic_put_bits
+
+static inline int64_t lcec_generic_sign_extend(lcec_generic_pin_t *hal_data, uint64_t val) {
+  if (hal_data->bitLength < 64) {
+    return ((int64_t) (val << (64 - hal_data->bitLength))) >> (64 - hal_data->bitLength);
+  }
+  return val;
+}
+
+static inline uint64_t lcec_generic_clamp_s64(lcec_generic_pin_t *hal_data, int64_t sval) {
+  int64_t lim;
+
+  if (hal_data->bitLength < 64) {
+    lim = (1LL << (hal_data->bitLength - 1)) - 1LL;
+    if (sval > lim) sval = lim;
+    lim = ~lim;
+    if (sval < lim) sval = lim;
   }
   return sval;
 }
 
-hal_u32_t lcec_generic_read_u32(uint8_t *pd, lcec_generic_pin_t *hal_data) {
-  int i, offset;
-  hal_u32_t uval;
-
-  if (hal_data->pdo_bp == 0 && hal_data->bitOffset == 0) {
-    switch (hal_data->bitLength) {
-      case 8:
-        return EC_READ_U8(&pd[hal_data->pdo_os]);
-      case 16:
-        return EC_READ_U16(&pd[hal_data->pdo_os]);
-      case 32:
-        return EC_READ_U32(&pd[hal_data->pdo_os]);
-    }
+static inline uint64_t lcec_generic_clamp_u64(lcec_generic_pin_t *hal_data, uint64_t uval) {
+  uint64_t lim;
+
+  if (hal_data->bitLength < 64) {
+    lim = (1ULL << hal_data->bitLength) - 1ULL;
+    if (uval > lim) uval = lim;
   }
+  return uval;
+}
 
-  offset = ((hal_data->pdo_os << 3) | (hal_data->pdo_bp & 0x07)) + hal_data->bitOffset;
-  for (uval=0, i=0; i < hal_data->bitLength; i++, offset++) {
-    if (EC_READ_BIT(&pd[offset >> 3], offset & 0x07)) {
-      uval |= (1 << i);
+// the process data is little endian, EC_READ_U32/U64 already
+// deliver the IEEE bit pattern in host order
+static inline hal_float_t lcec_generic_real(uint64_t val) {
+  union { uint32_t u; float f; } v;
+  v.u = val;
+  return v.f;
+}
+
+static inline uint64_t lcec_generic_real_raw(hal_float_t fval) {
+  union { uint32_t u; float f; } v;
+  v.f = fval;
+  return v.u;
+}
+
+static inline hal_float_t lcec_generic_lreal(uint64_t val) {
+  union { uint64_t u; double f; } v;
+  v.u = val;
+  return v.f;
+}
+
+static inline uint64_t lcec_generic_lreal_raw(hal_float_t fval) {
+  union { uint64_t u; double f; } v;
+  v.f = fval;
+  return v.u;
+}
+
+static inline void lcec_generic_set_pin_s64(lcec_generic_pin_t *hal_data, int64_t sval) {
+#ifdef LCEC_HAL_64BIT
+  *((hal_s64_t *) hal_data->pin) = sval;
+#else
+  *((hal_s32_t *) hal_data->pin) = (uint64_t) sval >> 32;
+  *((hal_u32_t *) ((lcec_generic_split_pin_t *) hal_data)->lo) = sval;
+#endif
+}
+
+static inline void lcec_generic_set_pin_u64(lcec_generic_pin_t *hal_data, uint64_t uval) {
+#ifdef LCEC_HAL_64BIT
+  *((hal_u64_t *) hal_data->pin) = uval;
+#else
+  *((hal_u32_t *) hal_data->pin) = uval >> 32;
+  *((hal_u32_t *) ((lcec_generic_split_pin_t *) hal_data)->lo) = uval;
+#endif
+}
+
+static inline uint64_t lcec_generic_get_pin_64(lcec_generic_pin_t *hal_data) {
+#ifdef LCEC_HAL_64BIT
+  return *((hal_u64_t *) hal_data->pin);
+#else
+  return ((uint64_t) *((hal_u32_t *) hal_data->pin) << 32) | *((hal_u32_t *) ((lcec_generic_split_pin_t *) hal_data)->lo);
+#endif
+}
+
+#define LCEC_GENERIC_WIDE_PROCS(acc) \
+static void lcec_generic_read_s64_##acc(lcec_generic_pin_t *hal_data, uint8_t *pd) { \
+  lcec_generic_set_pin_s64(hal_data, lcec_generic_sign_extend(hal_data, lcec_generic_get_raw_##acc(hal_data, pd))); \
+} \
+static void lcec_generic_read_u64_##acc(lcec_generic_pin_t *hal_data, uint8_t *pd) { \
+  lcec_generic_set_pin_u64(hal_data, lcec_generic_get_raw_##acc(hal_data, pd)); \
+} \
+static void lcec_generic_read_real_##acc(lcec_generic_pin_t *hal_data, uint8_t *pd) { \
+  hal_float_t fval = lcec_generic_real(lcec_generic_get_raw_##acc(hal_data, pd)); \
+  fval *= ((lcec_generic_float_pin_t *) hal_data)->floatScale; \
+  fval += ((lcec_generic_float_pin_t *) hal_data)->floatOffset; \
+  *((hal_float_t *) hal_data->pin) = fval; \
+} \
+static void lcec_generic_read_lreal_##acc(lcec_generic_pin_t *hal_data, uint8_t *pd) { \
+  hal_float_t fval = lcec_generic_lreal(lcec_generic_get_raw_##acc(hal_data, pd)); \
+  fval *= ((lcec_generic_float_pin_t *) hal_data)->floatScale; \
+  fval += ((lcec_generic_float_pin_t *) hal_data)->floatOffset; \
+  *((hal_float_t *) hal_data->pin) = fval; \
+} \
+static void lcec_generic_write_s64_##acc(lcec_generic_pin_t *hal_data, uint8_t *pd) { \
+  lcec_generic_put_raw_##acc(hal_data, pd, lcec_generic_clamp_s64(hal_data, lcec_generic_get_pin_64(hal_data))); \
+} \
+static void lcec_generic_write_u64_##acc(lcec_generic_pin_t *hal_data, uint8_t *pd) { \
+  lcec_generic_put_raw_##acc(hal_data, pd, lcec_generic_clamp_u64(hal_data, lcec_generic_get_pin_64(hal_data))); \
+} \
+static void lcec_generic_write_real_##acc(lcec_generic_pin_t *hal_data, uint8_t *pd) { \
+  hal_float_t fval = *((hal_float_t *) hal_data->pin); \
+  fval += ((lcec_generic_float_pin_t *) hal_data)->floatOffset; \
+  fval *= ((lcec_generic_float_pin_t *) hal_data)->floatScale; \
+  lcec_generic_put_raw_##acc(hal_data, pd, lcec_generic_real_raw(fval)); \
+} \
+static void lcec_generic_write_lreal_##acc(lcec_generic_pin_t *hal_data, uint8_t *pd) { \
+  hal_float_t fval = *((hal_float_t *) hal_data->pin); \
+  fval += ((lcec_generic_float_pin_t *) hal_data)->floatOffset; \
+  fval *= ((lcec_generic_float_pin_t *) hal_data)->floatScale; \
+  lcec_generic_put_raw_##acc(hal_data, pd, lcec_generic_lreal_raw(fval)); \
+}
+
+#define LCEC_GENERIC_WIDE_PROCS_ENTRY(acc) { \
+  lcec_generic_read_s64_##acc, lcec_generic_read_u64_##acc, \
+  lcec_generic_read_real_##acc, lcec_generic_read_lreal_##acc, \
+  lcec_generic_write_s64_##acc, lcec_generic_write_u64_##acc, \
+  lcec_generic_write_real_##acc, lcec_generic_write_lreal_##acc }
+
+LCEC_GENERIC_WIDE_PROCS(32)
+LCEC_GENERIC_WIDE_PROCS(64)
+LCEC_GENERIC_WIDE_PROCS(field)
+LCEC_GENERIC_WIDE_PROCS(bits)
+
+static const lcec_generic_wide_procs_t lcec_generic_wide_procs[] = {
+  [lcecGenericAcc32] = LCEC_GENERIC_WIDE_PROCS_ENTRY(32),
+  [lcecGenericAcc64] = LCEC_GENERIC_WIDE_PROCS_ENTRY(64),
+  [lcecGenericAccField] = LCEC_GENERIC_WIDE_PROCS_ENTRY(field),
+  [lcecGenericAccBits] = LCEC_GENERIC_WIDE_PROCS_ENTRY(bits)
+};
+
+static void lcec_generic_read_bit(lcec_generic_pin_t *hal_data, uint8_t *pd) {
+  *((hal_bit_t *) hal_data->pin) = EC_READ_BIT(&pd[hal_data->data_os], hal_data->data_bp);
+}
+
+static void lcec_generic_write_bit(lcec_generic_pin_t *hal_data, uint8_t *pd) {
+  EC_WRITE_BIT(&pd[hal_data->data_os], hal_data->data_bp, *((hal_bit_t *) hal_data->pin));
+}
+
+static void lcec_generic_read_bits(lcec_generic_pin_t *hal_data, uint8_t *pd) {
+  lcec_generic_bits_pin_t *bits_pin = (lcec_generic_bits_pin_t *) hal_data;
+  uint32_t val;
+  int j;
+
+  val = lcec_bitbank_load(pd, hal_data->data_os, hal_data->data_bp, hal_data->bitLength);
+  for (j=0; j < hal_data->bitLength; j++, val >>= 1) {
+    *((hal_bit_t *) bits_pin->bits[j]) = val & 1;
+  }
+}
+
+static void lcec_generic_write_bits(lcec_generic_pin_t *hal_data, uint8_t *pd) {
+  lcec_generic_bits_pin_t *bits_pin = (lcec_generic_bits_pin_t *) hal_data;
+  uint32_t val;
+  int j;
+
+  for (j=0, val=0; j < hal_data->bitLength; j++) {
+    if (*((hal_bit_t *) bits_pin->bits[j])) {
+      val |= (1U << j);
     }
   }
-  return uval;
+  lcec_bitbank_store(pd, hal_data->data_os, hal_data->data_bp, hal_data->bitLength, val);
 }
 
-void lcec_generic_write_s32(uint8_t *pd, lcec_generic_pin_t *hal_data, hal_s32_t sval) {
-  int i, offset;
+// process data bit offset of a prepared pin
+static inline unsigned int lcec_generic_bit_offset(lcec_generic_pin_t *pin) {
+  return (pin->data_os << 3) + pin->data_bp;
+}
 
-  hal_s32_t lim = ((1LL << hal_data->bitLength) >> 1) - 1LL; 
-  if (sval > lim) sval = lim;
-  lim = ~lim;
-  if (sval < lim) sval = lim;
+static void lcec_generic_prepare_pin(lcec_master_t *master, lcec_generic_pin_t *pin, int out) {
+  const lcec_generic_procs_t *procs;
+  const lcec_generic_wide_procs_t *wide_procs;
+  unsigned int offset, os;
+  int acc, wide;
+
+  pin->proc = NULL;
+
+  // data_os/data_bp hold the registered pdo entry position until here
+  offset = ((pin->data_os << 3) | (pin->data_bp & 0x07)) + pin->bitOffset;
+  pin->data_os = offset >> 3;
+  pin->data_bp = offset & 0x07;
+
+  if (pin->bitLength == 0) {
+    return;
+  }
+
+  if (pin->type == lcecGenericTypeBit) {
+    pin->proc = out ? lcec_generic_read_bit : lcec_generic_write_bit;
+    return;
+  }
 
-  if (hal_data->pdo_bp == 0 && hal_data->bitOffset == 0) {
-    switch (hal_data->bitLength) {
-      case 8:
-        EC_WRITE_S8(&pd[hal_data->pdo_os], sval);
-        return;
-      case 16:
-        EC_WRITE_S16(&pd[hal_data->pdo_os], sval);
-        return;
-      case 32:
-        EC_WRITE_S32(&pd[hal_data->pdo_os], sval);
-        return;
+  if (pin->type == lcecGenericTypeBits) {
+    pin->proc = out ? lcec_generic_read_bits : lcec_generic_write_bits;
+    return;
+  }
+
+  // select access class, 64 bit values and
+  // IEEE floats have no 8/16 bit accessors
+  wide = (pin->type == lcecGenericTypeS64 || pin->type == lcecGenericTypeU64 || pin->type == lcecGenericTypeFloatIeee);
+  if (pin->data_bp == 0 && pin->bitLength == 8 && !wide) {
+    acc = lcecGenericAcc8;
+  } else if (pin->data_bp == 0 && pin->bitLength == 16 && !wide) {
+    acc = lcecGenericAcc16;
+  } else if (pin->data_bp == 0 && pin->bitLength == 32) {
+    acc = lcecGenericAcc32;
+  } else if (pin->data_bp == 0 && pin->bitLength == 64 && wide) {
+    acc = lcecGenericAcc64;
+  } else {
+    // the 64 bit window must stay inside the process data,
+    // so move it back for fields near the end
+    acc = lcecGenericAccBits;
+    if (master->process_data_len >= 8) {
+      os = pin->data_os;
+      if (os > (unsigned int) (master->process_data_len - 8)) {
+        os = master->process_data_len - 8;
+      }
+      if (offset - (os << 3) + pin->bitLength <= 64) {
+        pin->data_os = os;
+        pin->data_bp = offset - (os << 3);
+        acc = lcecGenericAccField;
+      }
     }
   }
 
-  offset = ((hal_data->pdo_os << 3) | (hal_data->pdo_bp & 0x07)) + hal_data->bitOffset;
-  for (i=0; i < hal_data->bitLength; i++, offset++) {
-    EC_WRITE_BIT(&pd[offset >> 3], offset & 0x07, sval & 1);
-    sval >>= 1;
+  if (wide) {
+    wide_procs = &lcec_generic_wide_procs[acc];
+    switch (pin->type) {
+      case lcecGenericTypeS64:
+        pin->proc = out ? wide_procs->read_s64 : wide_procs->write_s64;
+        break;
+
+      case lcecGenericTypeU64:
+        pin->proc = out ? wide_procs->read_u64 : wide_procs->write_u64;
+        break;
+
+      default:
+        if (pin->bitLength == 32) {
+          pin->proc = out ? wide_procs->read_real : wide_procs->write_real;
+        } else {
+          pin->proc = out ? wide_procs->read_lreal : wide_procs->write_lreal;
+        }
+        break;
+    }
+    return;
   }
-}
 
-void lcec_generic_write_u32(uint8_t *pd, lcec_generic_pin_t *hal_data, hal_u32_t uval) {
-  int i, offset;
+  procs = &lcec_generic_procs[acc];
+  switch (pin->type) {
+    case lcecGenericTypeS32:
+      pin->proc = out ? procs->read_s32 : procs->write_s32;
+      break;
 
-  hal_u32_t lim = (1LL << hal_data->bitLength) - 1LL; 
-  if (uval > lim) uval = lim;
+    case lcecGenericTypeU32:
+      pin->proc = out ? procs->read_u32 : procs->write_u32;
+      break;
+
+    case lcecGenericTypeFloat:
+      pin->proc = out ? procs->read_float_s : procs->write_float_s;
+      break;
 
-  if (hal_data->pdo_bp == 0 && hal_data->bitOffset == 0) {
-    switch (hal_data->bitLength) {
-      case 8:
-        EC_WRITE_U8(&pd[hal_data->pdo_os], uval);
-        return;
-      case 16:
-        EC_WRITE_U16(&pd[hal_data->pdo_os], uval);
-        return;
-      case 32:
-        EC_WRITE_U32(&pd[hal_data->pdo_os], uval);
-        return;
+    case lcecGenericTypeFloatUnsigned:
+      pin->proc = out ? procs->read_float_u : procs->write_float_u;
+      break;
+
+    default:
+      break;
+  }
+}
+
+static int lcec_generic_prepare_list(lcec_master_t *master, lcec_generic_pin_t **list, int count, int out) {
+  lcec_generic_pin_t *pin;
+  unsigned int offset;
+  int i, j, n;
+
+  // resolve accessors, drop pins without one
+  for (i=0, n=0; i < count; i++) {
+    pin = list[i];
+    lcec_generic_prepare_pin(master, pin, out);
+    if (pin->proc != NULL) {
+      list[n++] = pin;
     }
   }
 
-  offset = ((hal_data->pdo_os << 3) | (hal_data->pdo_bp & 0x07)) + hal_data->bitOffset;
-  for (i=0; i < hal_data->bitLength; i++, offset++) {
-    EC_WRITE_BIT(&pd[offset >> 3], offset & 0x07, uval & 1);
-    uval >>= 1;
+  // sort by process data offset, lists are
+  // short and mostly ordered already
+  for (i=1; i < n; i++) {
+    pin = list[i];
+    offset = lcec_generic_bit_offset(pin);
+    for (j=i; j > 0 && lcec_generic_bit_offset(list[j - 1]) > offset; j--) {
+      list[j] = list[j - 1];
+    }
+    list[j] = pin;
   }
+
+  return n;
 }
 
+static void lcec_generic_prepare(struct lcec_slave *slave) {
+  lcec_master_t *master = slave->master;
+  lcec_generic_data_t *hal_data = (lcec_generic_data_t *) slave->hal_data;
+
+  hal_data->read_count = lcec_generic_prepare_list(master, hal_data->read_pins, hal_data->read_count, 1);
+  hal_data->write_count = lcec_generic_prepare_list(master, hal_data->write_pins, hal_data->write_count, 0);
+  hal_data->prepared = 1;
+}
@@ -21,8 +21,27 @@
 #include "lcec.h"
 #include "lcec_conf.h"
 
-typedef struct {
-  char name[LCEC_CONF_STR_MAXLEN];
+struct lcec_generic_pin;
+
+typedef void (*lcec_generic_proc_t) (struct lcec_generic_pin *hal_data, uint8_t *pd);
+
+// pin record types
+enum {
+  lcecGenericTypeNone = 0,
+  lcecGenericTypeBit,
+  lcecGenericTypeBits,
+  lcecGenericTypeS32,
+  lcecGenericTypeU32,
+  lcecGenericTypeFloat,
+  lcecGenericTypeFloatUnsigned,
+  lcecGenericTypeS64,
+  lcecGenericTypeU64,
+  lcecGenericTypeFloatIeee
+};
+
+// pin description from the config, only used on init
+typedef struct lcec_generic_pin_conf {
+  const char *name;
   hal_type_t type;
   LCEC_PDOENT_TYPE_T subType;
   hal_float_t floatScale;
@@ -30,13 +49,50 @@ typedef struct {
   uint8_t bitOffset;
   uint8_t bitLength;
   hal_pin_dir_t dir;
-  void *pin[LCEC_CONF_GENERIC_MAX_SUBPINS];
   uint16_t pdo_idx;
   uint8_t pdo_sidx;
-  unsigned int pdo_os;
-  unsigned int pdo_bp;
+} lcec_generic_pin_conf_t;
+
+// pin record used by the cyclic functions
+typedef struct lcec_generic_pin {
+  lcec_generic_proc_t proc;
+  void *pin;
+  unsigned int data_os;
+  unsigned int data_bp;
+  uint8_t bitOffset;
+  uint8_t bitLength;
+  uint8_t type;
 } lcec_generic_pin_t;
 
+// float pins extend the record by scale and offset
+typedef struct {
+  lcec_generic_pin_t pin;
+  hal_float_t floatScale;
+  hal_float_t floatOffset;
+} lcec_generic_float_pin_t;
+
+// bit array pins extend the record by one
+// pin per bit, bitLength is the pin count
+typedef struct {
+  lcec_generic_pin_t pin;
+  void *bits[];
+} lcec_generic_bits_pin_t;
+
+// 64 bit pins without 64 bit hal support, the
+// record's pin gets the upper, lo the lower 32 bits
+typedef struct {
+  lcec_generic_pin_t pin;
+  void *lo;
+} lcec_generic_split_pin_t;
+
+typedef struct {
+  int prepared;
+  int read_count;
+  int write_count;
+  lcec_generic_pin_t **read_pins;
+  lcec_generic_pin_t **write_pins;
+} lcec_generic_data_t;
+
 int lcec_generic_init(int comp_id, struct lcec_slave *slave, ec_pdo_entry_reg_t *pdo_entry_regs);
 
 #endif
@@ -0,0 +1,464 @@
+//
+//    Copyright (C) 2026 Sascha Ittner <sascha.ittner@modusoft.de>
+//
+//    This program is free software; you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation; either version 2 of the License, or
+//    (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with this program; if not, write to the Free Software
+//    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301 USA
+//
+
+//
+// Cycle latency and jitter benchmark
+//
+// Builds synthetic buses of mixed slaves (EL1809, EL2809, EL7342 and a
+// generic CiA402 drive with 30 PDO entries, in that order), runs the
+// complete startup path (XML parsing, driver init, activation) on the
+// simulated master and then calls lcec.read-all and lcec.write-all from
+// a SCHED_FIFO thread at the given period. -S sets slaveStatesPerCycle
+// of the master (0 keeps the default). -S with the bus size polls all
+// slave states in every cycle, which is the worst case cycle of the
+// old once per second poll.
+//
+// One CSV row is printed per bus size:
+//   parse_us, init_us    lcec_conf parser and rtapi_app_main() time
+//   op_cycles, op_ms     cycles and time until all slaves are in OP
+//   exit_us              rtapi_app_exit() time
+//   cycle_*              read-all + write-all execution time
+//   jitter_*             wakeup delay against the absolute deadline
+//   overruns             cycles that ended after the next deadline
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+#include <time.h>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/mman.h>
+
+#include "lcec.h"
+#include "lcec_conf_priv.h"
+#include "lcec_sim.h"
+#include "lcec_fakehal.h"
+
+#define LCEC_LATENCY_PERIOD   1000000
+#define LCEC_LATENCY_CYCLES   10000
+#define LCEC_LATENCY_WARMUP   10000
+#define LCEC_LATENCY_PRIO     80
+#define LCEC_LATENCY_MAX_RUNS 16
+
+#define LCEC_LATENCY_DRIVE_VID 0x00000999
+#define LCEC_LATENCY_DRIVE_PID 0x00000001
+
+typedef struct {
+  LCEC_FAKEHAL_FUNCT_T *read_funct;
+  LCEC_FAKEHAL_FUNCT_T *write_funct;
+  hal_bit_t *all_op;
+  long period;
+  unsigned long cycles;
+  unsigned long warmup;
+  int states_per_cycle;
+
+  long long *cycle_ns;
+  long long *jitter_ns;
+  unsigned long samples;
+  unsigned long op_cycles;
+  long long op_ns;
+  unsigned long overruns;
+} LCEC_LATENCY_RUN_T;
+
+int rtapi_app_main(void);
+void rtapi_app_exit(void);
+
+static const char *drive_pdos[] = {
+  // outputs
+  "6040:00:16:control:u32", "607a:00:32:target-pos:s32", "60ff:00:32:target-vel:s32",
+  "6071:00:16:target-torque:s32", "6060:00:8:mode:s32",
+  "2000:01:1:dout-0:bit", "2000:02:1:dout-1:bit", "2000:03:1:dout-2:bit", "2000:04:1:dout-3:bit",
+  "2000:05:1:dout-4:bit", "2000:06:1:dout-5:bit", "2000:07:1:dout-6:bit", "2000:08:1:dout-7:bit",
+  "2001:01:16:aout-0:float", "2001:02:16:aout-1:float",
+  NULL,
+  // inputs
+  "6041:00:16:status:u32", "6064:00:32:actual-pos:s32", "606c:00:32:actual-vel:s32",
+  "6077:00:16:actual-torque:s32", "6061:00:8:mode-display:s32",
+  "2100:01:1:din-0:bit", "2100:02:1:din-1:bit", "2100:03:1:din-2:bit", "2100:04:1:din-3:bit",
+  "2100:05:1:din-4:bit", "2100:06:1:din-5:bit", "2100:07:1:din-6:bit", "2100:08:1:din-7:bit",
+  "2101:01:16:ain-0:float", "2101:02:16:ain-1:float",
+  NULL
+};
+
+static long long now_ns(void) {
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+static void write_drive_pdos(FILE *f, const char **pdo) {
+  char idx[5], sidx[3], pin[32], type[8];
+  int bits;
+
+  for (; *pdo != NULL; pdo++) {
+    if (sscanf(*pdo, "%4[^:]:%2[^:]:%d:%31[^:]:%7s", idx, sidx, &bits, pin, type) != 5) {
+      continue;
+    }
+    fprintf(f, "          <pdoEntry idx=\"%s\" subIdx=\"%s\" bitLen=\"%d\" halPin=\"%s\" halType=\"%s\"/>\n", idx, sidx, bits, pin, type);
+  }
+}
+
+static int write_config(const char *filename, int slaves, long period, int states_per_cycle) {
+  FILE *f;
+  int i;
+
+  f = fopen(filename, "w");
+  if (f == NULL) {
+    return -1;
+  }
+
+  fprintf(f, "<masters>\n");
+  fprintf(f, "  <master idx=\"0\" appTimePeriod=\"%ld\" refClockSyncCycles=\"1000\"", period);
+  if (states_per_cycle > 0) {
+    fprintf(f, " slaveStatesPerCycle=\"%d\"", states_per_cycle);
+  }
+  fprintf(f, ">\n");
+  for (i = 0; i < slaves; i++) {
+    switch (i % 4) {
+      case 0:
+        fprintf(f, "    <slave idx=\"%d\" type=\"EL1809\"/>\n", i);
+        break;
+      case 1:
+        fprintf(f, "    <slave idx=\"%d\" type=\"EL2809\"/>\n", i);
+        break;
+      case 2:
+        fprintf(f, "    <slave idx=\"%d\" type=\"EL7342\"/>\n", i);
+        break;
+      default:
+        fprintf(f, "    <slave idx=\"%d\" type=\"generic\" vid=\"%08x\" pid=\"%08x\" configPdos=\"true\">\n", i, LCEC_LATENCY_DRIVE_VID, LCEC_LATENCY_DRIVE_PID);
+        fprintf(f, "      <syncManager idx=\"2\" dir=\"out\">\n        <pdo idx=\"1600\">\n");
+        write_drive_pdos(f, drive_pdos);
+        fprintf(f, "        </pdo>\n      </syncManager>\n");
+        fprintf(f, "      <syncManager idx=\"3\" dir=\"in\">\n        <pdo idx=\"1a00\">\n");
+        write_drive_pdos(f, drive_pdos + 16);
+        fprintf(f, "        </pdo>\n      </syncManager>\n");
+        fprintf(f, "    </slave>\n");
+        break;
+    }
+  }
+  fprintf(f, "  </master>\n");
+  fprintf(f, "</masters>\n");
+
+  return fclose(f);
+}
+
+static int cmp_ll(const void *a, const void *b) {
+  long long x = *((const long long *) a);
+  long long y = *((const long long *) b);
+
+  return (x > y) - (x < y);
+}
+
+static long long percentile(const long long *sorted, unsigned long n, double p) {
+  unsigned long i;
+
+  if (n == 0) {
+    return 0;
+  }
+  i = (unsigned long) (p * n);
+  return sorted[(i < n) ? i : n - 1];
+}
+
+static void *run_thread(void *arg) {
+  LCEC_LATENCY_RUN_T *run = (LCEC_LATENCY_RUN_T *) arg;
+  struct timespec next;
+  long long deadline, start, wake, end;
+  unsigned long i, n;
+  int measure;
+
+  clock_gettime(CLOCK_MONOTONIC, &next);
+  deadline = next.tv_sec * 1000000000LL + next.tv_nsec;
+  start = deadline;
+
+  measure = 0;
+  n = 0;
+  for (i = 0; n < run->cycles && (measure || i < run->warmup); i++) {
+    deadline += run->period;
+    next.tv_sec = deadline / 1000000000LL;
+    next.tv_nsec = deadline % 1000000000LL;
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &next, NULL) == EINTR);
+
+    wake = now_ns();
+    run->read_funct->funct(run->read_funct->arg, run->period);
+    run->write_funct->funct(run->write_funct->arg, run->period);
+    end = now_ns();
+
+    // startup phase until all slaves are operational
+    if (!measure) {
+      if (*(run->all_op)) {
+        run->op_cycles = i + 1;
+        run->op_ns = end - start;
+        measure = 1;
+      }
+      continue;
+    }
+
+    run->jitter_ns[n] = wake - deadline;
+    run->cycle_ns[n] = end - wake;
+    if (end > deadline + run->period) {
+      run->overruns++;
+    }
+    n++;
+  }
+
+  run->samples = n;
+  return NULL;
+}
+
+static int start_thread(pthread_t *thread, LCEC_LATENCY_RUN_T *run, int prio, int cpu) {
+  pthread_attr_t attr;
+  struct sched_param param;
+  cpu_set_t cpuset;
+  int err;
+
+  pthread_attr_init(&attr);
+  if (prio > 0) {
+    memset(&param, 0, sizeof(param));
+    param.sched_priority = prio;
+    pthread_attr_setinheritsched(&attr, PTHREAD_EXPLICIT_SCHED);
+    pthread_attr_setschedpolicy(&attr, SCHED_FIFO);
+    pthread_attr_setschedparam(&attr, &param);
+  }
+  if (cpu >= 0) {
+    CPU_ZERO(&cpuset);
+    CPU_SET(cpu, &cpuset);
+    pthread_attr_setaffinity_np(&attr, sizeof(cpuset), &cpuset);
+  }
+
+  err = pthread_create(thread, &attr, run_thread, run);
+  pthread_attr_destroy(&attr);
+  return err;
+}
+
+static int run_size(int slaves, LCEC_LATENCY_RUN_T *run, int *prio, int cpu, const char *conf_name) {
+  int ret = -1;
+  LCEC_CONF_OUTBUF_T outputBuf;
+  LCEC_CONF_HEADER_T *header;
+  void *shmem_ptr;
+  int shmem_id;
+  ec_master_t *master;
+  lcec_sim_entry_t *entry;
+  LCEC_FAKEHAL_PIN_T *pin;
+  pthread_t thread;
+  long long t0, parse_ns, init_ns, exit_ns;
+  unsigned long entries;
+  int err;
+
+  if (write_config(conf_name, slaves, run->period, run->states_per_cycle) != 0) {
+    fprintf(stderr, "%s: ERROR: unable to write %s\n", modname, conf_name);
+    return -1;
+  }
+
+  // startup: parse, publish and init driver
+  t0 = now_ns();
+  if (parseConfig(conf_name, &outputBuf, NULL)) {
+    return -1;
+  }
+  parse_ns = now_ns() - t0;
+
+  shmem_id = rtapi_shmem_new(LCEC_CONF_SHMEM_KEY, 0, sizeof(LCEC_CONF_HEADER_T) + outputBuf.len);
+  if (shmem_id < 0 || lcec_rtapi_shmem_getptr(shmem_id, &shmem_ptr) < 0) {
+    fprintf(stderr, "%s: ERROR: couldn't allocate config shared memory\n", modname);
+    copyFreeOutputBuffer(&outputBuf, NULL);
+    return -1;
+  }
+  header = shmem_ptr;
+  header->magic = LCEC_CONF_SHMEM_MAGIC;
+  header->length = outputBuf.len;
+  copyFreeOutputBuffer(&outputBuf, shmem_ptr + sizeof(LCEC_CONF_HEADER_T));
+
+  t0 = now_ns();
+  if (rtapi_app_main() != 0) {
+    fprintf(stderr, "%s: ERROR: driver initialization failed\n", modname);
+    goto fail1;
+  }
+  init_ns = now_ns() - t0;
+
+  master = lcec_sim_get_master(0);
+  pin = lcec_fakehal_find_pin(LCEC_MODULE_NAME ".all-op");
+  run->read_funct = lcec_fakehal_find_funct(LCEC_MODULE_NAME ".read-all");
+  run->write_funct = lcec_fakehal_find_funct(LCEC_MODULE_NAME ".write-all");
+  if (master == NULL || pin == NULL || run->read_funct == NULL || run->write_funct == NULL) {
+    fprintf(stderr, "%s: ERROR: driver did not export master, pins or functions\n", modname);
+    goto fail2;
+  }
+  run->all_op = (hal_bit_t *) pin->data;
+
+  entries = 0;
+  for (entry = lcec_sim_next_entry(master, NULL); entry != NULL; entry = lcec_sim_next_entry(master, entry)) {
+    entries++;
+  }
+
+  // cyclic phase
+  run->samples = 0;
+  run->op_cycles = 0;
+  run->op_ns = 0;
+  run->overruns = 0;
+  err = start_thread(&thread, run, *prio, cpu);
+  if (err == EPERM && *prio > 0) {
+    fprintf(stderr, "%s: WARNING: no permission for SCHED_FIFO, using SCHED_OTHER\n", modname);
+    *prio = 0;
+    err = start_thread(&thread, run, *prio, cpu);
+  }
+  if (err != 0) {
+    fprintf(stderr, "%s: ERROR: unable to start thread (%s)\n", modname, strerror(err));
+    goto fail2;
+  }
+  pthread_join(thread, NULL);
+
+  if (run->op_cycles == 0) {
+    fprintf(stderr, "%s: WARNING: %d slaves not operational after %lu cycles\n", modname, slaves, run->warmup);
+  }
+
+  qsort(run->cycle_ns, run->samples, sizeof(long long), cmp_ll);
+  qsort(run->jitter_ns, run->samples, sizeof(long long), cmp_ll);
+  ret = 0;
+
+fail2:
+  t0 = now_ns();
+  rtapi_app_exit();
+  exit_ns = now_ns() - t0;
+fail1:
+  lcec_fakehal_reset();
+  rtapi_shmem_delete(shmem_id, 0);
+
+  if (ret == 0) {
+    printf("%d,%lu,%lld,%lld,%lu,%.1f,%lld,%lu,%lld,%lld,%lld,%lld,%lld,%lld,%lld,%lld,%lu\n",
+      slaves, entries, parse_ns / 1000, init_ns / 1000, run->op_cycles, run->op_ns * 1e-6, exit_ns / 1000, run->samples,
+      percentile(run->cycle_ns, run->samples, 0.5), percentile(run->cycle_ns, run->samples, 0.99),
+      percentile(run->cycle_ns, run->samples, 0.999), percentile(run->cycle_ns, run->samples, 1.0),
+      percentile(run->jitter_ns, run->samples, 0.5), percentile(run->jitter_ns, run->samples, 0.99),
+      percentile(run->jitter_ns, run->samples, 0.999), percentile(run->jitter_ns, run->samples, 1.0),
+      run->overruns);
+    fflush(stdout);
+  }
+  return ret;
+}
+
+static void usage(void) {
+  fprintf(stderr, "usage: %s [-s slaves[,slaves...]] [-p period-ns] [-c cycles] [-w max-warmup-cycles] [-P fifo-prio] [-C cpu] [-S slave-states-per-cycle]\n", modname);
+}
+
+int main(int argc, char **argv) {
+  int opt;
+  int sizes[LCEC_LATENCY_MAX_RUNS] = { 10, 50, 200, 500 };
+  int size_count = 4;
+  int prio = LCEC_LATENCY_PRIO;
+  int cpu = -1;
+  int i, ret;
+  char *tok, *save;
+  char conf_name[] = "/tmp/lcec_latency_XXXXXX";
+  LCEC_LATENCY_RUN_T run;
+
+  modname = "lcec_latency";
+
+  memset(&run, 0, sizeof(run));
+  run.period = LCEC_LATENCY_PERIOD;
+  run.cycles = LCEC_LATENCY_CYCLES;
+  run.warmup = LCEC_LATENCY_WARMUP;
+
+  while ((opt = getopt(argc, argv, "s:p:c:w:P:C:S:h")) != -1) {
+    switch (opt) {
+      case 's':
+        size_count = 0;
+        for (tok = strtok_r(optarg, ",", &save); tok != NULL && size_count < LCEC_LATENCY_MAX_RUNS; tok = strtok_r(NULL, ",", &save)) {
+          sizes[size_count++] = atoi(tok);
+        }
+        break;
+      case 'p':
+        run.period = atol(optarg);
+        break;
+      case 'c':
+        run.cycles = strtoul(optarg, NULL, 0);
+        break;
+      case 'w':
+        run.warmup = strtoul(optarg, NULL, 0);
+        break;
+      case 'P':
+        prio = atoi(optarg);
+        break;
+      case 'C':
+        cpu = atoi(optarg);
+        break;
+      case 'S':
+        run.states_per_cycle = atoi(optarg);
+        break;
+      default:
+        usage();
+        return 1;
+    }
+  }
+  if (size_count == 0 || run.period <= 0 || run.cycles < 1 || run.states_per_cycle < 0) {
+    usage();
+    return 1;
+  }
+  for (i = 0; i < size_count; i++) {
+    if (sizes[i] < 1) {
+      usage();
+      return 1;
+    }
+  }
+
+  run.cycle_ns = malloc(sizeof(long long) * run.cycles);
+  run.jitter_ns = malloc(sizeof(long long) * run.cycles);
+  if (run.cycle_ns == NULL || run.jitter_ns == NULL) {
+    fprintf(stderr, "%s: ERROR: out of memory\n", modname);
+    return 1;
+  }
+
+  if (mlockall(MCL_CURRENT | MCL_FUTURE) != 0) {
+    fprintf(stderr, "%s: WARNING: unable to lock memory\n", modname);
+  }
+
+  ret = mkstemp(conf_name);
+  if (ret < 0) {
+    fprintf(stderr, "%s: ERROR: unable to create temporary config file\n", modname);
+    return 1;
+  }
+  close(ret);
+
+  printf("# period %ld ns, %lu cycles per size, slave states per cycle: ", run.period, run.cycles);
+  if (run.states_per_cycle > 0) {
+    printf("%d\n", run.states_per_cycle);
+  } else {
+    printf("default\n");
+  }
+  printf("slaves,pdo_entries,parse_us,init_us,op_cycles,op_ms,exit_us,samples,"
+    "cycle_p50_ns,cycle_p99_ns,cycle_p999_ns,cycle_max_ns,"
+    "jitter_p50_ns,jitter_p99_ns,jitter_p999_ns,jitter_max_ns,overruns\n");
+  fflush(stdout);
+
+  ret = 0;
+  for (i = 0; i < size_count; i++) {
+    if (run_size(sizes[i], &run, &prio, cpu, conf_name) != 0) {
+      ret = 1;
+      break;
+    }
+  }
+  printf("# scheduling: %s\n", (prio > 0) ? "SCHED_FIFO" : "SCHED_OTHER");
+
+  unlink(conf_name);
+  free(run.cycle_ns);
+  free(run.jitter_ns);
+  return ret;
+}
+
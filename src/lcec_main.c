@@ -62,15 +62,13 @@ MODULE_LICENSE("GPL");
 MODULE_AUTHOR("Sascha Ittner <sascha.ittner@modusoft.de>");
 MODULE_DESCRIPTION("Driver for EtherCAT devices");
 
-typedef struct lcec_typelist {
-  LCEC_SLAVE_TYPE_T type;
-  uint32_t vid;
-  uint32_t pid;
-  int pdo_entry_count;
-  lcec_slave_init_t proc_init;
-} lcec_typelist_t;
-
-static const lcec_typelist_t types[] = {
+typedef struct lcec_functlist {
+  const char *name;
+  void (*master_funct) (void *arg, long period);
+  void (*all_funct) (void *arg, long period);
+} lcec_functlist_t;
+
+const lcec_typelist_t lcec_types[] = {
   // bus coupler
   { lcecSlaveTypeEK1100, LCEC_EK1100_VID, LCEC_EK1100_PID, LCEC_EK1100_PDOS, NULL},
   { lcecSlaveTypeEK1110, LCEC_EK1110_VID, LCEC_EK1110_PID, LCEC_EK1110_PDOS, NULL},
@@ -249,6 +247,9 @@ static const lcec_pindesc_t master_pins[] = {
   { HAL_S32, HAL_OUT, offsetof(lcec_master_data_t, pll_out), "%s.pll-out" },
   { HAL_U32, HAL_OUT, offsetof(lcec_master_data_t, pll_reset_cnt), "%s.pll-reset-count" },
 #endif
+  { HAL_S32, HAL_OUT, offsetof(lcec_master_data_t, send_time), "%s.send-time" },
+  { HAL_U32, HAL_OUT, offsetof(lcec_master_data_t, thread_overruns), "%s.thread-overruns" },
+  { HAL_BIT, HAL_IN, offsetof(lcec_master_data_t, timing_reset), "%s.time-reset" },
   { HAL_TYPE_UNSPECIFIED, HAL_DIR_UNSPECIFIED, -1, NULL }
 };
 
@@ -260,6 +261,37 @@ static const lcec_pindesc_t master_params[] = {
   { HAL_TYPE_UNSPECIFIED, HAL_DIR_UNSPECIFIED, -1, NULL }
 };
 
+static const lcec_pindesc_t domain_pins[] = {
+  { HAL_U32, HAL_OUT, offsetof(lcec_domain_data_t, wc_expected), "%s.wc-expected" },
+  { HAL_U32, HAL_OUT, offsetof(lcec_domain_data_t, wc_actual), "%s.wc-actual" },
+  { HAL_U32, HAL_OUT, offsetof(lcec_domain_data_t, wc_state), "%s.wc-state" },
+  { HAL_BIT, HAL_OUT, offsetof(lcec_domain_data_t, wc_valid), "%s.wc-valid" },
+  { HAL_U32, HAL_OUT, offsetof(lcec_domain_data_t, wc_bad_cycles), "%s.wc-bad-cycles" },
+  { HAL_U32, HAL_OUT, offsetof(lcec_domain_data_t, wc_lost_frames), "%s.wc-lost-frames" },
+  { HAL_TYPE_UNSPECIFIED, HAL_DIR_UNSPECIFIED, -1, NULL }
+};
+
+static const lcec_pindesc_t domain_params[] = {
+  { HAL_BIT, HAL_RW, offsetof(lcec_domain_data_t, wc_skip_read), "%s.wc-skip-read" },
+  { HAL_TYPE_UNSPECIFIED, HAL_DIR_UNSPECIFIED, -1, NULL }
+};
+
+static const lcec_pindesc_t timing_pins[] = {
+  { HAL_U32, HAL_OUT, offsetof(lcec_timing_data_t, last), "%s.time-%s-last" },
+  { HAL_U32, HAL_OUT, offsetof(lcec_timing_data_t, min), "%s.time-%s-min" },
+  { HAL_U32, HAL_OUT, offsetof(lcec_timing_data_t, max), "%s.time-%s-max" },
+  { HAL_U32, HAL_OUT, offsetof(lcec_timing_data_t, avg), "%s.time-%s-avg" },
+  { HAL_TYPE_UNSPECIFIED, HAL_DIR_UNSPECIFIED, -1, NULL }
+};
+
+static const char *timing_names[] = {
+  "receive",
+  "process",
+  "read",
+  "write",
+  "send"
+};
+
 static const lcec_pindesc_t slave_pins[] = {
   { HAL_BIT, HAL_OUT, offsetof(lcec_slave_state_t, online), "%s.%s.%s.slave-online" },
   { HAL_BIT, HAL_OUT, offsetof(lcec_slave_state_t, operational), "%s.%s.%s.slave-oper" },
@@ -273,25 +305,69 @@ static const lcec_pindesc_t slave_pins[] = {
 static lcec_master_t *first_master = NULL;
 static lcec_master_t *last_master = NULL;
 static int comp_id = -1;
+static int conf_shmem_id = -1;
+static LCEC_CONF_HEADER_T *conf_header = NULL;
+static void *conf_copy = NULL;
 
 static lcec_master_data_t *global_hal_data;
 static ec_master_state_t global_ms;
 
 int lcec_parse_config(void);
 void lcec_clear_config(void);
+lcec_domain_t *lcec_add_domain(lcec_master_t *master, const char *name, int cycle_divider);
+lcec_domain_t *lcec_domain_by_name(lcec_master_t *master, const char *name);
+#ifdef __KERNEL__
+int lcec_alloc_domain_mem(lcec_master_t *master);
+#endif
+void lcec_setup_domain_data(lcec_master_t *master);
+int lcec_find_pdo_entry_info(lcec_slave_t *slave, uint16_t index, uint8_t subindex, ec_direction_t *dir, unsigned int *bit_length);
+int lcec_init_output_ranges(lcec_master_t *master);
+int lcec_next_entry_offset(lcec_master_t *master, lcec_domain_t *domain, int offset);
+int lcec_start_master_thread(lcec_master_t *master);
+void lcec_stop_master_thread(lcec_master_t *master);
+void lcec_wake_master_thread(lcec_master_thread_t *thread);
+void *lcec_master_thread(void *arg);
+void lcec_run_all(void (*funct) (void *arg, long period), long period);
+int lcec_init_domain_funcs(lcec_master_t *master);
 
 void lcec_request_lock(void *data);
 void lcec_release_lock(void *data);
 
 lcec_master_data_t *lcec_init_master_hal(const char *pfx, int global);
+lcec_domain_data_t *lcec_init_domain_hal(const char *pfx);
 lcec_slave_state_t *lcec_init_slave_state_hal(char *master_name, char *slave_name);
 void lcec_update_master_hal(lcec_master_data_t *hal_data, ec_master_state_t *ms);
+void lcec_update_domain_hal(lcec_domain_data_t *hal_data, ec_domain_state_t *ds);
+void lcec_update_state_poll_count(lcec_master_t *master, long period);
 void lcec_update_slave_state_hal(lcec_slave_state_t *hal_data, ec_slave_config_state_t *ss);
+int lcec_init_timing_hal(lcec_master_data_t *hal_data, const char *pfx);
+void lcec_reset_timing_hal(lcec_master_data_t *hal_data);
+void lcec_update_timing_hal(lcec_master_data_t *hal_data, LCEC_TIMING_PHASE_T phase, long long t);
 
 void lcec_read_all(void *arg, long period);
 void lcec_write_all(void *arg, long period);
+void lcec_receive_all(void *arg, long period);
+void lcec_process_inputs_all(void *arg, long period);
+void lcec_process_outputs_all(void *arg, long period);
+void lcec_send_all(void *arg, long period);
+void lcec_update_global_hal(void);
 void lcec_read_master(void *arg, long period);
 void lcec_write_master(void *arg, long period);
+void lcec_receive_master(void *arg, long period);
+void lcec_process_inputs_master(void *arg, long period);
+void lcec_process_outputs_master(void *arg, long period);
+void lcec_send_master(void *arg, long period);
+void lcec_send_data(lcec_master_t *master, long period);
+
+static const lcec_functlist_t functs[] = {
+  { "read", lcec_read_master, lcec_read_all },
+  { "write", lcec_write_master, lcec_write_all },
+  { "receive", lcec_receive_master, lcec_receive_all },
+  { "process-inputs", lcec_process_inputs_master, lcec_process_inputs_all },
+  { "process-outputs", lcec_process_outputs_master, lcec_process_outputs_all },
+  { "send", lcec_send_master, lcec_send_all },
+  { NULL }
+};
 
 static int lcec_pin_newfv(hal_type_t type, hal_pin_dir_t dir, void **data_ptr_addr, const char *fmt, va_list ap);
 static int lcec_pin_newfv_list(void *base, const lcec_pindesc_t *list, va_list ap);
@@ -301,11 +377,12 @@ static int lcec_param_newfv_list(void *base, const lcec_pindesc_t *list, va_list
 int rtapi_app_main(void) {
   int slave_count;
   lcec_master_t *master;
+  lcec_domain_t *domain;
   lcec_slave_t *slave;
   char name[HAL_NAME_LEN + 1];
-  ec_pdo_entry_reg_t *pdo_entry_regs;
   lcec_slave_sdoconf_t *sdo_config;
   lcec_slave_idnconf_t *idn_config;
+  const lcec_functlist_t *funct;
   struct timeval tv;
 
   // connect to the HAL
@@ -337,14 +414,15 @@ int rtapi_app_main(void) {
     ecrt_master_callbacks(master->master, lcec_request_lock, lcec_release_lock, master);
 #endif
 
-    // create domain
-    if (!(master->domain = ecrt_master_create_domain(master->master))) {
-      rtapi_print_msg (RTAPI_MSG_ERR, LCEC_MSG_PFX "master %s domain creation failed\n", master->name);
-      goto fail2;
+    // create domains
+    for (domain = master->first_domain; domain != NULL; domain = domain->next) {
+      if (!(domain->domain = ecrt_master_create_domain(master->master))) {
+        rtapi_print_msg (RTAPI_MSG_ERR, LCEC_MSG_PFX "master %s domain %d creation failed\n", master->name, domain->index);
+        goto fail2;
+      }
     }
 
     // initialize slaves
-    pdo_entry_regs = master->pdo_entry_regs;
     for (slave = master->first_slave; slave != NULL; slave = slave->next) {
       // read slave config
       if (!(slave->config = ecrt_master_slave_config(master->master, 0, slave->index, slave->vid, slave->pid))) {
@@ -354,7 +432,7 @@ int rtapi_app_main(void) {
 
       // initialize sdos
       if (slave->sdo_config != NULL) {
-        for (sdo_config = slave->sdo_config; sdo_config->index != 0xffff; sdo_config = (lcec_slave_sdoconf_t *) &sdo_config->data[sdo_config->length]) {
+        for (sdo_config = slave->sdo_config; sdo_config->confType == lcecConfTypeSdoConfig; sdo_config = LCEC_CONF_TOKEN_NEXT(sdo_config, sizeof(*sdo_config) + sdo_config->length)) {
           if (sdo_config->subindex == LCEC_CONF_SDO_COMPLETE_SUBIDX) {
             if (ecrt_slave_config_complete_sdo(slave->config, sdo_config->index, &sdo_config->data[0], sdo_config->length) != 0) {
               rtapi_print_msg (RTAPI_MSG_ERR, LCEC_MSG_PFX "fail to configure slave %s.%s sdo %04x (complete)\n", master->name, slave->name, sdo_config->index);
@@ -369,7 +447,7 @@ int rtapi_app_main(void) {
 
       // initialize idns
       if (slave->idn_config != NULL) {
-        for (idn_config = slave->idn_config; idn_config->state != 0; idn_config = (lcec_slave_idnconf_t *) &idn_config->data[idn_config->length]) {
+        for (idn_config = slave->idn_config; idn_config->confType == lcecConfTypeIdnConfig; idn_config = LCEC_CONF_TOKEN_NEXT(idn_config, sizeof(*idn_config) + idn_config->length)) {
           if (ecrt_slave_config_idn(slave->config, idn_config->drive, idn_config->idn, idn_config->state, &idn_config->data[0], idn_config->length) != 0) {
             rtapi_print_msg (RTAPI_MSG_ERR, LCEC_MSG_PFX "fail to configure slave %s.%s drive %d idn %c-%d-%d (state %d, length %u)\n", master->name, slave->name, idn_config->drive,
               (idn_config->idn & 0x8000) ? 'P' : 'S', (idn_config->idn >> 12) & 0x0007, idn_config->idn & 0x0fff, idn_config->state, (unsigned int) idn_config->length);
@@ -379,11 +457,10 @@ int rtapi_app_main(void) {
 
       // setup pdos
       if (slave->proc_init != NULL) {
-        if ((slave->proc_init(comp_id, slave, pdo_entry_regs)) != 0) {
+        if ((slave->proc_init(comp_id, slave, slave->pdo_entry_regs)) != 0) {
           goto fail2;
         }
       }
-      pdo_entry_regs += slave->pdo_entry_count;
 
       // configure dc for this slave
       if (slave->dc_conf != NULL) {
@@ -415,14 +492,26 @@ int rtapi_app_main(void) {
       }
     }
 
-    // terminate POD entries
-    pdo_entry_regs->index = 0;
+    // build cyclic dispatch tables
+    if (lcec_init_domain_funcs(master) != 0) {
+      goto fail2;
+    }
+
+    // register PDO entries (lists are zero terminated by allocation)
+    for (domain = master->first_domain; domain != NULL; domain = domain->next) {
+      if (ecrt_domain_reg_pdo_entry_list(domain->domain, domain->pdo_entry_regs)) {
+        rtapi_print_msg (RTAPI_MSG_ERR, LCEC_MSG_PFX "master %s PDO entry registration failed\n", master->name);
+        goto fail2;
+      }
+    }
 
-    // register PDO entries
-    if (ecrt_domain_reg_pdo_entry_list(master->domain, master->pdo_entry_regs)) {
-      rtapi_print_msg (RTAPI_MSG_ERR, LCEC_MSG_PFX "master %s PDO entry registration failed\n", master->name);
+#ifdef __KERNEL__
+    // place all domains in one memory block, so
+    // drivers can access them via master->process_data
+    if (lcec_alloc_domain_mem(master) != 0) {
       goto fail2;
     }
+#endif
 
     // initialize application time
     lcec_gettimeofday(&tv);
@@ -446,15 +535,40 @@ int rtapi_app_main(void) {
       goto fail2;
     }
 
-    // Get internal process data for domain
-    master->process_data = ecrt_domain_data(master->domain);
-    master->process_data_len = ecrt_domain_size(master->domain);
+    // Get internal process data for domains
+    lcec_setup_domain_data(master);
+
+    // setup process image tap
+    if (master->tap_enabled && lcec_tap_init(comp_id, master) != 0) {
+      goto fail2;
+    }
+
+    // setup process data recorder
+    if (master->rec_depth > 0 && lcec_rec_init(comp_id, master) != 0) {
+      goto fail2;
+    }
+
+    // find output ranges to save over receive for send first mode
+    if (master->send_first && lcec_init_output_ranges(master) != 0) {
+      goto fail2;
+    }
 
     // init hal data
     rtapi_snprintf(name, HAL_NAME_LEN, "%s.%s", LCEC_MODULE_NAME, master->name);
     if ((master->hal_data = lcec_init_master_hal(name, 0)) == NULL) {
       goto fail2;
     }
+    for (domain = master->first_domain; domain != NULL; domain = domain->next) {
+      // default domain uses master's prefix
+      if (domain->index == 0) {
+        rtapi_snprintf(name, HAL_NAME_LEN, "%s.%s", LCEC_MODULE_NAME, master->name);
+      } else {
+        rtapi_snprintf(name, HAL_NAME_LEN, "%s.%s.domain.%s", LCEC_MODULE_NAME, master->name, domain->name);
+      }
+      if ((domain->hal_data = lcec_init_domain_hal(name)) == NULL) {
+        goto fail2;
+      }
+    }
 
 #ifdef RTAPI_TASK_PLL_SUPPORT
     // set default PLL_STEP: use +/-0.1% of period
@@ -463,31 +577,30 @@ int rtapi_app_main(void) {
     master->hal_data->pll_max_err = master->app_time_period;
 #endif
 
-    // export read function
-    rtapi_snprintf(name, HAL_NAME_LEN, "%s.%s.read", LCEC_MODULE_NAME, master->name);
-    if (hal_export_funct(name, lcec_read_master, master, 0, 0, comp_id) != 0) {
-      rtapi_print_msg (RTAPI_MSG_ERR, LCEC_MSG_PFX "master %s read funct export failed\n", master->name);
-      goto fail2;
+    // export master functions
+    for (funct = functs; funct->name != NULL; funct++) {
+      rtapi_snprintf(name, HAL_NAME_LEN, "%s.%s.%s", LCEC_MODULE_NAME, master->name, funct->name);
+      if (hal_export_funct(name, funct->master_funct, master, 0, 0, comp_id) != 0) {
+        rtapi_print_msg (RTAPI_MSG_ERR, LCEC_MSG_PFX "master %s %s funct export failed\n", master->name, funct->name);
+        goto fail2;
+      }
     }
-    // export write function
-    rtapi_snprintf(name, HAL_NAME_LEN, "%s.%s.write", LCEC_MODULE_NAME, master->name);
-    if (hal_export_funct(name, lcec_write_master, master, 0, 0, comp_id) != 0) {
-      rtapi_print_msg (RTAPI_MSG_ERR, LCEC_MSG_PFX "master %s write funct export failed\n", master->name);
+  }
+
+  // export global functions
+  for (funct = functs; funct->name != NULL; funct++) {
+    rtapi_snprintf(name, HAL_NAME_LEN, "%s.%s-all", LCEC_MODULE_NAME, funct->name);
+    if (hal_export_funct(name, funct->all_funct, NULL, 0, 0, comp_id) != 0) {
+      rtapi_print_msg (RTAPI_MSG_ERR, LCEC_MSG_PFX "%s-all funct export failed\n", funct->name);
       goto fail2;
     }
   }
 
-  // export read-all function
-  rtapi_snprintf(name, HAL_NAME_LEN, "%s.read-all", LCEC_MODULE_NAME);
-  if (hal_export_funct(name, lcec_read_all, NULL, 0, 0, comp_id) != 0) {
-    rtapi_print_msg (RTAPI_MSG_ERR, LCEC_MSG_PFX "read-all funct export failed\n");
-    goto fail2;
-  }
-  // export write-all function
-  rtapi_snprintf(name, HAL_NAME_LEN, "%s.write-all", LCEC_MODULE_NAME);
-  if (hal_export_funct(name, lcec_write_all, NULL, 0, 0, comp_id) != 0) {
-    rtapi_print_msg (RTAPI_MSG_ERR, LCEC_MSG_PFX "write-all funct export failed\n");
-    goto fail2;
+  // start master helper threads
+  for (master = first_master; master != NULL; master = master->next) {
+    if (master->thread_cpu >= 0 && lcec_start_master_thread(master) != 0) {
+      goto fail2;
+    }
   }
 
   rtapi_print_msg(RTAPI_MSG_INFO, LCEC_MSG_PFX "installed driver for %d slaves\n", slave_count);
@@ -514,21 +627,36 @@ void rtapi_app_exit(void) {
   hal_exit(comp_id);
 }
 
+static void *lcec_conf_token(void **conf, void *conf_end, size_t size) {
+  void *token = *conf;
+
+  if (size > (size_t) (conf_end - token)) {
+    rtapi_print_msg(RTAPI_MSG_ERR, LCEC_MSG_PFX "Config stream truncated\n");
+    return NULL;
+  }
+
+  *conf = token + size;
+  return token;
+}
+
 int lcec_parse_config(void) {
   int shmem_id;
   void *shmem_ptr;
   LCEC_CONF_HEADER_T *header;
   size_t length;
   void *conf;
+  void *conf_start;
+  void *conf_end;
   int slave_count;
   const lcec_typelist_t *type;
   lcec_master_t *master;
+  lcec_domain_t *domain;
   lcec_slave_t *slave;
-  lcec_slave_dc_t *dc;
-  lcec_slave_watchdog_t *wd;
   ec_pdo_entry_reg_t *pdo_entry_regs;
   LCEC_CONF_TYPE_T conf_type;
+  LCEC_CONF_TYPE_T prev_conf_type;
   LCEC_CONF_MASTER_T *master_conf;
+  LCEC_CONF_DOMAIN_T *domain_conf;
   LCEC_CONF_SLAVE_T *slave_conf;
   LCEC_CONF_DC_T *dc_conf;
   LCEC_CONF_WATCHDOG_T *wd_conf;
@@ -542,11 +670,14 @@ int lcec_parse_config(void) {
   ec_pdo_entry_info_t *generic_pdo_entries;
   ec_pdo_info_t *generic_pdos;
   ec_sync_info_t *generic_sync_managers;
-  lcec_generic_pin_t *generic_hal_data;
+  lcec_generic_pin_conf_t *generic_pin_conf;
   hal_pin_dir_t generic_hal_dir;
-  lcec_slave_sdoconf_t *sdo_config;
-  lcec_slave_idnconf_t *idn_config;
-  lcec_slave_modparam_t *modparams;
+  ec_pdo_entry_info_t *generic_pdo_entries_end;
+  ec_pdo_info_t *generic_pdos_end;
+  ec_sync_info_t *generic_sync_managers_end;
+  lcec_generic_pin_conf_t *generic_pin_conf_end;
+  size_t modparam_count;
+  size_t modparam_max;
 
   // initialize list
   first_master = NULL;
@@ -583,8 +714,31 @@ int lcec_parse_config(void) {
     goto fail1;
   }
 
-  // get pointer to config
+  // get pointer to config, slaves reference its tokens
+  header = shmem_ptr;
   conf = shmem_ptr + sizeof(LCEC_CONF_HEADER_T);
+  if (LCEC_CONF_TOKEN_PAD((uintptr_t) conf) != 0) {
+    rtapi_print_msg (RTAPI_MSG_ERR, LCEC_MSG_PFX "user/RT shared memory is not aligned\n");
+    goto fail1;
+  }
+  if (header->mode == LCEC_CONF_MODE_REFERENCE) {
+    // keep shmem until lcec_clear_config(), lcec_conf must not reuse it
+    header->inUse = 1;
+    conf_header = header;
+    conf_shmem_id = shmem_id;
+  } else {
+    // copy config and close shmem
+    conf_copy = lcec_zalloc(length);
+    if (conf_copy == NULL) {
+      rtapi_print_msg (RTAPI_MSG_ERR, LCEC_MSG_PFX "Unable to allocate config memory\n");
+      goto fail1;
+    }
+    memcpy(conf_copy, conf, length);
+    rtapi_shmem_delete(shmem_id, comp_id);
+    conf = conf_copy;
+  }
+  conf_start = conf;
+  conf_end = conf + length;
 
   // process config items
   slave_count = 0;
@@ -593,19 +747,35 @@ int lcec_parse_config(void) {
   generic_pdo_entries = NULL;
   generic_pdos = NULL;
   generic_sync_managers = NULL;
-  generic_hal_data = NULL;
+  generic_pin_conf = NULL;
   generic_hal_dir = 0;
-  sdo_config = NULL;
-  idn_config = NULL;
   pe_conf = NULL;
-  modparams = NULL;
-  while((conf_type = ((LCEC_CONF_NULL_T *)conf)->confType) != lcecConfTypeNone) {
-    // get type
+  generic_pdo_entries_end = NULL;
+  generic_pdos_end = NULL;
+  generic_sync_managers_end = NULL;
+  generic_pin_conf_end = NULL;
+  modparam_count = 0;
+  modparam_max = 0;
+  conf_type = lcecConfTypeNone;
+  for (;;) {
+    // get type, tokens start aligned
+    prev_conf_type = conf_type;
+    if (LCEC_CONF_TOKEN_PAD(conf - conf_start) + sizeof(LCEC_CONF_NULL_T) > (size_t) (conf_end - conf)) {
+      rtapi_print_msg(RTAPI_MSG_ERR, LCEC_MSG_PFX "Config end marker missing\n");
+      goto fail2;
+    }
+    conf += LCEC_CONF_TOKEN_PAD(conf - conf_start);
+    conf_type = ((LCEC_CONF_NULL_T *)conf)->confType;
+    if (conf_type == lcecConfTypeNone) {
+      break;
+    }
+
     switch (conf_type) {
       case lcecConfTypeMaster:
         // get config token
-        master_conf = (LCEC_CONF_MASTER_T *)conf;
-        conf += sizeof(LCEC_CONF_MASTER_T);
+        if ((master_conf = lcec_conf_token(&conf, conf_end, sizeof(LCEC_CONF_MASTER_T))) == NULL) {
+          goto fail2;
+        }
 
         // alloc master memory
         master = lcec_zalloc(sizeof(lcec_master_t));
@@ -620,15 +790,51 @@ int lcec_parse_config(void) {
         master->name[LCEC_CONF_STR_MAXLEN - 1] = 0;
         master->app_time_period = master_conf->appTimePeriod;
         master->sync_ref_cycles = master_conf->refClockSyncCycles;
+        master->state_poll_conf = master_conf->slaveStatesPerCycle;
+        master->send_first = master_conf->sendFirst;
+        master->thread_cpu = master_conf->threadCpu;
+        master->tap_enabled = master_conf->processDataTap;
+        master->rec_depth = master_conf->recorderDepth;
 
         // add master to list
         LCEC_LIST_APPEND(first_master, last_master, master);
+
+        // create default domain
+        if (lcec_add_domain(master, "", 1) == NULL) {
+          goto fail2;
+        }
+        break;
+
+      case lcecConfTypeDomain:
+        // get config token
+        if ((domain_conf = lcec_conf_token(&conf, conf_end, sizeof(LCEC_CONF_DOMAIN_T))) == NULL) {
+          goto fail2;
+        }
+
+        // check for master
+        if (master == NULL) {
+          rtapi_print_msg(RTAPI_MSG_ERR, LCEC_MSG_PFX "Master node for domain missing\n");
+          goto fail2;
+        }
+        domain_conf->name[LCEC_CONF_STR_MAXLEN - 1] = 0;
+
+        // check for duplicate name
+        if (lcec_domain_by_name(master, domain_conf->name) != NULL) {
+          rtapi_print_msg(RTAPI_MSG_ERR, LCEC_MSG_PFX "Duplicate domain %s.%s\n", master->name, domain_conf->name);
+          goto fail2;
+        }
+
+        // create domain
+        if (lcec_add_domain(master, domain_conf->name, domain_conf->cycleDivider) == NULL) {
+          goto fail2;
+        }
         break;
 
       case lcecConfTypeSlave:
         // get config token
-        slave_conf = (LCEC_CONF_SLAVE_T *)conf;
-        conf += sizeof(LCEC_CONF_SLAVE_T);
+        if ((slave_conf = lcec_conf_token(&conf, conf_end, sizeof(LCEC_CONF_SLAVE_T))) == NULL) {
+          goto fail2;
+        }
 
         // check for master
         if (master == NULL) {
@@ -640,13 +846,30 @@ int lcec_parse_config(void) {
         if (slave_conf->type == lcecSlaveTypeGeneric) {
           type = NULL;
         } else {
-          for (type = types; type->type != slave_conf->type && type->type != lcecSlaveTypeInvalid; type++);
+          for (type = lcec_types; type->type != slave_conf->type && type->type != lcecSlaveTypeInvalid; type++);
           if (type->type == lcecSlaveTypeInvalid) {
-            rtapi_print_msg(RTAPI_MSG_WARN, LCEC_MSG_PFX "Invalid slave type %d\n", slave_conf->type);
-            continue;
+            rtapi_print_msg(RTAPI_MSG_ERR, LCEC_MSG_PFX "Invalid slave type %d\n", slave_conf->type);
+            goto fail2;
           }
         }
 
+        // terminate strings and check counts against stream size
+        slave_conf->name[LCEC_CONF_STR_MAXLEN - 1] = 0;
+        slave_conf->domain[LCEC_CONF_STR_MAXLEN - 1] = 0;
+        if (slave_conf->syncManagerCount > length || slave_conf->pdoCount > length || slave_conf->pdoEntryCount > length ||
+            slave_conf->pdoMappingCount > length || slave_conf->sdoConfigLength > length || slave_conf->idnConfigLength > length ||
+            slave_conf->modParamCount > length) {
+          rtapi_print_msg(RTAPI_MSG_ERR, LCEC_MSG_PFX "Invalid item counts for slave %s.%s\n", master->name, slave_conf->name);
+          goto fail2;
+        }
+
+        // get slave's domain
+        domain = lcec_domain_by_name(master, slave_conf->domain);
+        if (domain == NULL) {
+          rtapi_print_msg(RTAPI_MSG_ERR, LCEC_MSG_PFX "Domain %s for slave %s.%s not found\n", slave_conf->domain, master->name, slave_conf->name);
+          goto fail2;
+        }
+
         // create new slave
         slave = lcec_zalloc(sizeof(lcec_slave_t));
         if (slave == NULL) {
@@ -658,16 +881,21 @@ int lcec_parse_config(void) {
         generic_pdo_entries = NULL;
         generic_pdos = NULL;
         generic_sync_managers = NULL;
-        generic_hal_data = NULL;
+        generic_pin_conf = NULL;
         generic_hal_dir = 0;
-        sdo_config = NULL;
-        idn_config = NULL;
-        modparams = NULL;
+        pe_conf = NULL;
+        generic_pdo_entries_end = NULL;
+        generic_pdos_end = NULL;
+        generic_sync_managers_end = NULL;
+        generic_pin_conf_end = NULL;
+        modparam_count = 0;
+        modparam_max = slave_conf->modParamCount;
 
         slave->index = slave_conf->index;
         strncpy(slave->name, slave_conf->name, LCEC_CONF_STR_MAXLEN);
         slave->name[LCEC_CONF_STR_MAXLEN - 1] = 0;
         slave->master = master;
+        slave->domain = domain;
 
         // add slave to list
         LCEC_LIST_APPEND(master->first_slave, master->last_slave, slave);
@@ -685,88 +913,58 @@ int lcec_parse_config(void) {
           slave->pdo_entry_count = slave_conf->pdoMappingCount;
           slave->proc_init = lcec_generic_init;
 
-          // alloc hal memory
-          if ((generic_hal_data = hal_malloc(sizeof(lcec_generic_pin_t) * slave_conf->pdoMappingCount)) == NULL) {
-            rtapi_print_msg(RTAPI_MSG_ERR, LCEC_MSG_PFX "hal_malloc() for slave %s.%s failed\n", master->name, slave_conf->name);
-            goto fail2;
-          }
-          memset(generic_hal_data, 0, sizeof(lcec_generic_pin_t) * slave_conf->pdoMappingCount);
-
-          // alloc pdo entry memory
-          generic_pdo_entries = lcec_zalloc(sizeof(ec_pdo_entry_info_t) * slave_conf->pdoEntryCount);
-          if (generic_pdo_entries == NULL) {
-            rtapi_print_msg(RTAPI_MSG_ERR, LCEC_MSG_PFX "Unable to allocate slave %s.%s generic pdo entry memory\n", master->name, slave_conf->name);
-            goto fail2;
-          }
-
-          // alloc pdo memory
-          generic_pdos = lcec_zalloc(sizeof(ec_pdo_info_t) * slave_conf->pdoCount);
-          if (generic_pdos == NULL) {
-            rtapi_print_msg(RTAPI_MSG_ERR, LCEC_MSG_PFX "Unable to allocate slave %s.%s generic pdo memory\n", master->name, slave_conf->name);
+          // alloc pin config, only needed by lcec_generic_init()
+          // which builds the hal records from it
+          if ((generic_pin_conf = lcec_zalloc(sizeof(lcec_generic_pin_conf_t) * slave_conf->pdoMappingCount)) == NULL) {
+            rtapi_print_msg(RTAPI_MSG_ERR, LCEC_MSG_PFX "Unable to allocate slave %s.%s generic pin memory\n", master->name, slave_conf->name);
             goto fail2;
           }
+          generic_pin_conf_end = generic_pin_conf + slave_conf->pdoMappingCount;
+          slave->generic_pin_conf = generic_pin_conf;
 
-          // alloc sync manager memory
-          generic_sync_managers = lcec_zalloc(sizeof(ec_sync_info_t) * (slave_conf->syncManagerCount + 1));
+          // alloc sync manager, pdo and pdo entry memory in one block,
+          // the master keeps pointers into it, so it can't live in shmem
+          generic_sync_managers = lcec_zalloc(sizeof(ec_sync_info_t) * (slave_conf->syncManagerCount + 1) +
+            sizeof(ec_pdo_info_t) * slave_conf->pdoCount + sizeof(ec_pdo_entry_info_t) * slave_conf->pdoEntryCount);
           if (generic_sync_managers == NULL) {
-            rtapi_print_msg(RTAPI_MSG_ERR, LCEC_MSG_PFX "Unable to allocate slave %s.%s generic sync manager memory\n", master->name, slave_conf->name);
+            rtapi_print_msg(RTAPI_MSG_ERR, LCEC_MSG_PFX "Unable to allocate slave %s.%s generic pdo memory\n", master->name, slave_conf->name);
             goto fail2;
           }
           generic_sync_managers->index = 0xff;
+          generic_sync_managers_end = generic_sync_managers + slave_conf->syncManagerCount;
+          generic_pdos = (ec_pdo_info_t *) (generic_sync_managers_end + 1);
+          generic_pdos_end = generic_pdos + slave_conf->pdoCount;
+          generic_pdo_entries = (ec_pdo_entry_info_t *) generic_pdos_end;
+          generic_pdo_entries_end = generic_pdo_entries + slave_conf->pdoEntryCount;
         }
 
-        // alloc sdo config memory
-        if (slave_conf->sdoConfigLength > 0) {
-          sdo_config = lcec_zalloc(slave_conf->sdoConfigLength + sizeof(lcec_slave_sdoconf_t));
-          if (sdo_config == NULL) {
-            rtapi_print_msg(RTAPI_MSG_ERR, LCEC_MSG_PFX "Unable to allocate slave %s.%s sdo entry memory\n", master->name, slave_conf->name);
-            goto fail2;
-          }
-        }
-
-        // alloc idn config memory
-        if (slave_conf->idnConfigLength > 0) {
-          idn_config = lcec_zalloc(slave_conf->idnConfigLength + sizeof(lcec_slave_idnconf_t));
-          if (idn_config == NULL) {
-            rtapi_print_msg(RTAPI_MSG_ERR, LCEC_MSG_PFX "Unable to allocate slave %s.%s idn entry memory\n", master->name, slave_conf->name);
-            goto fail2;
-          }
-        }
-
-        // alloc modparam memory
-        if (slave_conf->modParamCount > 0) {
-          modparams = lcec_zalloc(sizeof(lcec_slave_modparam_t) * (slave_conf->modParamCount + 1));
-          if (modparams == NULL) {
-            rtapi_print_msg(RTAPI_MSG_ERR, LCEC_MSG_PFX "Unable to allocate slave %s.%s modparam memory\n", master->name, slave_conf->name);
-            goto fail2;
-          }
-          modparams[slave_conf->modParamCount].id = -1;
-        }
-
-        slave->hal_data = generic_hal_data;
+        slave->hal_data = NULL;
         slave->generic_pdo_entries = generic_pdo_entries;
         slave->generic_pdos = generic_pdos;
         slave->generic_sync_managers = generic_sync_managers;
         if (slave_conf->configPdos) {
           slave->sync_info = generic_sync_managers;
         }
-        slave->sdo_config = sdo_config;
-        slave->idn_config = idn_config;
-        slave->modparams = modparams;
+        slave->sdo_config = NULL;
+        slave->idn_config = NULL;
+        slave->modparams = NULL;
         slave->dc_conf = NULL;
         slave->wd_conf = NULL;
 
-        // update master's POD entry count
+        // update master's and domain's POD entry count
         master->pdo_entry_count += slave->pdo_entry_count;
+        domain->pdo_entry_count += slave->pdo_entry_count;
 
         // update slave count
+        master->slave_count++;
         slave_count++;
         break;
 
       case lcecConfTypeDcConf:
         // get config token
-        dc_conf = (LCEC_CONF_DC_T *)conf;
-        conf += sizeof(LCEC_CONF_DC_T);
+        if ((dc_conf = lcec_conf_token(&conf, conf_end, sizeof(LCEC_CONF_DC_T))) == NULL) {
+          goto fail2;
+        }
 
         // check for slave
         if (slave == NULL) {
@@ -780,28 +978,15 @@ int lcec_parse_config(void) {
           continue;
         }
 
-        // create new dc config
-        dc = lcec_zalloc(sizeof(lcec_slave_dc_t));
-        if (dc == NULL) {
-          rtapi_print_msg(RTAPI_MSG_ERR, LCEC_MSG_PFX "Unable to allocate slave %s.%s dc config memory\n", master->name, slave->name);
-          goto fail2;
-        }
-
-        // initialize dc conf
-        dc->assignActivate = dc_conf->assignActivate;
-        dc->sync0Cycle = dc_conf->sync0Cycle;
-        dc->sync0Shift = dc_conf->sync0Shift;
-        dc->sync1Cycle = dc_conf->sync1Cycle;
-        dc->sync1Shift = dc_conf->sync1Shift;
-
         // add to slave
-        slave->dc_conf = dc;
+        slave->dc_conf = dc_conf;
         break;
 
       case lcecConfTypeWatchdog:
         // get config token
-        wd_conf = (LCEC_CONF_WATCHDOG_T *)conf;
-        conf += sizeof(LCEC_CONF_WATCHDOG_T);
+        if ((wd_conf = lcec_conf_token(&conf, conf_end, sizeof(LCEC_CONF_WATCHDOG_T))) == NULL) {
+          goto fail2;
+        }
 
         // check for slave
         if (slave == NULL) {
@@ -815,25 +1000,15 @@ int lcec_parse_config(void) {
           continue;
         }
 
-        // create new wd config
-        wd = lcec_zalloc(sizeof(lcec_slave_watchdog_t));
-        if (wd == NULL) {
-          rtapi_print_msg(RTAPI_MSG_ERR, LCEC_MSG_PFX "Unable to allocate slave %s.%s watchdog config memory\n", master->name, slave->name);
-          goto fail2;
-        }
-
-        // initialize wd conf
-        wd->divider = wd_conf->divider;
-        wd->intervals = wd_conf->intervals;
-
         // add to slave
-        slave->wd_conf = wd;
+        slave->wd_conf = wd_conf;
         break;
 
       case lcecConfTypeSyncManager:
         // get config token
-        sm_conf = (LCEC_CONF_SYNCMANAGER_T *)conf;
-        conf += sizeof(LCEC_CONF_SYNCMANAGER_T);
+        if ((sm_conf = lcec_conf_token(&conf, conf_end, sizeof(LCEC_CONF_SYNCMANAGER_T))) == NULL) {
+          goto fail2;
+        }
 
         // check for syncmanager
         if (generic_sync_managers == NULL) {
@@ -847,6 +1022,12 @@ int lcec_parse_config(void) {
           goto fail2;
         }
 
+        // check item counts
+        if (generic_sync_managers >= generic_sync_managers_end || sm_conf->pdoCount > (size_t) (generic_pdos_end - generic_pdos)) {
+          rtapi_print_msg(RTAPI_MSG_ERR, LCEC_MSG_PFX "Too many sync managers/PDOs for slave %s.%s\n", master->name, slave->name);
+          goto fail2;
+        }
+
         // initialize sync manager
         generic_sync_managers->index = sm_conf->index;
         generic_sync_managers->dir = sm_conf->dir;
@@ -872,8 +1053,9 @@ int lcec_parse_config(void) {
 
       case lcecConfTypePdo:
         // get config token
-        pdo_conf = (LCEC_CONF_PDO_T *)conf;
-        conf += sizeof(LCEC_CONF_PDO_T);
+        if ((pdo_conf = lcec_conf_token(&conf, conf_end, sizeof(LCEC_CONF_PDO_T))) == NULL) {
+          goto fail2;
+        }
 
         // check for pdos
         if (generic_pdos == NULL) {
@@ -887,6 +1069,12 @@ int lcec_parse_config(void) {
           goto fail2;
         }
 
+        // check item counts
+        if (generic_pdos >= generic_pdos_end || pdo_conf->pdoEntryCount > (size_t) (generic_pdo_entries_end - generic_pdo_entries)) {
+          rtapi_print_msg(RTAPI_MSG_ERR, LCEC_MSG_PFX "Too many PDOs/PDO entries for slave %s.%s\n", master->name, slave->name);
+          goto fail2;
+        }
+
         // initialize pdo
         generic_pdos->index = pdo_conf->index;
         generic_pdos->n_entries = pdo_conf->pdoEntryCount;
@@ -898,8 +1086,9 @@ int lcec_parse_config(void) {
 
       case lcecConfTypePdoEntry:
         // get config token
-        pe_conf = (LCEC_CONF_PDOENTRY_T *)conf;
-        conf += sizeof(LCEC_CONF_PDOENTRY_T);
+        if ((pe_conf = lcec_conf_token(&conf, conf_end, sizeof(LCEC_CONF_PDOENTRY_T))) == NULL) {
+          goto fail2;
+        }
 
         // check for pdos entries
         if (generic_pdo_entries == NULL) {
@@ -908,7 +1097,7 @@ int lcec_parse_config(void) {
         }
 
         // check for hal data
-        if (generic_hal_data == NULL) {
+        if (generic_pin_conf == NULL) {
           rtapi_print_msg(RTAPI_MSG_ERR, LCEC_MSG_PFX "HAL data for generic device missing\n");
           goto fail2;
         }
@@ -919,6 +1108,12 @@ int lcec_parse_config(void) {
           goto fail2;
         }
 
+        // check item counts
+        if (generic_pdo_entries >= generic_pdo_entries_end || (pe_conf->halPin[0] != 0 && generic_pin_conf >= generic_pin_conf_end)) {
+          rtapi_print_msg(RTAPI_MSG_ERR, LCEC_MSG_PFX "Too many PDO entries for slave %s.%s\n", master->name, slave->name);
+          goto fail2;
+        }
+
         // initialize pdo entry
         generic_pdo_entries->index = pe_conf->index;
         generic_pdo_entries->subindex = pe_conf->subindex;
@@ -926,18 +1121,18 @@ int lcec_parse_config(void) {
 
         // initialize hal data
         if (pe_conf->halPin[0] != 0) {
-          strncpy(generic_hal_data->name, pe_conf->halPin, LCEC_CONF_STR_MAXLEN);
-          generic_hal_data->name[LCEC_CONF_STR_MAXLEN - 1] = 0;
-          generic_hal_data->type = pe_conf->halType;
-          generic_hal_data->subType = pe_conf->subType;
-          generic_hal_data->floatScale = pe_conf->floatScale;
-          generic_hal_data->floatOffset = pe_conf->floatOffset;
-          generic_hal_data->bitOffset = 0;
-          generic_hal_data->bitLength = pe_conf->bitLength;
-          generic_hal_data->dir = generic_hal_dir;
-          generic_hal_data->pdo_idx = pe_conf->index;
-          generic_hal_data->pdo_sidx = pe_conf->subindex;
-          generic_hal_data++;
+          pe_conf->halPin[LCEC_CONF_STR_MAXLEN - 1] = 0;
+          generic_pin_conf->name = pe_conf->halPin;
+          generic_pin_conf->type = pe_conf->halType;
+          generic_pin_conf->subType = pe_conf->subType;
+          generic_pin_conf->floatScale = pe_conf->floatScale;
+          generic_pin_conf->floatOffset = pe_conf->floatOffset;
+          generic_pin_conf->bitOffset = 0;
+          generic_pin_conf->bitLength = pe_conf->bitLength;
+          generic_pin_conf->dir = generic_hal_dir;
+          generic_pin_conf->pdo_idx = pe_conf->index;
+          generic_pin_conf->pdo_sidx = pe_conf->subindex;
+          generic_pin_conf++;
         }
 
         // next pdo entry
@@ -946,8 +1141,9 @@ int lcec_parse_config(void) {
 
       case lcecConfTypeComplexEntry:
         // get config token
-        ce_conf = (LCEC_CONF_COMPLEXENTRY_T *)conf;
-        conf += sizeof(LCEC_CONF_COMPLEXENTRY_T);
+        if ((ce_conf = lcec_conf_token(&conf, conf_end, sizeof(LCEC_CONF_COMPLEXENTRY_T))) == NULL) {
+          goto fail2;
+        }
 
         // check for pdoEntry
         if (pe_conf == NULL) {
@@ -956,66 +1152,83 @@ int lcec_parse_config(void) {
         }
 
         // check for hal data
-        if (generic_hal_data == NULL) {
+        if (generic_pin_conf == NULL) {
           rtapi_print_msg(RTAPI_MSG_ERR, LCEC_MSG_PFX "HAL data for generic device missing\n");
           goto fail2;
         }
 
+        // check item counts
+        if (ce_conf->halPin[0] != 0 && generic_pin_conf >= generic_pin_conf_end) {
+          rtapi_print_msg(RTAPI_MSG_ERR, LCEC_MSG_PFX "Too many complex entries for slave %s.%s\n", master->name, slave->name);
+          goto fail2;
+        }
+
         // initialize hal data
         if (ce_conf->halPin[0] != 0) {
-          strncpy(generic_hal_data->name, ce_conf->halPin, LCEC_CONF_STR_MAXLEN);
-          generic_hal_data->name[LCEC_CONF_STR_MAXLEN - 1] = 0;
-          generic_hal_data->type = ce_conf->halType;
-          generic_hal_data->subType = ce_conf->subType;
-          generic_hal_data->floatScale = ce_conf->floatScale;
-          generic_hal_data->floatOffset = ce_conf->floatOffset;
-          generic_hal_data->bitOffset = ce_conf->bitOffset;
-          generic_hal_data->bitLength = ce_conf->bitLength;
-          generic_hal_data->dir = generic_hal_dir;
-          generic_hal_data->pdo_idx = pe_conf->index;
-          generic_hal_data->pdo_sidx = pe_conf->subindex;
-          generic_hal_data++;
+          ce_conf->halPin[LCEC_CONF_STR_MAXLEN - 1] = 0;
+          generic_pin_conf->name = ce_conf->halPin;
+          generic_pin_conf->type = ce_conf->halType;
+          generic_pin_conf->subType = ce_conf->subType;
+          generic_pin_conf->floatScale = ce_conf->floatScale;
+          generic_pin_conf->floatOffset = ce_conf->floatOffset;
+          generic_pin_conf->bitOffset = ce_conf->bitOffset;
+          generic_pin_conf->bitLength = ce_conf->bitLength;
+          generic_pin_conf->dir = generic_hal_dir;
+          generic_pin_conf->pdo_idx = pe_conf->index;
+          generic_pin_conf->pdo_sidx = pe_conf->subindex;
+          generic_pin_conf++;
         }
         break;
 
       case lcecConfTypeSdoConfig:
         // get config token
-        sdo_conf = (LCEC_CONF_SDOCONF_T *)conf;
-        conf += sizeof(LCEC_CONF_SDOCONF_T) + sdo_conf->length;
-
-        // copy attributes
-        sdo_config->index = sdo_conf->index;
-        sdo_config->subindex = sdo_conf->subindex;
-        sdo_config->length = sdo_conf->length;
+        if ((sdo_conf = lcec_conf_token(&conf, conf_end, sizeof(LCEC_CONF_SDOCONF_T))) == NULL ||
+            lcec_conf_token(&conf, conf_end, sdo_conf->length) == NULL) {
+          goto fail2;
+        }
 
-        // copy data
-        memcpy(sdo_config->data, sdo_conf->data, sdo_config->length);
+        // check for slave
+        if (slave == NULL) {
+          rtapi_print_msg(RTAPI_MSG_ERR, LCEC_MSG_PFX "Slave node for sdo config missing\n");
+          goto fail2;
+        }
 
-        sdo_config = (lcec_slave_sdoconf_t *) &sdo_config->data[sdo_config->length];
-        sdo_config->index = 0xffff;
+        // reference first token, the others must follow it
+        if (slave->sdo_config == NULL) {
+          slave->sdo_config = sdo_conf;
+        } else if (prev_conf_type != lcecConfTypeSdoConfig) {
+          rtapi_print_msg(RTAPI_MSG_ERR, LCEC_MSG_PFX "SDO configs for slave %s.%s not grouped\n", master->name, slave->name);
+          goto fail2;
+        }
         break;
 
       case lcecConfTypeIdnConfig:
         // get config token
-        idn_conf = (LCEC_CONF_IDNCONF_T *)conf;
-        conf += sizeof(LCEC_CONF_IDNCONF_T) + idn_conf->length;
-
-        // copy attributes
-        idn_config->drive = idn_conf->drive;
-        idn_config->idn = idn_conf->idn;
-        idn_config->state = idn_conf->state;
-        idn_config->length = idn_conf->length;
+        if ((idn_conf = lcec_conf_token(&conf, conf_end, sizeof(LCEC_CONF_IDNCONF_T))) == NULL ||
+            lcec_conf_token(&conf, conf_end, idn_conf->length) == NULL) {
+          goto fail2;
+        }
 
-        // copy data
-        memcpy(idn_config->data, idn_conf->data, idn_config->length);
+        // check for slave
+        if (slave == NULL) {
+          rtapi_print_msg(RTAPI_MSG_ERR, LCEC_MSG_PFX "Slave node for idn config missing\n");
+          goto fail2;
+        }
 
-        idn_config = (lcec_slave_idnconf_t *) &idn_config->data[idn_config->length];
+        // reference first token, the others must follow it
+        if (slave->idn_config == NULL) {
+          slave->idn_config = idn_conf;
+        } else if (prev_conf_type != lcecConfTypeIdnConfig) {
+          rtapi_print_msg(RTAPI_MSG_ERR, LCEC_MSG_PFX "IDN configs for slave %s.%s not grouped\n", master->name, slave->name);
+          goto fail2;
+        }
         break;
 
       case lcecConfTypeModParam:
         // get config token
-        modparam_conf = (LCEC_CONF_MODPARAM_T *)conf;
-        conf += sizeof(LCEC_CONF_MODPARAM_T);
+        if ((modparam_conf = lcec_conf_token(&conf, conf_end, sizeof(LCEC_CONF_MODPARAM_T))) == NULL) {
+          goto fail2;
+        }
 
         // check for slave
         if (slave == NULL) {
@@ -1023,12 +1236,20 @@ int lcec_parse_config(void) {
           goto fail2;
         }
 
-        // copy attributes
-        modparams->id = modparam_conf->id;
-        modparams->value = modparam_conf->value;
+        // check item count
+        if (modparam_count >= modparam_max) {
+          rtapi_print_msg(RTAPI_MSG_ERR, LCEC_MSG_PFX "Too many modparams for slave %s.%s\n", master->name, slave->name);
+          goto fail2;
+        }
 
-        // next entry
-        modparams++;
+        // reference first token, the others must follow it
+        if (slave->modparams == NULL) {
+          slave->modparams = modparam_conf;
+        } else if (prev_conf_type != lcecConfTypeModParam) {
+          rtapi_print_msg(RTAPI_MSG_ERR, LCEC_MSG_PFX "Modparams for slave %s.%s not grouped\n", master->name, slave->name);
+          goto fail2;
+        }
+        modparam_count++;
         break;
 
       default:
@@ -1037,23 +1258,34 @@ int lcec_parse_config(void) {
     }
   }
 
-  // close shmem
-  rtapi_shmem_delete(shmem_id, comp_id);
-
   // allocate PDO entity memory
   for (master = first_master; master != NULL; master = master->next) {
-    pdo_entry_regs = lcec_zalloc(sizeof(ec_pdo_entry_reg_t) * (master->pdo_entry_count + 1));
+    pdo_entry_regs = lcec_zalloc(sizeof(ec_pdo_entry_reg_t) * (master->pdo_entry_count + master->last_domain->index + 1));
     if (pdo_entry_regs == NULL) {
       rtapi_print_msg(RTAPI_MSG_ERR, LCEC_MSG_PFX "Unable to allocate master %s PDO entry memory\n", master->name);
       goto fail2;
     }
     master->pdo_entry_regs = pdo_entry_regs;
+
+    // split into zero terminated lists per domain
+    for (domain = master->first_domain; domain != NULL; domain = domain->next) {
+      domain->pdo_entry_regs = pdo_entry_regs;
+      pdo_entry_regs += domain->pdo_entry_count + 1;
+      domain->pdo_entry_count = 0;
+    }
+    for (slave = master->first_slave; slave != NULL; slave = slave->next) {
+      slave->pdo_entry_regs = slave->domain->pdo_entry_regs + slave->domain->pdo_entry_count;
+      slave->domain->pdo_entry_count += slave->pdo_entry_count;
+    }
   }
 
   return slave_count;
 
 fail2:
+  // also releases the config
   lcec_clear_config();
+  return -1;
+
 fail1:
   rtapi_shmem_delete(shmem_id, comp_id);
 fail0:
@@ -1062,6 +1294,7 @@ fail0:
 
 void lcec_clear_config(void) {
   lcec_master_t *master, *prev_master;
+  lcec_domain_t *domain, *prev_domain;
   lcec_slave_t *slave, *prev_slave;
 
   // iterate all masters
@@ -1069,6 +1302,9 @@ void lcec_clear_config(void) {
   while (master != NULL) {
     prev_master = master->prev;
 
+    // stop helper thread, it may still be working on the slaves
+    lcec_stop_master_thread(master);
+
     // iterate all masters
     slave = master->last_slave;
     while (slave != NULL) {
@@ -1079,35 +1315,23 @@ void lcec_clear_config(void) {
         slave->proc_cleanup(slave);
       }
 
-      // free slave
-      if (slave->modparams != NULL) {
-        lcec_free(slave->modparams);
-      }
-      if (slave->sdo_config != NULL) {
-        lcec_free(slave->sdo_config);
-      }
-      if (slave->idn_config != NULL) {
-        lcec_free(slave->idn_config);
-      }
-      if (slave->generic_pdo_entries != NULL) {
-        lcec_free(slave->generic_pdo_entries);
-      }
-      if (slave->generic_pdos != NULL) {
-        lcec_free(slave->generic_pdos);
-      }
+      // free slave, generic pdos and pdo entries share the sync manager block
       if (slave->generic_sync_managers != NULL) {
         lcec_free(slave->generic_sync_managers);
       }
-      if (slave->dc_conf != NULL) {
-        lcec_free(slave->dc_conf);
-      }
-      if (slave->wd_conf != NULL) {
-        lcec_free(slave->wd_conf);
+      if (slave->generic_pin_conf != NULL) {
+        lcec_free(slave->generic_pin_conf);
       }
       lcec_free(slave);
       slave = prev_slave;
     }
 
+    // remove process image tap
+    lcec_tap_cleanup(comp_id, master);
+
+    // remove process data recorder
+    lcec_rec_cleanup(comp_id, master);
+
     // release master
     if (master->master) {
       ecrt_release_master(master->master);
@@ -1118,68 +1342,697 @@ void lcec_clear_config(void) {
       lcec_free(master->pdo_entry_regs);
     }
 
+    // free domains
+    domain = master->last_domain;
+    while (domain != NULL) {
+      prev_domain = domain->prev;
+      if (domain->read_funcs != NULL) {
+        lcec_free(domain->read_funcs);
+      }
+      if (domain->write_funcs != NULL) {
+        lcec_free(domain->write_funcs);
+      }
+      if (domain->out_ranges != NULL) {
+        lcec_free(domain->out_ranges);
+      }
+      if (domain->out_data != NULL) {
+        lcec_free(domain->out_data);
+      }
+      lcec_free(domain);
+      domain = prev_domain;
+    }
+    if (master->domain_mem != NULL) {
+      lcec_free(master->domain_mem);
+    }
+
     // free master
     lcec_free(master);
     master = prev_master;
   }
-}
-
-void lcec_request_lock(void *data) {
-  lcec_master_t *master = (lcec_master_t *) data;
-  rtapi_mutex_get(&master->mutex);
-}
 
-void lcec_release_lock(void *data) {
-  lcec_master_t *master = (lcec_master_t *) data;
-  rtapi_mutex_give(&master->mutex);
+  // release config referenced by the slaves
+  if (conf_shmem_id >= 0) {
+    conf_header->inUse = 0;
+    rtapi_shmem_delete(conf_shmem_id, comp_id);
+    conf_shmem_id = -1;
+    conf_header = NULL;
+  }
+  if (conf_copy != NULL) {
+    lcec_free(conf_copy);
+    conf_copy = NULL;
+  }
 }
 
-lcec_master_data_t *lcec_init_master_hal(const char *pfx, int global) {
-  lcec_master_data_t *hal_data;
+lcec_domain_t *lcec_add_domain(lcec_master_t *master, const char *name, int cycle_divider) {
+  lcec_domain_t *domain;
 
-  // alloc hal data
-  if ((hal_data = hal_malloc(sizeof(lcec_master_data_t))) == NULL) {
-    rtapi_print_msg(RTAPI_MSG_ERR, LCEC_MSG_PFX "hal_malloc() for %s failed\n", pfx);
+  // alloc domain memory
+  domain = lcec_zalloc(sizeof(lcec_domain_t));
+  if (domain == NULL) {
+    rtapi_print_msg(RTAPI_MSG_ERR, LCEC_MSG_PFX "Unable to allocate domain %s.%s structure memory\n", master->name, name);
     return NULL;
   }
-  memset(hal_data, 0, sizeof(lcec_master_data_t));
 
-  // export pins
-  if (lcec_pin_newf_list(hal_data, master_global_pins, pfx) != 0) {
-    return NULL;
-  }
-  if (!global) {
-    if (lcec_pin_newf_list(hal_data, master_pins, pfx) != 0) {
-      return NULL;
-    }
-    if (lcec_param_newf_list(hal_data, master_params, pfx) != 0) {
-      return NULL;
+  // initialize domain
+  domain->master = master;
+  domain->index = (master->last_domain != NULL) ? master->last_domain->index + 1 : 0;
+  strncpy(domain->name, name, LCEC_CONF_STR_MAXLEN);
+  domain->name[LCEC_CONF_STR_MAXLEN - 1] = 0;
+  domain->cycle_divider = cycle_divider;
+
+  // add domain to list
+  LCEC_LIST_APPEND(master->first_domain, master->last_domain, domain);
+  return domain;
+}
+
+lcec_domain_t *lcec_domain_by_name(lcec_master_t *master, const char *name) {
+  lcec_domain_t *domain;
+
+  for (domain = master->first_domain; domain != NULL; domain = domain->next) {
+    if (strcmp(domain->name, name) == 0) {
+      return domain;
     }
   }
 
-  return hal_data;
+  return NULL;
 }
 
-lcec_slave_state_t *lcec_init_slave_state_hal(char *master_name, char *slave_name) {
-  lcec_slave_state_t *hal_data;
+#ifdef __KERNEL__
+int lcec_alloc_domain_mem(lcec_master_t *master) {
+  lcec_domain_t *domain;
+  size_t size;
+
+  // get overall size
+  size = 0;
+  for (domain = master->first_domain; domain != NULL; domain = domain->next) {
+    size += ecrt_domain_size(domain->domain);
+  }
+  if (size == 0) {
+    return 0;
+  }
 
-  // alloc hal data
-  if ((hal_data = hal_malloc(sizeof(lcec_slave_state_t))) == NULL) {
-    rtapi_print_msg(RTAPI_MSG_ERR, LCEC_MSG_PFX "hal_malloc() for %s.%s.%s failed\n", LCEC_MODULE_NAME, master_name, slave_name);
-    return NULL;
+  // alloc memory
+  master->domain_mem = lcec_zalloc(size);
+  if (master->domain_mem == NULL) {
+    rtapi_print_msg(RTAPI_MSG_ERR, LCEC_MSG_PFX "Unable to allocate master %s domain memory\n", master->name);
+    return -1;
   }
-  memset(hal_data, 0, sizeof(lcec_slave_state_t));
 
-  // export pins
-  if (lcec_pin_newf_list(hal_data, slave_pins, LCEC_MODULE_NAME, master_name, slave_name) != 0) {
-    return NULL;
+  // assign memory to domains
+  size = 0;
+  for (domain = master->first_domain; domain != NULL; domain = domain->next) {
+    ecrt_domain_external_memory(domain->domain, master->domain_mem + size);
+    size += ecrt_domain_size(domain->domain);
   }
 
-  return hal_data;
+  return 0;
 }
+#endif
 
-void lcec_update_master_hal(lcec_master_data_t *hal_data, ec_master_state_t *ms) {
-  *(hal_data->slaves_responding) = ms->slaves_responding;
+void lcec_setup_domain_data(lcec_master_t *master) {
+  lcec_domain_t *domain;
+  ec_pdo_entry_reg_t *reg;
+  uint8_t *end;
+  unsigned int delta;
+  int i;
+
+  // get domain data and process data range
+  master->process_data = NULL;
+  end = NULL;
+  for (domain = master->first_domain; domain != NULL; domain = domain->next) {
+    domain->process_data = ecrt_domain_data(domain->domain);
+    domain->process_data_len = ecrt_domain_size(domain->domain);
+    if (domain->process_data == NULL || domain->process_data_len <= 0) {
+      continue;
+    }
+    if (master->process_data == NULL || domain->process_data < master->process_data) {
+      master->process_data = domain->process_data;
+    }
+    if (end == NULL || domain->process_data + domain->process_data_len > end) {
+      end = domain->process_data + domain->process_data_len;
+    }
+  }
+  master->process_data_len = end - master->process_data;
+
+  // domain offsets are relative to domain data, rebase
+  // them to master->process_data used by the drivers
+  for (domain = master->first_domain; domain != NULL; domain = domain->next) {
+    if (domain->process_data == NULL || domain->process_data_len <= 0) {
+      continue;
+    }
+    delta = domain->process_data - master->process_data;
+    if (delta == 0) {
+      continue;
+    }
+    for (i = 0, reg = domain->pdo_entry_regs; i < domain->pdo_entry_count; i++, reg++) {
+      if (reg->offset != NULL) {
+        *(reg->offset) += delta;
+      }
+    }
+  }
+}
+
+int lcec_find_pdo_entry_info(lcec_slave_t *slave, uint16_t index, uint8_t subindex, ec_direction_t *dir, unsigned int *bit_length) {
+  const ec_sync_info_t *sync;
+  const ec_pdo_info_t *pdo;
+  const ec_pdo_entry_info_t *entry;
+#ifndef __KERNEL__
+  ec_slave_info_t slave_info;
+  ec_sync_info_t sync_info;
+  ec_pdo_info_t pdo_info;
+  ec_pdo_entry_info_t entry_info;
+#endif
+  unsigned int i, j, k;
+
+  // PDO mapping configured by the driver
+  if (slave->sync_info != NULL) {
+    for (sync = slave->sync_info; sync->index != 0xff; sync++) {
+      for (i = 0, pdo = sync->pdos; pdo != NULL && i < sync->n_pdos; i++, pdo++) {
+        for (j = 0, entry = pdo->entries; entry != NULL && j < pdo->n_entries; j++, entry++) {
+          if (entry->index == index && entry->subindex == subindex) {
+            *dir = sync->dir;
+            *bit_length = entry->bit_length;
+            return 0;
+          }
+        }
+      }
+    }
+  }
+
+#ifndef __KERNEL__
+  // default mapping of the slave, as scanned by the master
+  if (ecrt_master_get_slave(slave->master->master, slave->index, &slave_info) != 0) {
+    return -ENOENT;
+  }
+  for (i = 0; i < slave_info.sync_count; i++) {
+    if (ecrt_master_get_sync_manager(slave->master->master, slave->index, i, &sync_info) != 0) {
+      continue;
+    }
+    for (j = 0; j < sync_info.n_pdos; j++) {
+      if (ecrt_master_get_pdo(slave->master->master, slave->index, i, j, &pdo_info) != 0) {
+        continue;
+      }
+      for (k = 0; k < pdo_info.n_entries; k++) {
+        if (ecrt_master_get_pdo_entry(slave->master->master, slave->index, i, j, k, &entry_info) != 0) {
+          continue;
+        }
+        if (entry_info.index == index && entry_info.subindex == subindex) {
+          *dir = sync_info.dir;
+          *bit_length = entry_info.bit_length;
+          return 0;
+        }
+      }
+    }
+  }
+#endif
+
+  return -ENOENT;
+}
+
+int lcec_next_entry_offset(lcec_master_t *master, lcec_domain_t *domain, int offset) {
+  ec_pdo_entry_reg_t *reg;
+  int i, next;
+
+  // end of domain data if there is no further entry
+  next = (domain->process_data - master->process_data) + domain->process_data_len;
+  for (i = 0, reg = domain->pdo_entry_regs; i < domain->pdo_entry_count; i++, reg++) {
+    if (reg->index != 0 && reg->offset != NULL && (int) *(reg->offset) > offset && (int) *(reg->offset) < next) {
+      next = *(reg->offset);
+    }
+  }
+
+  return next;
+}
+
+int lcec_init_output_ranges(lcec_master_t *master) {
+  lcec_domain_t *domain;
+  lcec_slave_t *slave;
+  ec_pdo_entry_reg_t *reg;
+  lcec_domain_range_t *range;
+  ec_direction_t dir;
+  unsigned int bit_length;
+  uint8_t *mask;
+  int i, base, start, end, len, warned;
+
+  if (master->process_data_len <= 0) {
+    return 0;
+  }
+
+  // mark the bytes of all output entries (offsets are relative to master->process_data)
+  mask = lcec_zalloc(master->process_data_len);
+  if (mask == NULL) {
+    rtapi_print_msg(RTAPI_MSG_ERR, LCEC_MSG_PFX "Unable to allocate master %s output mask memory\n", master->name);
+    return -1;
+  }
+  for (slave = master->first_slave; slave != NULL; slave = slave->next) {
+    warned = 0;
+    for (i = 0, reg = slave->pdo_entry_regs; i < slave->pdo_entry_count; i++, reg++) {
+      if (reg->index == 0 || reg->offset == NULL) {
+        continue;
+      }
+      start = *(reg->offset);
+      if (lcec_find_pdo_entry_info(slave, reg->index, reg->subindex, &dir, &bit_length) == 0) {
+        if (dir != EC_DIR_OUTPUT) {
+          continue;
+        }
+        end = start + ((reg->bit_position != NULL ? *(reg->bit_position) : 0) + bit_length + 7) / 8;
+      } else {
+        // no mapping (slave offline on startup or kernel build):
+        // CoE inputs are left alone, anything else is kept like an
+        // output up to the next registered entry
+        if ((reg->index & 0xf000) == 0x6000) {
+          continue;
+        }
+        if (!warned) {
+          rtapi_print_msg(RTAPI_MSG_WARN, LCEC_MSG_PFX "send first: no PDO mapping for slave %s.%s, entries handled as outputs\n", master->name, slave->name);
+          warned = 1;
+        }
+        end = (reg->bit_position != NULL) ? start + 1 : lcec_next_entry_offset(master, slave->domain, start);
+      }
+      if (end > master->process_data_len) {
+        end = master->process_data_len;
+      }
+      for (; start < end; start++) {
+        mask[start] = 1;
+      }
+    }
+  }
+
+  // collect the marked bytes of each domain in ranges
+  for (domain = master->first_domain; domain != NULL; domain = domain->next) {
+    if (domain->process_data == NULL || domain->process_data_len <= 0) {
+      continue;
+    }
+    base = domain->process_data - master->process_data;
+    for (i = 0; i < domain->process_data_len; i++) {
+      if (mask[base + i] && (i == 0 || !mask[base + i - 1])) {
+        domain->out_range_count++;
+      }
+    }
+    if (domain->out_range_count == 0) {
+      continue;
+    }
+
+    domain->out_ranges = lcec_zalloc(sizeof(lcec_domain_range_t) * domain->out_range_count);
+    if (domain->out_ranges == NULL) {
+      rtapi_print_msg(RTAPI_MSG_ERR, LCEC_MSG_PFX "Unable to allocate master %s output range memory\n", master->name);
+      lcec_free(mask);
+      return -1;
+    }
+    range = domain->out_ranges;
+    len = 0;
+    for (i = 0; i < domain->process_data_len; i++) {
+      if (!mask[base + i]) {
+        continue;
+      }
+      if (i == 0 || !mask[base + i - 1]) {
+        range->offset = i;
+        range->length = 0;
+        range++;
+      }
+      (range - 1)->length++;
+      len++;
+    }
+
+    domain->out_data = lcec_zalloc(len);
+    if (domain->out_data == NULL) {
+      rtapi_print_msg(RTAPI_MSG_ERR, LCEC_MSG_PFX "Unable to allocate master %s output save memory\n", master->name);
+      lcec_free(mask);
+      return -1;
+    }
+  }
+
+  lcec_free(mask);
+  return 0;
+}
+
+int lcec_init_domain_funcs(lcec_master_t *master) {
+  lcec_domain_t *domain;
+  lcec_slave_t *slave;
+
+  // count slaves with callbacks
+  for (slave = master->first_slave; slave != NULL; slave = slave->next) {
+    if (slave->proc_read != NULL) {
+      slave->domain->read_func_count++;
+    }
+    if (slave->proc_write != NULL) {
+      slave->domain->write_func_count++;
+    }
+  }
+
+  // alloc tables
+  for (domain = master->first_domain; domain != NULL; domain = domain->next) {
+    if (domain->read_func_count > 0) {
+      domain->read_funcs = lcec_zalloc(sizeof(lcec_slave_func_t) * domain->read_func_count);
+      if (domain->read_funcs == NULL) {
+        rtapi_print_msg(RTAPI_MSG_ERR, LCEC_MSG_PFX "Unable to allocate master %s read function memory\n", master->name);
+        return -1;
+      }
+    }
+    if (domain->write_func_count > 0) {
+      domain->write_funcs = lcec_zalloc(sizeof(lcec_slave_func_t) * domain->write_func_count);
+      if (domain->write_funcs == NULL) {
+        rtapi_print_msg(RTAPI_MSG_ERR, LCEC_MSG_PFX "Unable to allocate master %s write function memory\n", master->name);
+        return -1;
+      }
+    }
+    domain->read_func_count = 0;
+    domain->write_func_count = 0;
+  }
+
+  // fill tables in slave order
+  for (slave = master->first_slave; slave != NULL; slave = slave->next) {
+    domain = slave->domain;
+    if (slave->proc_read != NULL) {
+      domain->read_funcs[domain->read_func_count].proc = slave->proc_read;
+      domain->read_funcs[domain->read_func_count].slave = slave;
+      domain->read_func_count++;
+    }
+    if (slave->proc_write != NULL) {
+      domain->write_funcs[domain->write_func_count].proc = slave->proc_write;
+      domain->write_funcs[domain->write_func_count].slave = slave;
+      domain->write_func_count++;
+    }
+  }
+
+  return 0;
+}
+
+int lcec_start_master_thread(lcec_master_t *master) {
+  lcec_master_thread_t *thread;
+
+  // alloc thread data
+  thread = lcec_zalloc(sizeof(lcec_master_thread_t));
+  if (thread == NULL) {
+    rtapi_print_msg(RTAPI_MSG_ERR, LCEC_MSG_PFX "Unable to allocate master %s thread memory\n", master->name);
+    return -1;
+  }
+
+  // start thread
+  if (lcec_thread_create(&thread->thread, lcec_master_thread, master, master->thread_cpu) != 0) {
+    rtapi_print_msg(RTAPI_MSG_ERR, LCEC_MSG_PFX "failed to start thread for master %s on cpu %d\n", master->name, master->thread_cpu);
+    lcec_free(thread);
+    return -1;
+  }
+
+  lcec_atomic_store(&master->thread, thread);
+  return 0;
+}
+
+void lcec_stop_master_thread(lcec_master_t *master) {
+  lcec_master_thread_t *thread = master->thread;
+
+  if (thread == NULL) {
+    return;
+  }
+
+  lcec_atomic_store(&thread->stop, 1);
+  lcec_wake_master_thread(thread);
+  lcec_thread_join(thread->thread);
+  master->thread = NULL;
+  lcec_free(thread);
+}
+
+void lcec_wake_master_thread(lcec_master_thread_t *thread) {
+  // the helper reads wake_seq before it checks for work and
+  // sleeps only as long as wake_seq is unchanged
+  lcec_atomic_store(&thread->wake_seq, thread->wake_seq + 1);
+  lcec_mb();
+  if (lcec_atomic_load(&thread->sleeping)) {
+    lcec_futex_wake(&thread->wake_seq);
+  }
+}
+
+void *lcec_master_thread(void *arg) {
+  lcec_master_t *master = (lcec_master_t *) arg;
+  lcec_master_thread_t *thread = master->thread;
+  unsigned int request, wake_seq;
+  long long spin_start;
+  int spinning;
+
+  // thread may start before master->thread is set
+  while (thread == NULL) {
+    lcec_cpu_relax();
+    thread = lcec_atomic_load(&master->thread);
+  }
+
+  // busy wait for requests for up to one period of the calling
+  // thread, sleep if none comes in (HAL thread stopped)
+  request = 0;
+  spinning = 0;
+  spin_start = 0;
+  while (!lcec_atomic_load(&thread->stop)) {
+    if (lcec_atomic_load(&thread->request) == request) {
+      if (!spinning) {
+        spinning = 1;
+        spin_start = rtapi_get_time();
+      }
+      if (rtapi_get_time() - spin_start < thread->period) {
+        lcec_cpu_relax();
+        continue;
+      }
+
+      lcec_atomic_store(&thread->sleeping, 1);
+      lcec_mb();
+      wake_seq = lcec_atomic_load(&thread->wake_seq);
+      if (lcec_atomic_load(&thread->request) == request && !lcec_atomic_load(&thread->stop)) {
+        lcec_futex_wait(&thread->wake_seq, wake_seq);
+      }
+      lcec_atomic_store(&thread->sleeping, 0);
+      spinning = 0;
+      continue;
+    }
+
+    spinning = 0;
+    request++;
+    thread->funct(master, thread->period);
+    lcec_atomic_store(&thread->done, request);
+  }
+
+  return NULL;
+}
+
+void lcec_run_all(void (*funct) (void *arg, long period), long period) {
+  lcec_master_t *master;
+  lcec_master_thread_t *thread;
+  long long t_start;
+  int cpu;
+
+  t_start = rtapi_get_time();
+
+  // start masters with helper thread. A helper on the cpu of the
+  // calling thread would never run while that one waits for it,
+  // process these masters in this thread instead.
+  cpu = lcec_get_cpu();
+  for (master = first_master; master != NULL; master = master->next) {
+    thread = master->thread;
+    if (thread == NULL) {
+      continue;
+    }
+    thread->inline_run = (master->thread_cpu == cpu);
+    if (thread->inline_run) {
+      if (!thread->cpu_warned) {
+        rtapi_print_msg(RTAPI_MSG_ERR, LCEC_MSG_PFX "threadCpu %d of master %s is the cpu of the calling HAL thread, not using helper thread\n", master->thread_cpu, master->name);
+        thread->cpu_warned = 1;
+      }
+      continue;
+    }
+    // helper still busy with an earlier request, skip this master
+    thread->busy = (lcec_atomic_load(&thread->done) != thread->request);
+    if (thread->busy) {
+      (*(master->hal_data->thread_overruns))++;
+      continue;
+    }
+    thread->funct = funct;
+    thread->period = period;
+    lcec_atomic_store(&thread->request, thread->request + 1);
+    lcec_wake_master_thread(thread);
+  }
+
+  // process other masters in this thread
+  for (master = first_master; master != NULL; master = master->next) {
+    thread = master->thread;
+    if (thread == NULL || thread->inline_run) {
+      funct(master, period);
+    }
+  }
+
+  // wait for helper threads, but not longer than one period
+  for (master = first_master; master != NULL; master = master->next) {
+    thread = master->thread;
+    if (thread == NULL || thread->inline_run || thread->busy) {
+      continue;
+    }
+    while (lcec_atomic_load(&thread->done) != thread->request) {
+      if (rtapi_get_time() - t_start > period) {
+        (*(master->hal_data->thread_overruns))++;
+        break;
+      }
+      lcec_cpu_relax();
+    }
+  }
+}
+
+void lcec_request_lock(void *data) {
+  lcec_master_t *master = (lcec_master_t *) data;
+  rtapi_mutex_get(&master->mutex);
+}
+
+void lcec_release_lock(void *data) {
+  lcec_master_t *master = (lcec_master_t *) data;
+  rtapi_mutex_give(&master->mutex);
+}
+
+lcec_master_data_t *lcec_init_master_hal(const char *pfx, int global) {
+  lcec_master_data_t *hal_data;
+
+  // alloc hal data
+  if ((hal_data = hal_malloc(sizeof(lcec_master_data_t))) == NULL) {
+    rtapi_print_msg(RTAPI_MSG_ERR, LCEC_MSG_PFX "hal_malloc() for %s failed\n", pfx);
+    return NULL;
+  }
+  memset(hal_data, 0, sizeof(lcec_master_data_t));
+
+  // export pins
+  if (lcec_pin_newf_list(hal_data, master_global_pins, pfx) != 0) {
+    return NULL;
+  }
+  if (!global) {
+    if (lcec_pin_newf_list(hal_data, master_pins, pfx) != 0) {
+      return NULL;
+    }
+    if (lcec_param_newf_list(hal_data, master_params, pfx) != 0) {
+      return NULL;
+    }
+    if (lcec_init_timing_hal(hal_data, pfx) != 0) {
+      return NULL;
+    }
+  }
+
+  return hal_data;
+}
+
+int lcec_init_timing_hal(lcec_master_data_t *hal_data, const char *pfx) {
+  lcec_timing_data_t *timing;
+  int i, j;
+  int err;
+
+  for (i = 0, timing = hal_data->timing; i < lcecTimingCount; i++, timing++) {
+    // export pins
+    if ((err = lcec_pin_newf_list(timing, timing_pins, pfx, timing_names[i])) != 0) {
+      return err;
+    }
+
+    // export histogram
+    for (j = 0; j < LCEC_TIMING_HIST_BUCKETS; j++) {
+      if ((err = lcec_param_newf(HAL_U32, HAL_RO, (void *) &timing->hist[j], "%s.time-%s-hist-%d", pfx, timing_names[i], j)) != 0) {
+        return err;
+      }
+    }
+  }
+
+  lcec_reset_timing_hal(hal_data);
+  return 0;
+}
+
+void lcec_reset_timing_hal(lcec_master_data_t *hal_data) {
+  lcec_timing_data_t *timing;
+  int i, j;
+
+  for (i = 0, timing = hal_data->timing; i < lcecTimingCount; i++, timing++) {
+    *(timing->last) = 0;
+    *(timing->min) = 0;
+    *(timing->max) = 0;
+    *(timing->avg) = 0;
+    for (j = 0; j < LCEC_TIMING_HIST_BUCKETS; j++) {
+      timing->hist[j] = 0;
+    }
+    timing->avg_acc = 0;
+    timing->valid = 0;
+  }
+}
+
+void lcec_update_timing_hal(lcec_master_data_t *hal_data, LCEC_TIMING_PHASE_T phase, long long t) {
+  lcec_timing_data_t *timing = &hal_data->timing[phase];
+  hal_u32_t val;
+  int bucket;
+
+  // clamp to pin range
+  if (t < 0) {
+    t = 0;
+  }
+  if (t > 0xffffffffLL) {
+    t = 0xffffffffLL;
+  }
+  val = t;
+
+  *(timing->last) = val;
+
+  // first sample after reset initializes the statistics
+  if (!timing->valid) {
+    *(timing->min) = val;
+    *(timing->max) = val;
+    timing->avg_acc = t << LCEC_TIMING_AVG_SHIFT;
+    timing->valid = 1;
+  }
+
+  if (val < *(timing->min)) {
+    *(timing->min) = val;
+  }
+  if (val > *(timing->max)) {
+    *(timing->max) = val;
+  }
+
+  // rolling average over 2^LCEC_TIMING_AVG_SHIFT samples
+  timing->avg_acc += t - (timing->avg_acc >> LCEC_TIMING_AVG_SHIFT);
+  *(timing->avg) = timing->avg_acc >> LCEC_TIMING_AVG_SHIFT;
+
+  // log2 histogram
+  for (bucket = 0; bucket < (LCEC_TIMING_HIST_BUCKETS - 1) && t >= (1LL << (bucket + LCEC_TIMING_HIST_SHIFT)); bucket++);
+  timing->hist[bucket]++;
+}
+
+lcec_domain_data_t *lcec_init_domain_hal(const char *pfx) {
+  lcec_domain_data_t *hal_data;
+
+  // alloc hal data
+  if ((hal_data = hal_malloc(sizeof(lcec_domain_data_t))) == NULL) {
+    rtapi_print_msg(RTAPI_MSG_ERR, LCEC_MSG_PFX "hal_malloc() for %s failed\n", pfx);
+    return NULL;
+  }
+  memset(hal_data, 0, sizeof(lcec_domain_data_t));
+
+  // export pins
+  if (lcec_pin_newf_list(hal_data, domain_pins, pfx) != 0) {
+    return NULL;
+  }
+  if (lcec_param_newf_list(hal_data, domain_params, pfx) != 0) {
+    return NULL;
+  }
+
+  return hal_data;
+}
+
+lcec_slave_state_t *lcec_init_slave_state_hal(char *master_name, char *slave_name) {
+  lcec_slave_state_t *hal_data;
+
+  // alloc hal data
+  if ((hal_data = hal_malloc(sizeof(lcec_slave_state_t))) == NULL) {
+    rtapi_print_msg(RTAPI_MSG_ERR, LCEC_MSG_PFX "hal_malloc() for %s.%s.%s failed\n", LCEC_MODULE_NAME, master_name, slave_name);
+    return NULL;
+  }
+  memset(hal_data, 0, sizeof(lcec_slave_state_t));
+
+  // export pins
+  if (lcec_pin_newf_list(hal_data, slave_pins, LCEC_MODULE_NAME, master_name, slave_name) != 0) {
+    return NULL;
+  }
+
+  return hal_data;
+}
+
+void lcec_update_master_hal(lcec_master_data_t *hal_data, ec_master_state_t *ms) {
+  *(hal_data->slaves_responding) = ms->slaves_responding;
   *(hal_data->state_init) = (ms->al_states & 0x01) != 0;
   *(hal_data->state_preop) = (ms->al_states & 0x02) != 0;
   *(hal_data->state_safeop) = (ms->al_states & 0x04) != 0;
@@ -1188,6 +2041,52 @@ void lcec_update_master_hal(lcec_master_data_t *hal_data, ec_master_state_t *ms)
   *(hal_data->all_op) = (ms->al_states == 0x08);
 }
 
+void lcec_update_domain_hal(lcec_domain_data_t *hal_data, ec_domain_state_t *ds) {
+  *(hal_data->wc_actual) = ds->working_counter;
+  *(hal_data->wc_state) = ds->wc_state;
+
+  // all registered process data exchanged
+  if (ds->wc_state == EC_WC_COMPLETE) {
+    *(hal_data->wc_expected) = ds->working_counter;
+    *(hal_data->wc_valid) = 1;
+    *(hal_data->wc_bad_cycles) = 0;
+    return;
+  }
+
+  *(hal_data->wc_valid) = 0;
+  (*(hal_data->wc_bad_cycles))++;
+  if (ds->wc_state == EC_WC_ZERO) {
+    (*(hal_data->wc_lost_frames))++;
+  }
+}
+
+void lcec_update_state_poll_count(lcec_master_t *master, long period) {
+  master->state_poll_count = 0;
+  master->state_poll_rate = 0;
+  master->state_poll_credit = 0;
+
+  // no slaves, nothing to poll
+  if (master->slave_count == 0) {
+    return;
+  }
+
+  if (master->state_poll_conf > 0) {
+    // use configured value in every cycle
+    master->state_poll_count = master->state_poll_conf;
+    if (master->state_poll_count > master->slave_count) {
+      master->state_poll_count = master->slave_count;
+    }
+  } else {
+    // cover all slaves within one state update period,
+    // lcec_receive_master spreads the polls over the cycles
+    master->state_poll_rate = (long long) master->slave_count * period;
+  }
+
+  if (master->state_poll_next == NULL) {
+    master->state_poll_next = master->first_slave;
+  }
+}
+
 void lcec_update_slave_state_hal(lcec_slave_state_t *hal_data, ec_slave_config_state_t *ss) {
   *(hal_data->online) = ss->online;
   *(hal_data->operational) = ss->operational;
@@ -1198,6 +2097,20 @@ void lcec_update_slave_state_hal(lcec_slave_state_t *hal_data, ec_slave_config_s
 }
 
 void lcec_read_all(void *arg, long period) {
+  lcec_run_all(lcec_read_master, period);
+  lcec_update_global_hal();
+}
+
+void lcec_receive_all(void *arg, long period) {
+  lcec_run_all(lcec_receive_master, period);
+  lcec_update_global_hal();
+}
+
+void lcec_process_inputs_all(void *arg, long period) {
+  lcec_run_all(lcec_process_inputs_master, period);
+}
+
+void lcec_update_global_hal(void) {
   lcec_master_t *master;
 
   // initialize global state
@@ -1205,9 +2118,11 @@ void lcec_read_all(void *arg, long period) {
   global_ms.al_states = 0;
   global_ms.link_up = (first_master != NULL);
 
-  // process slaves
+  // collect master states
   for (master = first_master; master != NULL; master = master->next) {
-    lcec_read_master(master, period);
+    global_ms.slaves_responding += master->ms.slaves_responding;
+    global_ms.al_states |= master->ms.al_states;
+    global_ms.link_up = global_ms.link_up && master->ms.link_up;
   }
 
   // update global state pins
@@ -1215,18 +2130,32 @@ void lcec_read_all(void *arg, long period) {
 }
 
 void lcec_write_all(void *arg, long period) {
-  lcec_master_t *master;
+  lcec_run_all(lcec_write_master, period);
+}
 
-  // process slaves
-  for (master = first_master; master != NULL; master = master->next) {
-    lcec_write_master(master, period);
-  }
+void lcec_process_outputs_all(void *arg, long period) {
+  lcec_run_all(lcec_process_outputs_master, period);
+}
+
+void lcec_send_all(void *arg, long period) {
+  lcec_run_all(lcec_send_master, period);
 }
 
 void lcec_read_master(void *arg, long period) {
+  lcec_receive_master(arg, period);
+  lcec_process_inputs_master(arg, period);
+}
+
+void lcec_receive_master(void *arg, long period) {
   lcec_master_t *master = (lcec_master_t *) arg;
-  lcec_slave_t *slave;
+  lcec_domain_t *domain;
+  lcec_slave_t *slave, *poll_first;
+  lcec_domain_range_t *range;
+  uint8_t *data;
   int check_states;
+  int polls;
+  int i;
+  long long t_start, t_recv, t_proc;
 
   // check period
   if (period != master->period_last) {
@@ -1235,6 +2164,7 @@ void lcec_read_master(void *arg, long period) {
       rtapi_print_msg(RTAPI_MSG_ERR, LCEC_MSG_PFX "Invalid appTimePeriod of %u for master %s (should be %ld).\n",
         master->app_time_period, master->name, period);
     }
+    lcec_update_state_poll_count(master, period);
   }
 
   // get state check flag
@@ -1246,47 +2176,179 @@ void lcec_read_master(void *arg, long period) {
     master->state_update_timer = LCEC_STATE_UPDATE_PERIOD;
   }
 
+  // reset timing statistics
+  if (*(master->hal_data->timing_reset)) {
+    lcec_reset_timing_hal(master->hal_data);
+  }
+
   // receive process data & master state
+  // (timing starts after the lock, waits for non-RT users don't count)
+  master->cycle_start = rtapi_get_time();
   rtapi_mutex_get(&master->mutex);
+  t_start = rtapi_get_time();
+
+  // send first: receive overwrites the outputs with the echo
+  // of the last frame, save the outputs of the last write
+  if (master->send_first) {
+    for (domain = master->first_domain; domain != NULL; domain = domain->next) {
+      if (domain->queued) {
+        for (i = 0, range = domain->out_ranges, data = domain->out_data; i < domain->out_range_count; i++, range++) {
+          memcpy(data, domain->process_data + range->offset, range->length);
+          data += range->length;
+        }
+      }
+    }
+  }
+
   ecrt_master_receive(master->master);
-  ecrt_domain_process(master->domain);
-  if (check_states) {
+  t_recv = rtapi_get_time();
+  for (domain = master->first_domain; domain != NULL; domain = domain->next) {
+    // only domains sent in the last cycle
+    domain->active = domain->queued;
+    if (domain->active) {
+      ecrt_domain_process(domain->domain);
+      ecrt_domain_state(domain->domain, &domain->state);
+
+      // send first: restore saved outputs
+      if (master->send_first) {
+        for (i = 0, range = domain->out_ranges, data = domain->out_data; i < domain->out_range_count; i++, range++) {
+          memcpy(domain->process_data + range->offset, data, range->length);
+          data += range->length;
+        }
+      }
+    }
+  }
+  if (check_states || (master->rec != NULL && lcec_rec_state_wanted(master))) {
     ecrt_master_state(master->master, &master->ms);
   }
   rtapi_mutex_give(&master->mutex);
+  t_proc = rtapi_get_time();
+
+  // send first: send outputs from last cycle right now
+  if (master->send_first) {
+    lcec_send_data(master, period);
+  }
+
+  // publish process image
+  if (master->tap != NULL) {
+    lcec_tap_publish(master);
+  }
+
+  // update working counter state
+  for (domain = master->first_domain; domain != NULL; domain = domain->next) {
+    if (domain->active) {
+      lcec_update_domain_hal(domain->hal_data, &domain->state);
+      domain->process_data_valid = *(domain->hal_data->wc_valid);
+    }
+  }
 
   // update state pins
   lcec_update_master_hal(master->hal_data, &master->ms);
 
-  // update global state
-  global_ms.slaves_responding += master->ms.slaves_responding;
-  global_ms.al_states |= master->ms.al_states;
-  global_ms.link_up = global_ms.link_up && master->ms.link_up;
+  // get number of slave states to poll, by default a slave is due
+  // every state update period / slave count, most cycles poll none
+  polls = master->state_poll_count;
+  if (master->state_poll_rate > 0) {
+    master->state_poll_credit += master->state_poll_rate;
+    while (master->state_poll_credit >= LCEC_STATE_UPDATE_PERIOD && polls < master->slave_count) {
+      master->state_poll_credit -= LCEC_STATE_UPDATE_PERIOD;
+      polls++;
+    }
+    if (master->state_poll_credit >= LCEC_STATE_UPDATE_PERIOD) {
+      master->state_poll_credit = 0;
+    }
+  }
 
-  // process slaves
-  for (slave = master->first_slave; slave != NULL; slave = slave->next) {
-    // get slaves state
+  // poll next slave states round robin, lock only if there are any
+  if (polls > 0) {
+    poll_first = master->state_poll_next;
     rtapi_mutex_get(&master->mutex);
-    if (check_states) {
+    for (i = 0, slave = poll_first; i < polls; i++) {
       ecrt_slave_config_state(slave->config, &slave->state);
+      slave = (slave->next != NULL) ? slave->next : master->first_slave;
     }
     rtapi_mutex_give(&master->mutex);
-    if (check_states) {
+    master->state_poll_next = slave;
+
+    for (i = 0, slave = poll_first; i < polls; i++) {
       lcec_update_slave_state_hal(slave->hal_state_data, &slave->state);
+      slave = (slave->next != NULL) ? slave->next : master->first_slave;
     }
+  }
 
-    // process read function
-    if (slave->proc_read != NULL) {
-      slave->proc_read(slave, period);
+  // update timing statistics
+  lcec_update_timing_hal(master->hal_data, lcecTimingReceive, t_recv - t_start);
+  lcec_update_timing_hal(master->hal_data, lcecTimingProcess, t_proc - t_recv);
+}
+
+void lcec_process_inputs_master(void *arg, long period) {
+  lcec_master_t *master = (lcec_master_t *) arg;
+  lcec_domain_t *domain;
+  lcec_slave_func_t *func;
+  int i;
+  long long t_start;
+
+  // process slaves (only if domain was exchanged)
+  t_start = rtapi_get_time();
+  for (domain = master->first_domain; domain != NULL; domain = domain->next) {
+    if (!domain->active) {
+      continue;
+    }
+
+    // skip on incomplete working counter if requested (keeps last pin values)
+    if (!domain->process_data_valid && domain->hal_data->wc_skip_read) {
+      continue;
+    }
+
+    for (i = 0, func = domain->read_funcs; i < domain->read_func_count; i++, func++) {
+      func->proc(func->slave, period);
     }
   }
+
+  // update timing statistics
+  lcec_update_timing_hal(master->hal_data, lcecTimingRead, rtapi_get_time() - t_start);
 }
 
 void lcec_write_master(void *arg, long period) {
+  lcec_process_outputs_master(arg, period);
+  lcec_send_master(arg, period);
+}
+
+void lcec_process_outputs_master(void *arg, long period) {
   lcec_master_t *master = (lcec_master_t *) arg;
-  lcec_slave_t *slave;
+  lcec_domain_t *domain;
+  lcec_slave_func_t *func;
+  int i;
+  long long t_start;
+
+  // process slaves (only if domain is sent in this cycle)
+  t_start = rtapi_get_time();
+  for (domain = master->first_domain; domain != NULL; domain = domain->next) {
+    if (domain->cycle_cnt == 0) {
+      for (i = 0, func = domain->write_funcs; i < domain->write_func_count; i++, func++) {
+        func->proc(func->slave, period);
+      }
+    }
+  }
+
+  // update timing statistics
+  lcec_update_timing_hal(master->hal_data, lcecTimingWrite, rtapi_get_time() - t_start);
+}
+
+void lcec_send_master(void *arg, long period) {
+  lcec_master_t *master = (lcec_master_t *) arg;
+
+  // send first mode sends in receive function
+  if (!master->send_first) {
+    lcec_send_data(master, period);
+  }
+}
+
+void lcec_send_data(lcec_master_t *master, long period) {
+  lcec_domain_t *domain;
   uint64_t app_time;
   long long now;
+  long long t_start;
 #ifdef RTAPI_TASK_PLL_SUPPORT
   long long ref;
   uint32_t dc_time;
@@ -1294,13 +2356,6 @@ void lcec_write_master(void *arg, long period) {
   lcec_master_data_t *hal_data;
 #endif
 
-  // process slaves
-  for (slave = master->first_slave; slave != NULL; slave = slave->next) {
-    if (slave->proc_write != NULL) {
-      slave->proc_write(slave, period);
-    }
-  }
-
 #ifdef RTAPI_TASK_PLL_SUPPORT
   // get reference time
   ref = rtapi_task_pll_get_reference();
@@ -1308,7 +2363,17 @@ void lcec_write_master(void *arg, long period) {
 
   // send process data
   rtapi_mutex_get(&master->mutex);
-  ecrt_domain_queue(master->domain);
+  t_start = rtapi_get_time();
+  for (domain = master->first_domain; domain != NULL; domain = domain->next) {
+    // queue domains due in this cycle
+    domain->queued = (domain->cycle_cnt == 0);
+    if (domain->queued) {
+      ecrt_domain_queue(domain->domain);
+    }
+    if (++(domain->cycle_cnt) >= domain->cycle_divider) {
+      domain->cycle_cnt = 0;
+    }
+  }
 
   // update application time
   now = rtapi_get_time();
@@ -1352,6 +2417,22 @@ void lcec_write_master(void *arg, long period) {
   ecrt_master_send(master->master);
   rtapi_mutex_give(&master->mutex);
 
+  // update send time relative to cycle start
+  now = rtapi_get_time();
+#ifdef RTAPI_TASK_PLL_SUPPORT
+  *(master->hal_data->send_time) = now - ref;
+#else
+  *(master->hal_data->send_time) = now - master->cycle_start;
+#endif
+
+  // record sent cycle
+  if (master->rec != NULL) {
+    lcec_rec_cycle(master);
+  }
+
+  // update timing statistics
+  lcec_update_timing_hal(master->hal_data, lcecTimingSend, now - t_start);
+
 #ifdef RTAPI_TASK_PLL_SUPPORT
   // BANG-BANG controller for master thread PLL sync
   // this part is done after ecrt_master_send() to reduce jitter
@@ -1452,6 +2533,14 @@ static int lcec_pin_newfv(hal_type_t type, hal_pin_dir_t dir, void **data_ptr_ad
     case HAL_U32:
       **((hal_u32_t **) data_ptr_addr) = 0;
       break;
+#ifdef LCEC_HAL_64BIT
+    case HAL_S64:
+      **((hal_s64_t **) data_ptr_addr) = 0;
+      break;
+    case HAL_U64:
+      **((hal_u64_t **) data_ptr_addr) = 0;
+      break;
+#endif
     default:
       break;
   }
@@ -1581,7 +2670,7 @@ LCEC_CONF_MODPARAM_VAL_T *lcec_modparam_get(struct lcec_slave *slave, int id) {
     return NULL;
   }
 
-  for (p = slave->modparams; p->id >= 0; p++) {
+  for (p = slave->modparams; p->confType == lcecConfTypeModParam; p = LCEC_CONF_TOKEN_NEXT(p, sizeof(*p))) {
     if (p->id == id) {
       return &p->value;
     }
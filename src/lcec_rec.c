@@ -0,0 +1,270 @@
+//
+//    Copyright (C) 2026 Sascha Ittner <sascha.ittner@modusoft.de>
+//
+//    This program is free software; you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation; either version 2 of the License, or
+//    (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with this program; if not, write to the Free Software
+//    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301 USA
+//
+
+#include "lcec.h"
+#include "lcec_rec.h"
+
+typedef struct lcec_rec {
+  int shmem_id;
+  LCEC_REC_HEADER_T *hdr;
+  hal_bit_t *arm;
+  hal_bit_t *trigger;
+  hal_bit_t *triggered;
+  hal_u32_t *fill;
+  hal_u32_t *captures;
+  hal_u32_t post_cycles;
+  hal_bit_t trigger_wc;
+  hal_bit_t trigger_not_op;
+  int trigger_last;
+  int all_op_last;
+  uint32_t post_cnt;
+} lcec_rec_t;
+
+static const lcec_pindesc_t rec_pins[] = {
+  { HAL_BIT, HAL_IN, offsetof(lcec_rec_t, arm), "%s.%s.rec-arm" },
+  { HAL_BIT, HAL_IN, offsetof(lcec_rec_t, trigger), "%s.%s.rec-trigger" },
+  { HAL_BIT, HAL_OUT, offsetof(lcec_rec_t, triggered), "%s.%s.rec-triggered" },
+  { HAL_U32, HAL_OUT, offsetof(lcec_rec_t, fill), "%s.%s.rec-fill" },
+  { HAL_U32, HAL_OUT, offsetof(lcec_rec_t, captures), "%s.%s.rec-captures" },
+  { HAL_TYPE_UNSPECIFIED, HAL_DIR_UNSPECIFIED, -1, NULL }
+};
+
+static const lcec_pindesc_t rec_params[] = {
+  { HAL_U32, HAL_RW, offsetof(lcec_rec_t, post_cycles), "%s.%s.rec-post-cycles" },
+  { HAL_BIT, HAL_RW, offsetof(lcec_rec_t, trigger_wc), "%s.%s.rec-trigger-wc" },
+  { HAL_BIT, HAL_RW, offsetof(lcec_rec_t, trigger_not_op), "%s.%s.rec-trigger-not-op" },
+  { HAL_TYPE_UNSPECIFIED, HAL_DIR_UNSPECIFIED, -1, NULL }
+};
+
+static int lcec_rec_check_trigger(lcec_rec_t *rec, struct lcec_master *master);
+
+int lcec_rec_init(int comp_id, struct lcec_master *master) {
+  lcec_rec_t *rec;
+  LCEC_REC_HEADER_T *hdr;
+  lcec_domain_t *domain;
+  void *shmem_ptr;
+  int shmem_id;
+  int entry_count, domain_count;
+  size_t entry_offset, ring_offset, slot_data_offset, slot_size;
+  uint64_t size;
+
+  // alloc hal memory
+  if ((rec = hal_malloc(sizeof(lcec_rec_t))) == NULL) {
+    rtapi_print_msg(RTAPI_MSG_ERR, LCEC_MSG_PFX "hal_malloc() for master %s recorder failed\n", master->name);
+    return -1;
+  }
+  memset(rec, 0, sizeof(lcec_rec_t));
+
+  // export pins and params
+  if (lcec_pin_newf_list(rec, rec_pins, LCEC_MODULE_NAME, master->name) != 0) {
+    return -1;
+  }
+  if (lcec_param_newf_list(rec, rec_params, LCEC_MODULE_NAME, master->name) != 0) {
+    return -1;
+  }
+  rec->post_cycles = master->rec_depth / 4;
+
+  // get entry and domain count
+  entry_count = lcec_tap_entry_count(master);
+  domain_count = 0;
+  for (domain = master->first_domain; domain != NULL; domain = domain->next) {
+    domain_count++;
+  }
+
+  // calculate layout (slots and slot data 8 byte aligned)
+  entry_offset = sizeof(LCEC_REC_HEADER_T);
+  ring_offset = (entry_offset + sizeof(LCEC_TAP_ENTRY_T) * entry_count + 7) & ~7;
+  slot_data_offset = (sizeof(LCEC_REC_SLOT_T) + sizeof(uint32_t) * domain_count + 7) & ~7;
+  slot_size = (slot_data_offset + master->process_data_len + 7) & ~7;
+  size = ring_offset + (uint64_t) slot_size * master->rec_depth;
+  if (size > 0xffffffff) {
+    rtapi_print_msg(RTAPI_MSG_ERR, LCEC_MSG_PFX "recorderDepth %d of master %s too large (%u bytes per cycle)\n", master->rec_depth, master->name, (unsigned int) slot_size);
+    return -1;
+  }
+
+  // create shared memory
+  shmem_id = rtapi_shmem_new(LCEC_REC_SHMEM_KEY + master->index, comp_id, size);
+  if (shmem_id < 0) {
+    rtapi_print_msg(RTAPI_MSG_ERR, LCEC_MSG_PFX "couldn't allocate recorder shared memory for master %s\n", master->name);
+    return -1;
+  }
+  if (lcec_rtapi_shmem_getptr(shmem_id, &shmem_ptr) < 0) {
+    rtapi_print_msg(RTAPI_MSG_ERR, LCEC_MSG_PFX "couldn't map recorder shared memory for master %s\n", master->name);
+    rtapi_shmem_delete(shmem_id, comp_id);
+    return -1;
+  }
+  memset(shmem_ptr, 0, size);
+
+  // setup header
+  hdr = shmem_ptr;
+  hdr->version = LCEC_REC_VERSION;
+  hdr->size = size;
+  hdr->period = master->app_time_period;
+  hdr->depth = master->rec_depth;
+  hdr->slot_size = slot_size;
+  hdr->slot_data_offset = slot_data_offset;
+  hdr->data_len = master->process_data_len;
+  hdr->domain_count = domain_count;
+  hdr->entry_count = entry_count;
+  hdr->entry_offset = entry_offset;
+  hdr->ring_offset = ring_offset;
+  strncpy(hdr->master_name, master->name, LCEC_TAP_NAME_LEN);
+  hdr->master_name[LCEC_TAP_NAME_LEN - 1] = 0;
+  hdr->state = lcecRecStateIdle;
+
+  // setup layout entries
+  lcec_tap_init_entries(master, shmem_ptr + entry_offset);
+
+  // mark as valid
+  lcec_wmb();
+  hdr->magic = LCEC_REC_MAGIC;
+
+  rec->shmem_id = shmem_id;
+  rec->hdr = hdr;
+  master->rec = rec;
+  return 0;
+}
+
+void lcec_rec_cleanup(int comp_id, struct lcec_master *master) {
+  if (master->rec == NULL) {
+    return;
+  }
+
+  rtapi_shmem_delete(master->rec->shmem_id, comp_id);
+  master->rec = NULL;
+}
+
+static int lcec_rec_check_trigger(lcec_rec_t *rec, struct lcec_master *master) {
+  lcec_domain_t *domain;
+  int trigger, all_op;
+  int ret = 0;
+
+  // rising edge on trigger pin
+  trigger = *(rec->trigger);
+  if (trigger && !rec->trigger_last) {
+    ret = 1;
+  }
+  rec->trigger_last = trigger;
+
+  // slave left OP (master state is read every cycle while armed)
+  all_op = (master->ms.al_states == 0x08);
+  if (rec->trigger_not_op && rec->all_op_last && !all_op) {
+    ret = 1;
+  }
+  rec->all_op_last = all_op;
+
+  // incomplete working counter
+  if (rec->trigger_wc) {
+    for (domain = master->first_domain; domain != NULL; domain = domain->next) {
+      if (domain->active && domain->state.wc_state != EC_WC_COMPLETE) {
+        ret = 1;
+      }
+    }
+  }
+
+  return ret;
+}
+
+int lcec_rec_state_wanted(struct lcec_master *master) {
+  lcec_rec_t *rec = master->rec;
+
+  return rec->trigger_not_op && *(rec->arm);
+}
+
+void lcec_rec_cycle(struct lcec_master *master) {
+  lcec_rec_t *rec = master->rec;
+  LCEC_REC_HEADER_T *hdr = rec->hdr;
+  LCEC_REC_SLOT_T *slot;
+  lcec_domain_t *domain;
+  uint32_t *wc;
+  uint32_t state;
+  int trigger;
+
+  hdr->cycle++;
+
+  // check triggers every cycle to keep edge detection in sync
+  trigger = lcec_rec_check_trigger(rec, master);
+
+  // reset on disarm
+  state = hdr->state;
+  if (!*(rec->arm)) {
+    if (state != lcecRecStateIdle) {
+      hdr->fill = 0;
+      hdr->write_idx = 0;
+      lcec_atomic_store(&hdr->state, lcecRecStateIdle);
+    }
+    *(rec->triggered) = 0;
+    return;
+  }
+
+  // keep frozen capture until disarmed
+  if (state == lcecRecStateFrozen) {
+    return;
+  }
+
+  // copy cycle into next slot
+  slot = (LCEC_REC_SLOT_T *) lcec_rec_slot(hdr, hdr->write_idx);
+  slot->cycle = hdr->cycle;
+  slot->timestamp = rtapi_get_time();
+  wc = (uint32_t *) lcec_rec_slot_wc(slot);
+  for (domain = master->first_domain; domain != NULL; domain = domain->next, wc++) {
+    *wc = domain->state.working_counter;
+  }
+  memcpy(((uint8_t *) slot) + hdr->slot_data_offset, master->process_data, hdr->data_len);
+
+  if (hdr->fill < hdr->depth) {
+    hdr->fill++;
+  }
+  if (++(hdr->write_idx) >= hdr->depth) {
+    hdr->write_idx = 0;
+  }
+  *(rec->fill) = hdr->fill;
+
+  switch (state) {
+    case lcecRecStateIdle:
+    case lcecRecStateRecording:
+      if (!trigger) {
+        if (state == lcecRecStateIdle) {
+          lcec_atomic_store(&hdr->state, lcecRecStateRecording);
+        }
+        return;
+      }
+      hdr->trigger_idx = (hdr->write_idx + hdr->depth - 1) % hdr->depth;
+      rec->post_cnt = rec->post_cycles;
+      if (rec->post_cnt >= hdr->depth) {
+        rec->post_cnt = hdr->depth - 1;
+      }
+      break;
+
+    case lcecRecStateTriggered:
+      rec->post_cnt--;
+      break;
+  }
+
+  // freeze ring after post trigger cycles
+  if (rec->post_cnt == 0) {
+    hdr->capture_count++;
+    *(rec->captures) = hdr->capture_count;
+    *(rec->triggered) = 1;
+    lcec_atomic_store(&hdr->state, lcecRecStateFrozen);
+    return;
+  }
+
+  lcec_atomic_store(&hdr->state, lcecRecStateTriggered);
+}
+
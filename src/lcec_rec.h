@@ -0,0 +1,123 @@
+//
+//    Copyright (C) 2026 Sascha Ittner <sascha.ittner@modusoft.de>
+//
+//    This program is free software; you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation; either version 2 of the License, or
+//    (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with this program; if not, write to the Free Software
+//    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301 USA
+//
+#ifndef _LCEC_REC_H_
+#define _LCEC_REC_H_
+
+//
+// Process data recorder
+//
+// Masters with recorderDepth="N" keep the last N cycles of their
+// process image in a ring inside a RTAPI shared memory segment with
+// key LCEC_REC_SHMEM_KEY + master index. Each slot is written in the
+// send function, so it holds the inputs received and the outputs sent
+// in this cycle.
+//
+// While lcec.<master>.rec-arm is set, the ring is written every cycle.
+// On a trigger (rising edge of rec-trigger, incomplete working counter
+// if rec-trigger-wc is set, or a slave leaving OP if rec-trigger-not-op
+// is set) another rec-post-cycles cycles are recorded and the ring is
+// frozen until rec-arm is reset. lcec_rec_dump writes frozen captures
+// to files. While armed with rec-trigger-not-op set, the master state
+// is read every cycle instead of once per state update period.
+//
+// Shared memory layout:
+//   LCEC_REC_HEADER_T
+//   LCEC_TAP_ENTRY_T[entry_count]  at entry_offset
+//   slot[depth]                    at ring_offset, slot_size bytes each
+//
+// Slot layout:
+//   LCEC_REC_SLOT_T
+//   uint32_t wc[domain_count]      working counter per domain
+//   uint8_t data[data_len]         at slot_data_offset
+//
+// Capture file layout (all values host byte order):
+//   LCEC_REC_FILE_HEADER_T
+//   LCEC_TAP_ENTRY_T[entry_count]
+//   slot[slot_count]               oldest first, slot_size bytes each
+//
+
+#include "lcec_tap.h"
+
+#define LCEC_REC_SHMEM_KEY 0xACB57400
+#define LCEC_REC_MAGIC     0x4C524543
+#define LCEC_REC_VERSION   1
+
+#define LCEC_REC_FILE_MAGIC "LCECREC1"
+
+typedef enum {
+  lcecRecStateIdle = 0,
+  lcecRecStateRecording,
+  lcecRecStateTriggered,
+  lcecRecStateFrozen
+} LCEC_REC_STATE_T;
+
+typedef struct {
+  uint32_t magic;
+  uint32_t version;
+  uint32_t size;
+  uint32_t period;
+  uint32_t depth;
+  uint32_t slot_size;
+  uint32_t slot_data_offset;
+  uint32_t data_len;
+  uint32_t domain_count;
+  uint32_t entry_count;
+  uint32_t entry_offset;
+  uint32_t ring_offset;
+  char master_name[LCEC_TAP_NAME_LEN];
+
+  // written by RT side
+  uint32_t state;
+  uint32_t write_idx;
+  uint32_t fill;
+  uint32_t trigger_idx;
+  uint32_t capture_count;
+  uint32_t reserved;
+  uint64_t cycle;
+} LCEC_REC_HEADER_T;
+
+typedef struct {
+  uint64_t cycle;
+  int64_t timestamp;
+} LCEC_REC_SLOT_T;
+
+typedef struct {
+  char magic[8];
+  uint32_t version;
+  uint32_t header_size;
+  uint32_t period;
+  uint32_t slot_count;
+  uint32_t slot_size;
+  uint32_t slot_data_offset;
+  uint32_t data_len;
+  uint32_t domain_count;
+  uint32_t entry_count;
+  uint32_t trigger_slot;
+  char master_name[LCEC_TAP_NAME_LEN];
+} LCEC_REC_FILE_HEADER_T;
+
+static inline const LCEC_REC_SLOT_T *lcec_rec_slot(const LCEC_REC_HEADER_T *hdr, uint32_t idx) {
+  return (const LCEC_REC_SLOT_T *) (((const uint8_t *) hdr) + hdr->ring_offset + (size_t) hdr->slot_size * idx);
+}
+
+static inline const uint32_t *lcec_rec_slot_wc(const LCEC_REC_SLOT_T *slot) {
+  return (const uint32_t *) (slot + 1);
+}
+
+#endif
+
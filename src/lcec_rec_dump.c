@@ -0,0 +1,236 @@
+//
+//    Copyright (C) 2026 Sascha Ittner <sascha.ittner@modusoft.de>
+//
+//    This program is free software; you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation; either version 2 of the License, or
+//    (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with this program; if not, write to the Free Software
+//    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301 USA
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <string.h>
+#include <signal.h>
+
+#include "rtapi.h"
+#include "hal.h"
+
+#include "lcec_rtapi.h"
+#include "lcec_conf.h"
+#include "lcec_rec.h"
+
+// poll interval (us)
+#define LCEC_REC_DUMP_POLL 10000
+
+static const char *modname = "lcec_rec_dump";
+
+static volatile sig_atomic_t exitFlag = 0;
+
+static void exitHandler(int sig) {
+  exitFlag = 1;
+}
+
+static void usage(void) {
+  fprintf(stderr, "usage: %s [-m master-index] [-o file-prefix] [-s]\n", modname);
+}
+
+static int writeCapture(const char *filename, const LCEC_REC_HEADER_T *hdr, const uint8_t *ring, uint32_t fill, uint32_t write_idx, uint32_t trigger_idx) {
+  LCEC_REC_FILE_HEADER_T fhdr;
+  FILE *file;
+  uint32_t start, i;
+
+  // oldest slot is at write index if the ring was wrapped
+  start = (fill < hdr->depth) ? 0 : write_idx;
+
+  memset(&fhdr, 0, sizeof(fhdr));
+  memcpy(fhdr.magic, LCEC_REC_FILE_MAGIC, sizeof(fhdr.magic));
+  fhdr.version = LCEC_REC_VERSION;
+  fhdr.header_size = sizeof(fhdr);
+  fhdr.period = hdr->period;
+  fhdr.slot_count = fill;
+  fhdr.slot_size = hdr->slot_size;
+  fhdr.slot_data_offset = hdr->slot_data_offset;
+  fhdr.data_len = hdr->data_len;
+  fhdr.domain_count = hdr->domain_count;
+  fhdr.entry_count = hdr->entry_count;
+  fhdr.trigger_slot = (trigger_idx + hdr->depth - start) % hdr->depth;
+  memcpy(fhdr.master_name, hdr->master_name, LCEC_TAP_NAME_LEN);
+
+  file = fopen(filename, "wb");
+  if (file == NULL) {
+    fprintf(stderr, "%s: ERROR: unable to open capture file %s\n", modname, filename);
+    return -1;
+  }
+
+  if (fwrite(&fhdr, sizeof(fhdr), 1, file) != 1) {
+    goto fail;
+  }
+  if (hdr->entry_count > 0 && fwrite(((const uint8_t *) hdr) + hdr->entry_offset, sizeof(LCEC_TAP_ENTRY_T), hdr->entry_count, file) != hdr->entry_count) {
+    goto fail;
+  }
+  for (i = 0; i < fill; i++) {
+    if (fwrite(ring + (size_t) hdr->slot_size * ((start + i) % hdr->depth), hdr->slot_size, 1, file) != 1) {
+      goto fail;
+    }
+  }
+
+  if (fclose(file) != 0) {
+    fprintf(stderr, "%s: ERROR: unable to write capture file %s\n", modname, filename);
+    return -1;
+  }
+  return 0;
+
+fail:
+  fprintf(stderr, "%s: ERROR: unable to write capture file %s\n", modname, filename);
+  fclose(file);
+  return -1;
+}
+
+int main(int argc, char **argv) {
+  int ret = 1;
+  int opt;
+  int master_idx = 0;
+  const char *prefix = "lcec-capture";
+  int single = 0;
+  int hal_comp_id;
+  int shmem_id;
+  void *shmem_ptr;
+  LCEC_REC_HEADER_T *hdr;
+  uint8_t *ring;
+  size_t size, ring_len;
+  uint32_t last_count, count, fill, write_idx, trigger_idx;
+  unsigned int file_idx;
+  char filename[4096];
+
+  // parse arguments
+  while ((opt = getopt(argc, argv, "m:o:sh")) != -1) {
+    switch (opt) {
+      case 'm':
+        master_idx = atoi(optarg);
+        break;
+      case 'o':
+        prefix = optarg;
+        break;
+      case 's':
+        single = 1;
+        break;
+      default:
+        usage();
+        return 1;
+    }
+  }
+
+  // initialize component
+  hal_comp_id = hal_init(modname);
+  if (hal_comp_id < 1) {
+    fprintf(stderr, "%s: ERROR: hal_init failed\n", modname);
+    goto fail0;
+  }
+
+  // check for recorder shared memory
+  shmem_id = rtapi_shmem_new(LCEC_REC_SHMEM_KEY + master_idx, hal_comp_id, sizeof(LCEC_REC_HEADER_T));
+  if (shmem_id < 0) {
+    fprintf(stderr, "%s: ERROR: couldn't allocate recorder shared memory\n", modname);
+    goto fail1;
+  }
+  if (lcec_rtapi_shmem_getptr(shmem_id, &shmem_ptr) < 0) {
+    fprintf(stderr, "%s: ERROR: couldn't map recorder shared memory\n", modname);
+    rtapi_shmem_delete(shmem_id, hal_comp_id);
+    goto fail1;
+  }
+  hdr = shmem_ptr;
+  if (lcec_atomic_load(&hdr->magic) != LCEC_REC_MAGIC || hdr->version != LCEC_REC_VERSION) {
+    fprintf(stderr, "%s: ERROR: recorder for master %d is not enabled\n", modname, master_idx);
+    rtapi_shmem_delete(shmem_id, hal_comp_id);
+    goto fail1;
+  }
+  size = hdr->size;
+  rtapi_shmem_delete(shmem_id, hal_comp_id);
+
+  // remap with full size
+  shmem_id = rtapi_shmem_new(LCEC_REC_SHMEM_KEY + master_idx, hal_comp_id, size);
+  if (shmem_id < 0) {
+    fprintf(stderr, "%s: ERROR: couldn't allocate recorder shared memory\n", modname);
+    goto fail1;
+  }
+  if (lcec_rtapi_shmem_getptr(shmem_id, &shmem_ptr) < 0) {
+    fprintf(stderr, "%s: ERROR: couldn't map recorder shared memory\n", modname);
+    goto fail2;
+  }
+  hdr = shmem_ptr;
+
+  // allocate local ring copy
+  ring_len = (size_t) hdr->slot_size * hdr->depth;
+  ring = malloc(ring_len);
+  if (ring == NULL) {
+    fprintf(stderr, "%s: ERROR: unable to allocate capture memory\n", modname);
+    goto fail2;
+  }
+
+  // initialize signal handling
+  signal(SIGINT, exitHandler);
+  signal(SIGTERM, exitHandler);
+
+  ret = 0;
+  hal_ready(hal_comp_id);
+
+  // ignore capture frozen before start
+  last_count = lcec_atomic_load(&hdr->capture_count);
+  file_idx = 0;
+
+  while (!exitFlag) {
+    usleep(LCEC_REC_DUMP_POLL);
+
+    // wait for new frozen capture
+    if (lcec_atomic_load(&hdr->state) != lcecRecStateFrozen) {
+      continue;
+    }
+    count = hdr->capture_count;
+    if (count == last_count) {
+      continue;
+    }
+    fill = hdr->fill;
+    write_idx = hdr->write_idx;
+    trigger_idx = hdr->trigger_idx;
+
+    // copy ring and check that it was not rearmed meanwhile
+    memcpy(ring, ((uint8_t *) hdr) + hdr->ring_offset, ring_len);
+    if (lcec_atomic_load(&hdr->state) != lcecRecStateFrozen || hdr->capture_count != count) {
+      fprintf(stderr, "%s: WARNING: capture %u was rearmed while reading\n", modname, count);
+      last_count = count;
+      continue;
+    }
+    last_count = count;
+
+    // write capture file
+    snprintf(filename, sizeof(filename), "%s-%04u.lcap", prefix, file_idx++);
+    if (writeCapture(filename, hdr, ring, fill, write_idx, trigger_idx) != 0) {
+      ret = 1;
+      break;
+    }
+    fprintf(stderr, "%s: wrote %u cycles of master %s to %s\n", modname, fill, hdr->master_name, filename);
+
+    if (single) {
+      break;
+    }
+  }
+
+  free(ring);
+fail2:
+  rtapi_shmem_delete(shmem_id, hal_comp_id);
+fail1:
+  hal_exit(hal_comp_id);
+fail0:
+  return ret;
+}
+
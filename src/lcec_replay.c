@@ -0,0 +1,857 @@
+//
+//    Copyright (C) 2026 Sascha Ittner <sascha.ittner@modusoft.de>
+//
+//    This program is free software; you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation; either version 2 of the License, or
+//    (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with this program; if not, write to the Free Software
+//    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301 USA
+//
+
+//
+// Offline replay of process data through the real drivers
+//
+// Parses an ethercat-conf.xml with the lcec_conf parser, starts the
+// driver against the simulated master and a fake HAL, then feeds a
+// sequence of input images cycle by cycle through lcec.read-all and
+// lcec.write-all. The clock is virtual (start 0, one period per cycle),
+// so runs are reproducible and not tied to real time.
+//
+// usage: lcec_replay [options] <ethercat-conf.xml> <input-file>
+//   -m idx     master index the input belongs to (default 0)
+//   -p ns      cycle period in ns (default: capture period or 1ms)
+//   -w cycles  max. warmup cycles until all slaves are in OP (default 10000)
+//   -n cycles  number of cycles (default: length of input)
+//   -f prefix  log only pins starting with prefix
+//   -o file    output file (default stdout)
+//   -i         add hex dump of the process image to the output
+//
+// The input format is detected from the file content:
+//
+// Capture file (.lcap, see lcec_rec.h): one cycle per slot. All input
+// entries of the capture that exist in the configuration are copied
+// into the process image on every receive.
+//
+// CSV file: lines starting with '#' are comments. The first line names
+// the columns, the first column must be "cycle". Other columns are
+// either PDO entries written as "position:index:subindex" (e.g.
+// "2:0x6000:0x11", numbers in C syntax) or HAL pin/param names. Each
+// row applies its non empty fields at the start of the given cycle;
+// rows must be sorted by cycle. Entry values are integers or, with a
+// decimal point or exponent, floats (stored as REAL for 32 bit and
+// LREAL for 64 bit entries). Entry values are held and written into the
+// image on every receive, so they override the simulator's models.
+// Pins are set once when the row is applied.
+//
+//   cycle,0:0x6000:0x01,1:0x6010:0x11,lcec.0.enc.index-enable
+//   0,0,1000,
+//   10,1,,1
+//   20,,65530,
+//
+// Output (CSV): one row per cycle after lcec.write-all with the cycle
+// number, every HAL pin (name order of creation), every output PDO
+// entry (raw integer value, sign extended for 8/16/32/64 bit entries)
+// and optionally the whole process image as hex.
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <time.h>
+
+#include "lcec.h"
+#include "lcec_conf_priv.h"
+#include "lcec_rec.h"
+#include "lcec_sim.h"
+#include "lcec_fakehal.h"
+
+#define LCEC_REPLAY_PERIOD   1000000
+#define LCEC_REPLAY_WARMUP   10000
+#define LCEC_REPLAY_LINE_MAX 65536
+#define LCEC_REPLAY_OUTBUF   (1 << 20)
+
+typedef struct {
+  lcec_sim_entry_t *entry;
+  LCEC_SIM_ENTRY_INFO_T info;
+  LCEC_FAKEHAL_PIN_T *pin;
+  int valid;
+  int64_t value;
+  uint32_t src_offset;
+  uint8_t src_bit;
+} LCEC_REPLAY_INPUT_T;
+
+typedef struct {
+  int is_capture;
+  int input_count;
+  LCEC_REPLAY_INPUT_T *inputs;
+  unsigned long length;
+
+  // csv input
+  FILE *file;
+  char *line;
+  unsigned int line_no;
+  int row_valid;
+  unsigned long row_cycle;
+  char *row_fields;
+
+  // capture input
+  uint8_t *capture;
+  const LCEC_REC_FILE_HEADER_T *capture_hdr;
+  const uint8_t *capture_slots;
+  const uint8_t *slot_data;
+} LCEC_REPLAY_SRC_T;
+
+typedef struct {
+  int pin_count;
+  LCEC_FAKEHAL_PIN_T **pins;
+  int entry_count;
+  lcec_sim_entry_t **entries;
+  uint8_t *image;
+  size_t image_len;
+} LCEC_REPLAY_LOG_T;
+
+int rtapi_app_main(void);
+void rtapi_app_exit(void);
+
+static void copy_bits(uint8_t *dst, unsigned int dst_bit, const uint8_t *src, unsigned int src_bit, unsigned int bits) {
+  unsigned int i, s, d;
+
+  if (dst_bit == 0 && src_bit == 0 && (bits & 7) == 0) {
+    memcpy(dst, src, bits >> 3);
+    return;
+  }
+
+  for (i = 0; i < bits; i++) {
+    s = src_bit + i;
+    d = dst_bit + i;
+    if (src[s >> 3] & (1 << (s & 7))) {
+      dst[d >> 3] |= (1 << (d & 7));
+    } else {
+      dst[d >> 3] &= ~(1 << (d & 7));
+    }
+  }
+}
+
+static int parse_entry_name(const char *s, uint16_t *position, uint16_t *index, uint8_t *subindex) {
+  unsigned long val[3];
+  char *end;
+  int i;
+
+  for (i = 0; i < 3; i++) {
+    val[i] = strtoul(s, &end, 0);
+    if (end == s || *end != ((i < 2) ? ':' : 0)) {
+      return -1;
+    }
+    s = end + 1;
+  }
+  if (val[0] > 0xffff || val[1] > 0xffff || val[2] > 0xff) {
+    return -1;
+  }
+
+  *position = val[0];
+  *index = val[1];
+  *subindex = val[2];
+  return 0;
+}
+
+static int parse_entry_value(const LCEC_SIM_ENTRY_INFO_T *info, const char *s, int64_t *value) {
+  char *end;
+  double d;
+  float f;
+  int32_t i32;
+
+  *value = strtoll(s, &end, 0);
+  if (*end == 0) {
+    return 0;
+  }
+
+  d = strtod(s, &end);
+  if (end == s || *end != 0) {
+    return -1;
+  }
+  switch (info->bit_length) {
+    case 32:
+      f = d;
+      memcpy(&i32, &f, sizeof(i32));
+      *value = i32;
+      break;
+    case 64:
+      memcpy(value, &d, sizeof(*value));
+      break;
+    default:
+      *value = (int64_t) d;
+      break;
+  }
+  return 0;
+}
+
+static int set_pin(LCEC_FAKEHAL_PIN_T *pin, const char *s) {
+  char *end;
+  long long ival = 0;
+  double fval = 0.0;
+
+  if (pin->type == HAL_FLOAT) {
+    fval = strtod(s, &end);
+#ifdef LCEC_HAL_64BIT
+  } else if (pin->type == HAL_U64) {
+    ival = strtoull(s, &end, 0);
+#endif
+  } else {
+    ival = strtoll(s, &end, 0);
+  }
+  if (end == s || *end != 0) {
+    return -1;
+  }
+
+  switch (pin->type) {
+    case HAL_BIT:
+      *((hal_bit_t *) pin->data) = (ival != 0);
+      return 0;
+    case HAL_FLOAT:
+      *((hal_float_t *) pin->data) = fval;
+      return 0;
+    case HAL_S32:
+      *((hal_s32_t *) pin->data) = ival;
+      return 0;
+    case HAL_U32:
+      *((hal_u32_t *) pin->data) = ival;
+      return 0;
+#ifdef LCEC_HAL_64BIT
+    case HAL_S64:
+      *((hal_s64_t *) pin->data) = ival;
+      return 0;
+    case HAL_U64:
+      *((hal_u64_t *) pin->data) = ival;
+      return 0;
+#endif
+    default:
+      return -1;
+  }
+}
+
+static void print_pin(FILE *out, const LCEC_FAKEHAL_PIN_T *pin) {
+  switch (pin->type) {
+    case HAL_BIT:
+      fprintf(out, ",%d", *((hal_bit_t *) pin->data) ? 1 : 0);
+      break;
+    case HAL_FLOAT:
+      fprintf(out, ",%.9g", (double) *((hal_float_t *) pin->data));
+      break;
+    case HAL_S32:
+      fprintf(out, ",%d", (int) *((hal_s32_t *) pin->data));
+      break;
+    case HAL_U32:
+      fprintf(out, ",%u", (unsigned int) *((hal_u32_t *) pin->data));
+      break;
+#ifdef LCEC_HAL_64BIT
+    case HAL_S64:
+      fprintf(out, ",%lld", (long long) *((hal_s64_t *) pin->data));
+      break;
+    case HAL_U64:
+      fprintf(out, ",%llu", (unsigned long long) *((hal_u64_t *) pin->data));
+      break;
+#endif
+    default:
+      fprintf(out, ",");
+      break;
+  }
+}
+
+static void print_entry(FILE *out, const lcec_sim_entry_t *entry) {
+  LCEC_SIM_ENTRY_INFO_T info;
+  uint8_t buf[8];
+
+  lcec_sim_entry_info(entry, &info);
+  switch (info.bit_length) {
+    case 1:
+    case 8:
+    case 16:
+    case 32:
+    case 64:
+      fprintf(out, ",%lld", (long long) lcec_sim_entry_get(entry));
+      break;
+    default:
+      memset(buf, 0, sizeof(buf));
+      copy_bits(buf, 0, info.data, info.bit_position, info.bit_length);
+      fprintf(out, ",%llu", (unsigned long long) EC_READ_U64(buf));
+      break;
+  }
+}
+
+static char *csv_read_line(LCEC_REPLAY_SRC_T *src) {
+  char *p;
+
+  while (fgets(src->line, LCEC_REPLAY_LINE_MAX, src->file) != NULL) {
+    src->line_no++;
+    p = src->line + strlen(src->line);
+    while (p > src->line && (p[-1] == '\n' || p[-1] == '\r' || p[-1] == ' ')) {
+      *(--p) = 0;
+    }
+    if (src->line[0] != 0 && src->line[0] != '#') {
+      return src->line;
+    }
+  }
+
+  return NULL;
+}
+
+static int csv_next_row(LCEC_REPLAY_SRC_T *src) {
+  char *line, *field, *end;
+  unsigned long cycle;
+
+  src->row_valid = 0;
+  line = csv_read_line(src);
+  if (line == NULL) {
+    return 0;
+  }
+
+  field = strsep(&line, ",");
+  cycle = strtoul(field, &end, 0);
+  if (end == field || *end != 0) {
+    fprintf(stderr, "%s: ERROR: invalid cycle number in line %u\n", modname, src->line_no);
+    return -1;
+  }
+  if (src->length > 0 && cycle < src->row_cycle) {
+    fprintf(stderr, "%s: ERROR: cycle numbers not sorted in line %u\n", modname, src->line_no);
+    return -1;
+  }
+
+  src->row_valid = 1;
+  src->row_cycle = cycle;
+  src->row_fields = line;
+  src->length = cycle + 1;
+  return 0;
+}
+
+static int csv_apply_row(LCEC_REPLAY_SRC_T *src) {
+  LCEC_REPLAY_INPUT_T *in;
+  char *field;
+  int i;
+
+  for (i = 0, in = src->inputs; i < src->input_count && src->row_fields != NULL; i++, in++) {
+    field = strsep(&src->row_fields, ",");
+    if (*field == 0) {
+      continue;
+    }
+
+    if (in->pin != NULL) {
+      if (set_pin(in->pin, field) != 0) {
+        fprintf(stderr, "%s: ERROR: invalid value '%s' for pin %s in line %u\n", modname, field, in->pin->name, src->line_no);
+        return -1;
+      }
+      continue;
+    }
+
+    if (parse_entry_value(&in->info, field, &in->value) != 0) {
+      fprintf(stderr, "%s: ERROR: invalid value '%s' in line %u\n", modname, field, src->line_no);
+      return -1;
+    }
+    in->valid = 1;
+  }
+
+  return 0;
+}
+
+static int csv_open(LCEC_REPLAY_SRC_T *src, ec_master_t *master, FILE *file) {
+  LCEC_REPLAY_INPUT_T *in;
+  char *line, *field;
+  uint16_t position, index;
+  uint8_t subindex;
+
+  src->file = file;
+  src->line = malloc(LCEC_REPLAY_LINE_MAX);
+  if (src->line == NULL) {
+    fprintf(stderr, "%s: ERROR: out of memory\n", modname);
+    return -1;
+  }
+
+  line = csv_read_line(src);
+  if (line == NULL) {
+    fprintf(stderr, "%s: ERROR: input file is empty\n", modname);
+    return -1;
+  }
+  field = strsep(&line, ",");
+  if (strcmp(field, "cycle") != 0) {
+    fprintf(stderr, "%s: ERROR: first column must be 'cycle'\n", modname);
+    return -1;
+  }
+
+  while (line != NULL) {
+    field = strsep(&line, ",");
+    in = realloc(src->inputs, sizeof(LCEC_REPLAY_INPUT_T) * (src->input_count + 1));
+    if (in == NULL) {
+      fprintf(stderr, "%s: ERROR: out of memory\n", modname);
+      return -1;
+    }
+    src->inputs = in;
+    in += src->input_count++;
+    memset(in, 0, sizeof(LCEC_REPLAY_INPUT_T));
+
+    if (parse_entry_name(field, &position, &index, &subindex) == 0) {
+      in->entry = lcec_sim_get_entry(master, position, index, subindex);
+      if (in->entry == NULL) {
+        fprintf(stderr, "%s: ERROR: PDO entry %s is not configured\n", modname, field);
+        return -1;
+      }
+      lcec_sim_entry_info(in->entry, &in->info);
+      if (in->info.dir != EC_DIR_INPUT || in->info.bit_length > 64) {
+        fprintf(stderr, "%s: ERROR: PDO entry %s is not an input of up to 64 bits\n", modname, field);
+        return -1;
+      }
+      continue;
+    }
+
+    in->pin = lcec_fakehal_find_pin(field);
+    if (in->pin == NULL) {
+      fprintf(stderr, "%s: ERROR: column %s is neither a PDO entry nor a pin\n", modname, field);
+      return -1;
+    }
+  }
+
+  return csv_next_row(src);
+}
+
+static int capture_open(LCEC_REPLAY_SRC_T *src, ec_master_t *master, FILE *file) {
+  const LCEC_REC_FILE_HEADER_T *hdr;
+  const LCEC_TAP_ENTRY_T *entry;
+  LCEC_REPLAY_INPUT_T *in;
+  lcec_sim_entry_t *sim_entry;
+  LCEC_SIM_ENTRY_INFO_T info;
+  long size;
+  uint32_t i;
+
+  // read whole file
+  if (fseek(file, 0, SEEK_END) != 0 || (size = ftell(file)) < 0 || fseek(file, 0, SEEK_SET) != 0) {
+    fprintf(stderr, "%s: ERROR: unable to get size of capture file\n", modname);
+    return -1;
+  }
+  src->capture = malloc(size + 1);
+  if (src->capture == NULL) {
+    fprintf(stderr, "%s: ERROR: out of memory\n", modname);
+    return -1;
+  }
+  if (fread(src->capture, 1, size, file) != (size_t) size) {
+    fprintf(stderr, "%s: ERROR: unable to read capture file\n", modname);
+    return -1;
+  }
+
+  // validate header
+  hdr = (const LCEC_REC_FILE_HEADER_T *) src->capture;
+  if ((size_t) size < sizeof(LCEC_REC_FILE_HEADER_T) || hdr->version != LCEC_REC_VERSION || hdr->header_size != sizeof(LCEC_REC_FILE_HEADER_T) ||
+      hdr->slot_data_offset + hdr->data_len > hdr->slot_size ||
+      (size_t) size < hdr->header_size + (size_t) hdr->entry_count * sizeof(LCEC_TAP_ENTRY_T) + (size_t) hdr->slot_count * hdr->slot_size) {
+    fprintf(stderr, "%s: ERROR: invalid capture file\n", modname);
+    return -1;
+  }
+  src->capture_hdr = hdr;
+  src->capture_slots = src->capture + hdr->header_size + (size_t) hdr->entry_count * sizeof(LCEC_TAP_ENTRY_T);
+  src->length = hdr->slot_count;
+
+  // map captured input entries to the configured ones
+  src->inputs = calloc(hdr->entry_count + 1, sizeof(LCEC_REPLAY_INPUT_T));
+  if (src->inputs == NULL) {
+    fprintf(stderr, "%s: ERROR: out of memory\n", modname);
+    return -1;
+  }
+  entry = (const LCEC_TAP_ENTRY_T *) (src->capture + hdr->header_size);
+  for (i = 0; i < hdr->entry_count; i++, entry++) {
+    sim_entry = lcec_sim_get_entry(master, entry->slave_pos, entry->pdo_index, entry->pdo_subindex);
+    if (sim_entry == NULL) {
+      continue;
+    }
+    lcec_sim_entry_info(sim_entry, &info);
+    if (info.dir != EC_DIR_INPUT) {
+      continue;
+    }
+    if (entry->offset + (entry->bit_position + info.bit_length + 7) / 8 > hdr->data_len) {
+      fprintf(stderr, "%s: WARNING: entry %u:0x%04x:0x%02x exceeds captured image, skipped\n", modname,
+        entry->slave_pos, entry->pdo_index, entry->pdo_subindex);
+      continue;
+    }
+
+    in = &src->inputs[src->input_count++];
+    in->entry = sim_entry;
+    in->info = info;
+    in->src_offset = entry->offset;
+    in->src_bit = entry->bit_position;
+  }
+
+  if (src->input_count == 0) {
+    fprintf(stderr, "%s: WARNING: no captured input entry matches the configuration\n", modname);
+  }
+  return 0;
+}
+
+static int src_open(LCEC_REPLAY_SRC_T *src, ec_master_t *master, const char *filename) {
+  FILE *file;
+  char magic[sizeof(LCEC_REC_FILE_MAGIC) - 1];
+  int ret;
+
+  memset(src, 0, sizeof(LCEC_REPLAY_SRC_T));
+
+  file = fopen(filename, "r");
+  if (file == NULL) {
+    fprintf(stderr, "%s: ERROR: unable to open input file %s\n", modname, filename);
+    return -1;
+  }
+
+  src->is_capture = (fread(magic, 1, sizeof(magic), file) == sizeof(magic) && memcmp(magic, LCEC_REC_FILE_MAGIC, sizeof(magic)) == 0);
+  rewind(file);
+
+  if (src->is_capture) {
+    ret = capture_open(src, master, file);
+    fclose(file);
+    return ret;
+  }
+
+  return csv_open(src, master, file);
+}
+
+static void src_close(LCEC_REPLAY_SRC_T *src) {
+  if (src->file != NULL) {
+    fclose(src->file);
+  }
+  free(src->line);
+  free(src->capture);
+  free(src->inputs);
+}
+
+// prepare inputs for the given cycle, returns 1 if there are no more
+static int src_seek(LCEC_REPLAY_SRC_T *src, unsigned long cycle) {
+  if (src->is_capture) {
+    if (cycle >= src->length) {
+      return 1;
+    }
+    src->slot_data = src->capture_slots + (size_t) src->capture_hdr->slot_size * cycle + src->capture_hdr->slot_data_offset;
+    return 0;
+  }
+
+  while (src->row_valid && src->row_cycle <= cycle) {
+    if (csv_apply_row(src) != 0 || csv_next_row(src) != 0) {
+      return -1;
+    }
+  }
+  return (cycle >= src->length);
+}
+
+static void replay_hook(ec_master_t *master, void *arg) {
+  LCEC_REPLAY_SRC_T *src = (LCEC_REPLAY_SRC_T *) arg;
+  LCEC_REPLAY_INPUT_T *in;
+  uint8_t buf[8];
+  int i;
+
+  for (i = 0, in = src->inputs; i < src->input_count; i++, in++) {
+    if (in->entry == NULL) {
+      continue;
+    }
+    if (src->is_capture) {
+      copy_bits(in->info.data, in->info.bit_position, src->slot_data + in->src_offset, in->src_bit, in->info.bit_length);
+    } else if (in->valid) {
+      EC_WRITE_S64(buf, in->value);
+      copy_bits(in->info.data, in->info.bit_position, buf, 0, in->info.bit_length);
+    }
+  }
+}
+
+static int log_init(LCEC_REPLAY_LOG_T *log, ec_master_t *master, const char *prefix, int image) {
+  LCEC_FAKEHAL_PIN_T *pin;
+  lcec_sim_entry_t *entry;
+  LCEC_SIM_ENTRY_INFO_T info;
+  uint8_t *end;
+  int i;
+
+  memset(log, 0, sizeof(LCEC_REPLAY_LOG_T));
+
+  for (i = 0; i < 2; i++) {
+    log->pin_count = 0;
+    for (pin = lcec_fakehal_first_pin(); pin != NULL; pin = pin->next) {
+      if (pin->is_param || (prefix != NULL && strncmp(pin->name, prefix, strlen(prefix)) != 0)) {
+        continue;
+      }
+      if (log->pins != NULL) {
+        log->pins[log->pin_count] = pin;
+      }
+      log->pin_count++;
+    }
+
+    log->entry_count = 0;
+    end = NULL;
+    for (entry = lcec_sim_next_entry(master, NULL); entry != NULL; entry = lcec_sim_next_entry(master, entry)) {
+      lcec_sim_entry_info(entry, &info);
+      if (log->image == NULL || info.data < log->image) {
+        log->image = info.data;
+      }
+      if (end == NULL || info.data + (info.bit_position + info.bit_length + 7) / 8 > end) {
+        end = info.data + (info.bit_position + info.bit_length + 7) / 8;
+      }
+      if (info.dir != EC_DIR_OUTPUT) {
+        continue;
+      }
+      if (log->entries != NULL) {
+        log->entries[log->entry_count] = entry;
+      }
+      log->entry_count++;
+    }
+    log->image_len = image ? end - log->image : 0;
+
+    if (i == 0) {
+      log->pins = calloc(log->pin_count + 1, sizeof(LCEC_FAKEHAL_PIN_T *));
+      log->entries = calloc(log->entry_count + 1, sizeof(lcec_sim_entry_t *));
+      if (log->pins == NULL || log->entries == NULL) {
+        fprintf(stderr, "%s: ERROR: out of memory\n", modname);
+        return -1;
+      }
+    }
+  }
+
+  return 0;
+}
+
+static void log_header(FILE *out, const LCEC_REPLAY_LOG_T *log) {
+  LCEC_SIM_ENTRY_INFO_T info;
+  int i;
+
+  fprintf(out, "cycle");
+  for (i = 0; i < log->pin_count; i++) {
+    fprintf(out, ",%s", log->pins[i]->name);
+  }
+  for (i = 0; i < log->entry_count; i++) {
+    lcec_sim_entry_info(log->entries[i], &info);
+    fprintf(out, ",%u:0x%04x:0x%02x", info.position, info.index, info.subindex);
+  }
+  if (log->image_len > 0) {
+    fprintf(out, ",image");
+  }
+  fprintf(out, "\n");
+}
+
+static void log_cycle(FILE *out, const LCEC_REPLAY_LOG_T *log, unsigned long cycle) {
+  size_t j;
+  int i;
+
+  fprintf(out, "%lu", cycle);
+  for (i = 0; i < log->pin_count; i++) {
+    print_pin(out, log->pins[i]);
+  }
+  for (i = 0; i < log->entry_count; i++) {
+    print_entry(out, log->entries[i]);
+  }
+  if (log->image_len > 0) {
+    fprintf(out, ",");
+    for (j = 0; j < log->image_len; j++) {
+      fprintf(out, "%02x", log->image[j]);
+    }
+  }
+  fprintf(out, "\n");
+}
+
+static void log_free(LCEC_REPLAY_LOG_T *log) {
+  free(log->pins);
+  free(log->entries);
+}
+
+static int all_op(void) {
+  LCEC_FAKEHAL_PIN_T *pin;
+  size_t len;
+
+  for (pin = lcec_fakehal_first_pin(); pin != NULL; pin = pin->next) {
+    len = strlen(pin->name);
+    if (pin->type == HAL_BIT && len > 7 && strcmp(pin->name + len - 7, ".all-op") == 0 && !*((hal_bit_t *) pin->data)) {
+      return 0;
+    }
+  }
+
+  return 1;
+}
+
+static double wall_time(void) {
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static void usage(void) {
+  fprintf(stderr, "usage: %s [-m master-idx] [-p period-ns] [-w warmup-cycles] [-n cycles] [-f pin-prefix] [-o output] [-i] <ethercat-conf.xml> <input>\n", modname);
+}
+
+int main(int argc, char **argv) {
+  int ret = 1;
+  int opt;
+  int master_idx = 0;
+  long period = 0;
+  unsigned long warmup = LCEC_REPLAY_WARMUP;
+  unsigned long cycles = 0;
+  unsigned long cycle, i;
+  const char *prefix = NULL;
+  const char *out_name = NULL;
+  int image = 0;
+  LCEC_CONF_OUTBUF_T outputBuf;
+  LCEC_CONF_HEADER_T *header;
+  void *shmem_ptr;
+  int shmem_id;
+  ec_master_t *master;
+  LCEC_FAKEHAL_FUNCT_T *read_funct, *write_funct;
+  LCEC_REPLAY_SRC_T src;
+  LCEC_REPLAY_LOG_T log;
+  FILE *out;
+  long long now;
+  double start;
+  int err;
+
+  modname = "lcec_replay";
+
+  while ((opt = getopt(argc, argv, "m:p:w:n:f:o:ih")) != -1) {
+    switch (opt) {
+      case 'm':
+        master_idx = atoi(optarg);
+        break;
+      case 'p':
+        period = atol(optarg);
+        break;
+      case 'w':
+        warmup = strtoul(optarg, NULL, 0);
+        break;
+      case 'n':
+        cycles = strtoul(optarg, NULL, 0);
+        break;
+      case 'f':
+        prefix = optarg;
+        break;
+      case 'o':
+        out_name = optarg;
+        break;
+      case 'i':
+        image = 1;
+        break;
+      default:
+        usage();
+        return 1;
+    }
+  }
+  if (argc - optind != 2 || period < 0) {
+    usage();
+    return 1;
+  }
+
+  // virtual clock
+  now = 0;
+  lcec_fakehal_set_time(now);
+
+  // parse config and publish it like lcec_conf does
+  if (parseConfig(argv[optind], &outputBuf, NULL)) {
+    goto fail0;
+  }
+  shmem_id = rtapi_shmem_new(LCEC_CONF_SHMEM_KEY, 0, sizeof(LCEC_CONF_HEADER_T) + outputBuf.len);
+  if (shmem_id < 0 || lcec_rtapi_shmem_getptr(shmem_id, &shmem_ptr) < 0) {
+    fprintf(stderr, "%s: ERROR: couldn't allocate config shared memory\n", modname);
+    copyFreeOutputBuffer(&outputBuf, NULL);
+    goto fail0;
+  }
+  header = shmem_ptr;
+  header->magic = LCEC_CONF_SHMEM_MAGIC;
+  header->length = outputBuf.len;
+  copyFreeOutputBuffer(&outputBuf, shmem_ptr + sizeof(LCEC_CONF_HEADER_T));
+
+  // start driver
+  if (rtapi_app_main() != 0) {
+    fprintf(stderr, "%s: ERROR: driver initialization failed\n", modname);
+    goto fail1;
+  }
+
+  master = lcec_sim_get_master(master_idx);
+  read_funct = lcec_fakehal_find_funct(LCEC_MODULE_NAME ".read-all");
+  write_funct = lcec_fakehal_find_funct(LCEC_MODULE_NAME ".write-all");
+  if (master == NULL) {
+    fprintf(stderr, "%s: ERROR: master %d is not configured\n", modname, master_idx);
+    goto fail2;
+  }
+  if (read_funct == NULL || write_funct == NULL) {
+    fprintf(stderr, "%s: ERROR: driver functions not found\n", modname);
+    goto fail2;
+  }
+
+  // open input and output
+  if (src_open(&src, master, argv[optind + 1]) != 0) {
+    goto fail3;
+  }
+  if (period == 0) {
+    period = (src.is_capture && src.capture_hdr->period > 0) ? src.capture_hdr->period : LCEC_REPLAY_PERIOD;
+  }
+  lcec_sim_set_receive_hook(master, replay_hook, &src);
+
+  if (log_init(&log, master, prefix, image) != 0) {
+    goto fail4;
+  }
+  out = (out_name != NULL) ? fopen(out_name, "w") : stdout;
+  if (out == NULL) {
+    fprintf(stderr, "%s: ERROR: unable to open output file %s\n", modname, out_name);
+    goto fail4;
+  }
+  setvbuf(out, NULL, _IOFBF, LCEC_REPLAY_OUTBUF);
+
+  // bring slaves to OP with the inputs of cycle 0
+  if (src_seek(&src, 0) < 0) {
+    goto fail5;
+  }
+  for (i = 0; i < warmup && !all_op(); i++) {
+    read_funct->funct(read_funct->arg, period);
+    write_funct->funct(write_funct->arg, period);
+    now += period;
+    lcec_fakehal_set_time(now);
+  }
+  if (!all_op()) {
+    fprintf(stderr, "%s: WARNING: slaves not operational after %lu warmup cycles\n", modname, warmup);
+  }
+
+  // replay
+  log_header(out, &log);
+  start = wall_time();
+  for (cycle = 0; cycles == 0 || cycle < cycles; cycle++) {
+    err = src_seek(&src, cycle);
+    if (err < 0) {
+      goto fail5;
+    }
+    if (err > 0 && cycles == 0) {
+      break;
+    }
+
+    read_funct->funct(read_funct->arg, period);
+    write_funct->funct(write_funct->arg, period);
+    log_cycle(out, &log, cycle);
+
+    now += period;
+    lcec_fakehal_set_time(now);
+  }
+
+  if (cycle > 0) {
+    fprintf(stderr, "%s: %lu cycles, %.1fx real time\n", modname, cycle,
+      (double) cycle * period * 1e-9 / (wall_time() - start));
+  }
+  ret = 0;
+
+fail5:
+  if (out != stdout) {
+    fclose(out);
+  }
+fail4:
+  log_free(&log);
+fail3:
+  src_close(&src);
+fail2:
+  rtapi_app_exit();
+fail1:
+  rtapi_shmem_delete(shmem_id, 0);
+fail0:
+  return ret;
+}
+
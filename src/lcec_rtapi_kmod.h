@@ -24,6 +24,8 @@
 #include <linux/time.h>
 #include <linux/sched.h>
 #include <linux/math64.h>
+#include <linux/errno.h>
+#include <asm/barrier.h>
 
 #define lcec_zalloc(size) kzalloc(size, GFP_KERNEL)
 #define lcec_free(ptr) kfree(ptr)
@@ -41,5 +43,25 @@ static inline long long lcec_mod_64(long long val, unsigned long div) {
   return rem;
 }
 
+#define lcec_atomic_load(ptr) smp_load_acquire(ptr)
+#define lcec_atomic_store(ptr, val) smp_store_release(ptr, val)
+#define lcec_wmb() smp_wmb()
+#define lcec_mb() smp_mb()
+
+#define lcec_cpu_relax() cpu_relax()
+
+// helper threads are not supported in kernel mode
+typedef int lcec_thread_t;
+
+static inline int lcec_thread_create(lcec_thread_t *thread, void *(*fn)(void *), void *arg, int cpu) {
+  return -ENOSYS;
+}
+
+#define lcec_thread_join(thread) do { } while (0)
+
+#define lcec_get_cpu() raw_smp_processor_id()
+#define lcec_futex_wait(addr, val) cpu_relax()
+#define lcec_futex_wake(addr) do { } while (0)
+
 #endif
 
@@ -24,6 +24,11 @@
 #include <time.h>
 #include <sys/time.h>
 #include <sched.h>
+#include <pthread.h>
+#include <limits.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
 
 static inline void *lcec_zalloc(size_t size) {
   void *p = malloc(size);
@@ -47,5 +52,52 @@ static inline long long lcec_mod_64(long long val, unsigned long div) {
   return val % div;
 }
 
+#define lcec_atomic_load(ptr) __atomic_load_n(ptr, __ATOMIC_ACQUIRE)
+#define lcec_atomic_store(ptr, val) __atomic_store_n(ptr, val, __ATOMIC_RELEASE)
+#define lcec_wmb() __atomic_thread_fence(__ATOMIC_RELEASE)
+#define lcec_mb() __atomic_thread_fence(__ATOMIC_SEQ_CST)
+
+#if defined(__i386__) || defined(__x86_64__)
+  #define lcec_cpu_relax() __builtin_ia32_pause()
+#else
+  #define lcec_cpu_relax() __atomic_signal_fence(__ATOMIC_SEQ_CST)
+#endif
+
+typedef pthread_t lcec_thread_t;
+
+static inline int lcec_thread_create(lcec_thread_t *thread, void *(*fn)(void *), void *arg, int cpu) {
+  pthread_attr_t attr;
+  struct sched_param param;
+  cpu_set_t cpus;
+  int ret;
+
+  // realtime thread pinned to given cpu
+  pthread_attr_init(&attr);
+  pthread_attr_setinheritsched(&attr, PTHREAD_EXPLICIT_SCHED);
+  pthread_attr_setschedpolicy(&attr, SCHED_FIFO);
+  param.sched_priority = sched_get_priority_max(SCHED_FIFO) - 1;
+  pthread_attr_setschedparam(&attr, &param);
+  CPU_ZERO(&cpus);
+  CPU_SET(cpu, &cpus);
+  pthread_attr_setaffinity_np(&attr, sizeof(cpus), &cpus);
+
+  ret = pthread_create(thread, &attr, fn, arg);
+  pthread_attr_destroy(&attr);
+  return ret;
+}
+
+#define lcec_thread_join(thread) pthread_join(thread, NULL)
+
+#define lcec_get_cpu() sched_getcpu()
+
+// sleep while *addr == val (may return early)
+static inline void lcec_futex_wait(unsigned int *addr, unsigned int val) {
+  syscall(SYS_futex, addr, FUTEX_WAIT_PRIVATE, val, NULL, NULL, 0);
+}
+
+static inline void lcec_futex_wake(unsigned int *addr) {
+  syscall(SYS_futex, addr, FUTEX_WAKE_PRIVATE, INT_MAX, NULL, NULL, 0);
+}
+
 #endif
 
@@ -0,0 +1,1180 @@
+//
+//    Copyright (C) 2026 Sascha Ittner <sascha.ittner@modusoft.de>
+//
+//    This program is free software; you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation; either version 2 of the License, or
+//    (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with this program; if not, write to the Free Software
+//    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301 USA
+//
+
+//
+// Simulated EtherCAT master
+//
+// Implements the subset of the IgH ecrt API used by this driver, so
+// lcec.so can be linked against it instead of libethercat (make
+// LCEC_SIM=1). All configured slaves are assumed to be present. PDO
+// entries are mapped like the real master does: every sync manager
+// of a slave used in a domain gets one contiguous FMMU area in the
+// order of the first registration. Entries without PDO configuration
+// get their own area of 4 bytes. Bit entries without PDO configuration
+// that a slave registers one after the other share one area and are
+// packed back to back, like the default mapping of digital terminals.
+// The slave info calls report these entries as one PDO per direction.
+//
+// After activation the slaves walk through INIT, PREOP, SAFEOP and OP
+// (LCEC_SIM_STATE_CYCLES cycles each). The working counter follows
+// the IgH rules (+1 for inputs, +2 for outputs per slave and domain).
+//
+// Behavioural slave models:
+//   - CiA402 drives (0x6040/0x6041 mapped): state machine, actual
+//     position/velocity follow target values, mode display follows mode
+//   - digital loopback: output bit n of the bus (0x7xxx entries)
+//     drives input bit n (0x6xxx entries)
+//
+// Tools linking the simulator directly can reach the process image
+// through the lcec_sim.h interface (entry lookup and a hook that runs
+// after the models on every receive).
+//
+
+#include <errno.h>
+
+#include "lcec.h"
+#include "lcec_sim.h"
+
+#define LCEC_SIM_STATE_CYCLES 10
+#define LCEC_SIM_NONE_SIZE    4
+
+typedef struct lcec_sim_sm {
+  uint8_t index;
+  ec_direction_t dir;
+  unsigned int bit_size;
+  unsigned int pdo_count;
+  ec_pdo_info_t *pdos;
+} lcec_sim_sm_t;
+
+typedef struct lcec_sim_fmmu {
+  struct lcec_sim_fmmu *next;
+  ec_slave_config_t *sc;
+  const lcec_sim_sm_t *sm;
+  ec_direction_t dir;
+  unsigned int offset;
+  unsigned int bit_size;
+} lcec_sim_fmmu_t;
+
+typedef struct lcec_sim_reg {
+  struct lcec_sim_reg *next;
+  ec_slave_config_t *sc;
+  ec_domain_t *domain;
+  uint16_t index;
+  uint8_t subindex;
+  uint8_t bit_length;
+  ec_direction_t dir;
+  unsigned int offset;
+  unsigned int bit_position;
+} lcec_sim_reg_t;
+
+typedef struct {
+  ec_slave_config_t *sc;
+  unsigned int dirs;
+} lcec_sim_wc_t;
+
+typedef struct lcec_sim_sdo {
+  struct lcec_sim_sdo *next;
+  uint16_t index;
+  uint8_t subindex;
+  size_t size;
+  uint8_t data[];
+} lcec_sim_sdo_t;
+
+typedef struct {
+  lcec_sim_reg_t *control;
+  lcec_sim_reg_t *status;
+  lcec_sim_reg_t *mode;
+  lcec_sim_reg_t *mode_display;
+  lcec_sim_reg_t *target_pos;
+  lcec_sim_reg_t *actual_pos;
+  lcec_sim_reg_t *target_vel;
+  lcec_sim_reg_t *actual_vel;
+  uint16_t state;
+  int fault_reset_last;
+} lcec_sim_cia402_t;
+
+struct ec_slave_config {
+  struct ec_slave_config *next;
+  ec_master_t *master;
+  uint16_t alias;
+  uint16_t position;
+  uint32_t vendor_id;
+  uint32_t product_code;
+  int dc_enabled;
+  unsigned int al_state;
+  unsigned int sm_count;
+  lcec_sim_sm_t sms[EC_MAX_SYNC_MANAGERS];
+  lcec_sim_reg_t *first_reg;
+  lcec_sim_reg_t *last_reg;
+  lcec_sim_sdo_t *first_sdo;
+  lcec_sim_cia402_t *cia402;
+};
+
+struct ec_domain {
+  struct ec_domain *next;
+  ec_master_t *master;
+  lcec_sim_fmmu_t *first_fmmu;
+  lcec_sim_fmmu_t *last_fmmu;
+  lcec_sim_wc_t *wc_slaves;
+  unsigned int wc_slave_count;
+  size_t size;
+  uint8_t *data;
+  uint8_t *internal_data;
+  unsigned int expected_wc;
+  unsigned int wc;
+  int queued;
+  int in_flight;
+  ec_domain_state_t state;
+};
+
+struct ec_master {
+  struct ec_master *next;
+  unsigned int index;
+  int active;
+  unsigned int cycle;
+  uint64_t app_time;
+  ec_slave_config_t *first_sc;
+  ec_slave_config_t *last_sc;
+  ec_domain_t *first_domain;
+  ec_domain_t *last_domain;
+  lcec_sim_hook_t receive_hook;
+  void *receive_hook_arg;
+};
+
+static ec_master_t *lcec_sim_masters = NULL;
+
+static void lcec_sim_free_sc(ec_slave_config_t *sc);
+static int lcec_sim_add_sdo(ec_slave_config_t *sc, uint16_t index, uint8_t subindex, const uint8_t *data, size_t size);
+static int lcec_sim_find_entry(ec_slave_config_t *sc, uint16_t index, uint8_t subindex, const lcec_sim_sm_t **sm, unsigned int *bit_offset, uint8_t *bit_length);
+static void lcec_sim_setup_models(ec_master_t *master);
+static void lcec_sim_exchange(ec_domain_t *domain);
+static void lcec_sim_run_models(ec_master_t *master);
+
+static inline uint8_t *lcec_sim_reg_ptr(const lcec_sim_reg_t *reg) {
+  return reg->domain->data + reg->offset;
+}
+
+static int64_t lcec_sim_reg_get(const lcec_sim_reg_t *reg) {
+  uint8_t *p = lcec_sim_reg_ptr(reg);
+
+  switch (reg->bit_length) {
+    case 1:
+      return EC_READ_BIT(p, reg->bit_position);
+    case 8:
+      return EC_READ_S8(p);
+    case 16:
+      return EC_READ_S16(p);
+    case 32:
+      return EC_READ_S32(p);
+    case 64:
+      return EC_READ_S64(p);
+  }
+  return 0;
+}
+
+static void lcec_sim_reg_set(const lcec_sim_reg_t *reg, int64_t val) {
+  uint8_t *p = lcec_sim_reg_ptr(reg);
+
+  switch (reg->bit_length) {
+    case 1:
+      EC_WRITE_BIT(p, reg->bit_position, val != 0);
+      break;
+    case 8:
+      EC_WRITE_S8(p, val);
+      break;
+    case 16:
+      EC_WRITE_S16(p, val);
+      break;
+    case 32:
+      EC_WRITE_S32(p, val);
+      break;
+    case 64:
+      EC_WRITE_S64(p, val);
+      break;
+  }
+}
+
+ec_master_t *ecrt_request_master(unsigned int master_index) {
+  ec_master_t *master;
+
+  master = lcec_zalloc(sizeof(ec_master_t));
+  if (master == NULL) {
+    return NULL;
+  }
+  master->index = master_index;
+  master->next = lcec_sim_masters;
+  lcec_sim_masters = master;
+
+  rtapi_print_msg(RTAPI_MSG_INFO, LCEC_MSG_PFX "using simulated master %u\n", master_index);
+  return master;
+}
+
+void ecrt_release_master(ec_master_t *master) {
+  ec_slave_config_t *sc, *next_sc;
+  ec_domain_t *domain, *next_domain;
+  lcec_sim_fmmu_t *fmmu, *next_fmmu;
+  ec_master_t **link;
+
+  for (link = &lcec_sim_masters; *link != NULL; link = &(*link)->next) {
+    if (*link == master) {
+      *link = master->next;
+      break;
+    }
+  }
+
+  for (sc = master->first_sc; sc != NULL; sc = next_sc) {
+    next_sc = sc->next;
+    lcec_sim_free_sc(sc);
+  }
+
+  for (domain = master->first_domain; domain != NULL; domain = next_domain) {
+    next_domain = domain->next;
+    for (fmmu = domain->first_fmmu; fmmu != NULL; fmmu = next_fmmu) {
+      next_fmmu = fmmu->next;
+      lcec_free(fmmu);
+    }
+    if (domain->internal_data != NULL) {
+      lcec_free(domain->internal_data);
+    }
+    if (domain->wc_slaves != NULL) {
+      lcec_free(domain->wc_slaves);
+    }
+    lcec_free(domain);
+  }
+
+  lcec_free(master);
+}
+
+void ecrt_master_callbacks(ec_master_t *master, void (*send_cb)(void *), void (*receive_cb)(void *), void *cb_data) {
+}
+
+ec_domain_t *ecrt_master_create_domain(ec_master_t *master) {
+  ec_domain_t *domain;
+
+  domain = lcec_zalloc(sizeof(ec_domain_t));
+  if (domain == NULL) {
+    return NULL;
+  }
+  domain->master = master;
+
+  if (master->last_domain != NULL) {
+    master->last_domain->next = domain;
+  } else {
+    master->first_domain = domain;
+  }
+  master->last_domain = domain;
+
+  return domain;
+}
+
+ec_slave_config_t *ecrt_master_slave_config(ec_master_t *master, uint16_t alias, uint16_t position, uint32_t vendor_id, uint32_t product_code) {
+  ec_slave_config_t *sc;
+
+  for (sc = master->first_sc; sc != NULL; sc = sc->next) {
+    if (sc->alias == alias && sc->position == position) {
+      if (sc->vendor_id != vendor_id || sc->product_code != product_code) {
+        rtapi_print_msg(RTAPI_MSG_ERR, LCEC_MSG_PFX "sim: slave %u:%u already configured with other type\n", alias, position);
+        return NULL;
+      }
+      return sc;
+    }
+  }
+
+  sc = lcec_zalloc(sizeof(ec_slave_config_t));
+  if (sc == NULL) {
+    return NULL;
+  }
+  sc->master = master;
+  sc->alias = alias;
+  sc->position = position;
+  sc->vendor_id = vendor_id;
+  sc->product_code = product_code;
+
+  if (master->last_sc != NULL) {
+    master->last_sc->next = sc;
+  } else {
+    master->first_sc = sc;
+  }
+  master->last_sc = sc;
+
+  return sc;
+}
+
+static void lcec_sim_free_sc(ec_slave_config_t *sc) {
+  lcec_sim_reg_t *reg, *next_reg;
+  lcec_sim_sdo_t *sdo, *next_sdo;
+  unsigned int i, j;
+
+  for (reg = sc->first_reg; reg != NULL; reg = next_reg) {
+    next_reg = reg->next;
+    lcec_free(reg);
+  }
+  for (sdo = sc->first_sdo; sdo != NULL; sdo = next_sdo) {
+    next_sdo = sdo->next;
+    lcec_free(sdo);
+  }
+  for (i = 0; i < sc->sm_count; i++) {
+    if (sc->sms[i].pdos != NULL) {
+      for (j = 0; j < sc->sms[i].pdo_count; j++) {
+        if (sc->sms[i].pdos[j].entries != NULL) {
+          lcec_free(sc->sms[i].pdos[j].entries);
+        }
+      }
+      lcec_free(sc->sms[i].pdos);
+    }
+  }
+  if (sc->cia402 != NULL) {
+    lcec_free(sc->cia402);
+  }
+  lcec_free(sc);
+}
+
+int ecrt_slave_config_pdos(ec_slave_config_t *sc, unsigned int n_syncs, const ec_sync_info_t syncs[]) {
+  const ec_sync_info_t *sync;
+  lcec_sim_sm_t *sm;
+  const ec_pdo_info_t *pdo;
+  unsigned int i, j, k;
+
+  for (i = 0, sync = syncs; i < n_syncs && sync->index != 0xff; i++, sync++) {
+    if (sync->index >= EC_MAX_SYNC_MANAGERS || sc->sm_count >= EC_MAX_SYNC_MANAGERS) {
+      return -EINVAL;
+    }
+
+    // copy sync manager, PDOs and entries
+    sm = &sc->sms[sc->sm_count++];
+    sm->index = sync->index;
+    sm->dir = sync->dir;
+    sm->pdo_count = sync->n_pdos;
+    sm->bit_size = 0;
+    if (sync->n_pdos == 0 || sync->pdos == NULL) {
+      sm->pdo_count = 0;
+      continue;
+    }
+    sm->pdos = lcec_zalloc(sizeof(ec_pdo_info_t) * sync->n_pdos);
+    if (sm->pdos == NULL) {
+      return -ENOMEM;
+    }
+    for (j = 0, pdo = sync->pdos; j < sync->n_pdos; j++, pdo++) {
+      sm->pdos[j].index = pdo->index;
+      if (pdo->n_entries == 0 || pdo->entries == NULL) {
+        continue;
+      }
+      sm->pdos[j].entries = lcec_zalloc(sizeof(ec_pdo_entry_info_t) * pdo->n_entries);
+      if (sm->pdos[j].entries == NULL) {
+        return -ENOMEM;
+      }
+      sm->pdos[j].n_entries = pdo->n_entries;
+      for (k = 0; k < pdo->n_entries; k++) {
+        sm->pdos[j].entries[k] = pdo->entries[k];
+        sm->bit_size += pdo->entries[k].bit_length;
+      }
+    }
+  }
+
+  return 0;
+}
+
+static int lcec_sim_add_sdo(ec_slave_config_t *sc, uint16_t index, uint8_t subindex, const uint8_t *data, size_t size) {
+  lcec_sim_sdo_t *sdo;
+
+  // later writes overwrite earlier ones
+  for (sdo = sc->first_sdo; sdo != NULL; sdo = sdo->next) {
+    if (sdo->index == index && sdo->subindex == subindex && sdo->size == size) {
+      memcpy(sdo->data, data, size);
+      return 0;
+    }
+  }
+
+  sdo = lcec_zalloc(sizeof(lcec_sim_sdo_t) + size);
+  if (sdo == NULL) {
+    return -ENOMEM;
+  }
+  sdo->index = index;
+  sdo->subindex = subindex;
+  sdo->size = size;
+  memcpy(sdo->data, data, size);
+  sdo->next = sc->first_sdo;
+  sc->first_sdo = sdo;
+
+  return 0;
+}
+
+int ecrt_slave_config_sdo(ec_slave_config_t *sc, uint16_t index, uint8_t subindex, const uint8_t *data, size_t size) {
+  return lcec_sim_add_sdo(sc, index, subindex, data, size);
+}
+
+int ecrt_slave_config_sdo8(ec_slave_config_t *sc, uint16_t sdo_index, uint8_t sdo_subindex, uint8_t value) {
+  return lcec_sim_add_sdo(sc, sdo_index, sdo_subindex, &value, 1);
+}
+
+int ecrt_slave_config_complete_sdo(ec_slave_config_t *sc, uint16_t index, const uint8_t *data, size_t size) {
+  return lcec_sim_add_sdo(sc, index, 0, data, size);
+}
+
+int ecrt_slave_config_idn(ec_slave_config_t *sc, uint8_t drive_no, uint16_t idn, ec_al_state_t state, const uint8_t *data, size_t size) {
+  return 0;
+}
+
+void ecrt_slave_config_dc(ec_slave_config_t *sc, uint16_t assign_activate, uint32_t sync0_cycle, int32_t sync0_shift, uint32_t sync1_cycle, int32_t sync1_shift) {
+  sc->dc_enabled = (assign_activate != 0);
+}
+
+void ecrt_slave_config_watchdog(ec_slave_config_t *sc, uint16_t watchdog_divider, uint16_t watchdog_intervals) {
+}
+
+void ecrt_slave_config_state(const ec_slave_config_t *sc, ec_slave_config_state_t *state) {
+  memset(state, 0, sizeof(ec_slave_config_state_t));
+  state->online = sc->master->active;
+  state->operational = (sc->al_state == EC_AL_STATE_OP);
+  state->al_state = sc->al_state;
+  state->position = sc->position;
+}
+
+static int lcec_sim_find_entry(ec_slave_config_t *sc, uint16_t index, uint8_t subindex, const lcec_sim_sm_t **sm, unsigned int *bit_offset, uint8_t *bit_length) {
+  const lcec_sim_sm_t *s;
+  const ec_pdo_info_t *pdo;
+  const ec_pdo_entry_info_t *entry;
+  unsigned int i, j, k, offs;
+
+  for (i = 0, s = sc->sms; i < sc->sm_count; i++, s++) {
+    offs = 0;
+    for (j = 0, pdo = s->pdos; j < s->pdo_count; j++, pdo++) {
+      for (k = 0, entry = pdo->entries; k < pdo->n_entries; k++, entry++) {
+        if (entry->index == index && entry->subindex == subindex) {
+          *sm = s;
+          *bit_offset = offs;
+          *bit_length = entry->bit_length;
+          return 0;
+        }
+        offs += entry->bit_length;
+      }
+    }
+  }
+
+  return -ENOENT;
+}
+
+int ecrt_domain_reg_pdo_entry_list(ec_domain_t *domain, const ec_pdo_entry_reg_t *pdo_entry_regs) {
+  ec_master_t *master = domain->master;
+  const ec_pdo_entry_reg_t *pdo_reg;
+  ec_slave_config_t *sc;
+  const lcec_sim_sm_t *sm;
+  lcec_sim_fmmu_t *fmmu;
+  lcec_sim_reg_t *reg;
+  unsigned int bit_offset;
+  uint8_t bit_length;
+
+  sc = NULL;
+  for (pdo_reg = pdo_entry_regs; pdo_reg->index != 0; pdo_reg++) {
+    // registrations are grouped by slave, avoid a lookup for every entry
+    if (sc == NULL || sc->position != pdo_reg->position || sc->alias != pdo_reg->alias) {
+      sc = ecrt_master_slave_config(master, pdo_reg->alias, pdo_reg->position, pdo_reg->vendor_id, pdo_reg->product_code);
+      if (sc == NULL) {
+        return -ENOENT;
+      }
+    }
+
+    reg = lcec_zalloc(sizeof(lcec_sim_reg_t));
+    if (reg == NULL) {
+      return -ENOMEM;
+    }
+    reg->sc = sc;
+    reg->domain = domain;
+    reg->index = pdo_reg->index;
+    reg->subindex = pdo_reg->subindex;
+
+    if (lcec_sim_find_entry(sc, pdo_reg->index, pdo_reg->subindex, &sm, &bit_offset, &bit_length) == 0) {
+      // use existing FMMU for this sync manager (usually the last one)
+      fmmu = domain->last_fmmu;
+      if (fmmu == NULL || fmmu->sc != sc || fmmu->sm != sm) {
+        for (fmmu = domain->first_fmmu; fmmu != NULL; fmmu = fmmu->next) {
+          if (fmmu->sc == sc && fmmu->sm == sm) {
+            break;
+          }
+        }
+      }
+      reg->dir = sm->dir;
+    } else {
+      // unmapped entry, guess size and direction
+      sm = NULL;
+      bit_offset = 0;
+      bit_length = (pdo_reg->bit_position != NULL) ? 1 : LCEC_SIM_NONE_SIZE * 8;
+      reg->dir = ((pdo_reg->index & 0xf000) == 0x7000) ? EC_DIR_OUTPUT : EC_DIR_INPUT;
+
+      // append bit entry to the packed bit area of the previous entry
+      fmmu = domain->last_fmmu;
+      if (bit_length == 1 && fmmu != NULL && fmmu->sc == sc && fmmu->sm == NULL && fmmu->bit_size > 0 && fmmu->dir == reg->dir) {
+        bit_offset = fmmu->bit_size++;
+        if ((bit_offset & 0x07) == 0) {
+          domain->size++;
+        }
+      } else {
+        fmmu = NULL;
+      }
+    }
+
+    // create new FMMU area
+    if (fmmu == NULL) {
+      fmmu = lcec_zalloc(sizeof(lcec_sim_fmmu_t));
+      if (fmmu == NULL) {
+        lcec_free(reg);
+        return -ENOMEM;
+      }
+      fmmu->sc = sc;
+      fmmu->sm = sm;
+      fmmu->dir = reg->dir;
+      fmmu->offset = domain->size;
+      fmmu->bit_size = (sm == NULL && bit_length == 1) ? 1 : 0;
+      domain->size += (sm != NULL) ? (sm->bit_size + 7) / 8 : (bit_length + 7) / 8;
+      if (domain->last_fmmu != NULL) {
+        domain->last_fmmu->next = fmmu;
+      } else {
+        domain->first_fmmu = fmmu;
+      }
+      domain->last_fmmu = fmmu;
+    }
+
+    reg->bit_length = bit_length;
+    reg->offset = fmmu->offset + bit_offset / 8;
+    reg->bit_position = bit_offset % 8;
+    if (pdo_reg->bit_position != NULL) {
+      *(pdo_reg->bit_position) = reg->bit_position;
+    } else if (reg->bit_position != 0) {
+      rtapi_print_msg(RTAPI_MSG_ERR, LCEC_MSG_PFX "sim: PDO entry 0x%04x:%02x of slave %u is not byte aligned\n", pdo_reg->index, pdo_reg->subindex, pdo_reg->position);
+      lcec_free(reg);
+      return -EINVAL;
+    }
+    *(pdo_reg->offset) = reg->offset;
+
+    if (sc->last_reg != NULL) {
+      sc->last_reg->next = reg;
+    } else {
+      sc->first_reg = reg;
+    }
+    sc->last_reg = reg;
+  }
+
+  return 0;
+}
+
+size_t ecrt_domain_size(const ec_domain_t *domain) {
+  return domain->size;
+}
+
+void ecrt_domain_external_memory(ec_domain_t *domain, uint8_t *memory) {
+  domain->data = memory;
+}
+
+uint8_t *ecrt_domain_data(ec_domain_t *domain) {
+  return domain->data;
+}
+
+void ecrt_domain_process(ec_domain_t *domain) {
+  domain->state.working_counter = domain->wc;
+  if (domain->wc == 0) {
+    domain->state.wc_state = EC_WC_ZERO;
+  } else if (domain->wc == domain->expected_wc) {
+    domain->state.wc_state = EC_WC_COMPLETE;
+  } else {
+    domain->state.wc_state = EC_WC_INCOMPLETE;
+  }
+  domain->wc = 0;
+}
+
+void ecrt_domain_queue(ec_domain_t *domain) {
+  domain->queued = 1;
+}
+
+void ecrt_domain_state(const ec_domain_t *domain, ec_domain_state_t *state) {
+  *state = domain->state;
+}
+
+int ecrt_master_activate(ec_master_t *master) {
+  ec_domain_t *domain;
+  ec_slave_config_t *sc;
+  lcec_sim_fmmu_t *fmmu;
+  unsigned int dirs, i;
+
+  for (domain = master->first_domain; domain != NULL; domain = domain->next) {
+    // alloc process data if not provided externally
+    if (domain->data == NULL && domain->size > 0) {
+      domain->internal_data = lcec_zalloc(domain->size);
+      if (domain->internal_data == NULL) {
+        return -ENOMEM;
+      }
+      domain->data = domain->internal_data;
+    }
+
+    // collect slaves taking part in this domain
+    domain->wc_slave_count = 0;
+    for (sc = master->first_sc; sc != NULL; sc = sc->next) {
+      domain->wc_slave_count++;
+    }
+    domain->wc_slaves = lcec_zalloc(sizeof(lcec_sim_wc_t) * (domain->wc_slave_count + 1));
+    if (domain->wc_slaves == NULL) {
+      return -ENOMEM;
+    }
+    domain->wc_slave_count = 0;
+    for (sc = master->first_sc; sc != NULL; sc = sc->next) {
+      dirs = 0;
+      for (fmmu = domain->first_fmmu; fmmu != NULL; fmmu = fmmu->next) {
+        if (fmmu->sc == sc) {
+          dirs |= fmmu->dir;
+        }
+      }
+      if (dirs != 0) {
+        domain->wc_slaves[domain->wc_slave_count].sc = sc;
+        domain->wc_slaves[domain->wc_slave_count].dirs = dirs;
+        domain->wc_slave_count++;
+      }
+    }
+
+    // calculate expected working counter (LRW: inputs +1, outputs +2)
+    domain->expected_wc = 0;
+    for (i = 0; i < domain->wc_slave_count; i++) {
+      dirs = domain->wc_slaves[i].dirs;
+      domain->expected_wc += ((dirs & EC_DIR_INPUT) ? 1 : 0) + ((dirs & EC_DIR_OUTPUT) ? 2 : 0);
+    }
+  }
+
+  for (sc = master->first_sc; sc != NULL; sc = sc->next) {
+    sc->al_state = EC_AL_STATE_INIT;
+  }
+
+  lcec_sim_setup_models(master);
+
+  master->active = 1;
+  return 0;
+}
+
+void ecrt_master_deactivate(ec_master_t *master) {
+  master->active = 0;
+}
+
+size_t ecrt_master_send(ec_master_t *master) {
+  ec_domain_t *domain;
+
+  for (domain = master->first_domain; domain != NULL; domain = domain->next) {
+    domain->in_flight = domain->queued;
+    domain->queued = 0;
+  }
+
+  return 0;
+}
+
+void ecrt_master_receive(ec_master_t *master) {
+  ec_domain_t *domain;
+  ec_slave_config_t *sc;
+
+  if (!master->active) {
+    return;
+  }
+
+  // step slave states up to OP
+  master->cycle++;
+  if ((master->cycle % LCEC_SIM_STATE_CYCLES) == 0) {
+    for (sc = master->first_sc; sc != NULL; sc = sc->next) {
+      if (sc->al_state < EC_AL_STATE_OP) {
+        sc->al_state <<= 1;
+      }
+    }
+  }
+
+  // run slave models on exchanged data
+  lcec_sim_run_models(master);
+  if (master->receive_hook != NULL) {
+    master->receive_hook(master, master->receive_hook_arg);
+  }
+
+  for (domain = master->first_domain; domain != NULL; domain = domain->next) {
+    if (domain->in_flight) {
+      lcec_sim_exchange(domain);
+      domain->in_flight = 0;
+    }
+  }
+}
+
+static void lcec_sim_exchange(ec_domain_t *domain) {
+  const lcec_sim_wc_t *wc;
+  unsigned int i;
+
+  domain->wc = 0;
+  for (i = 0, wc = domain->wc_slaves; i < domain->wc_slave_count; i++, wc++) {
+    // outputs are accepted in OP, inputs delivered from SAFEOP
+    if ((wc->dirs & EC_DIR_INPUT) && wc->sc->al_state >= EC_AL_STATE_SAFEOP) {
+      domain->wc += 1;
+    }
+    if ((wc->dirs & EC_DIR_OUTPUT) && wc->sc->al_state >= EC_AL_STATE_OP) {
+      domain->wc += 2;
+    }
+  }
+}
+
+void ecrt_master_state(const ec_master_t *master, ec_master_state_t *state) {
+  ec_slave_config_t *sc;
+
+  memset(state, 0, sizeof(ec_master_state_t));
+  state->link_up = 1;
+  for (sc = master->first_sc; sc != NULL; sc = sc->next) {
+    state->slaves_responding++;
+    state->al_states |= sc->al_state;
+  }
+}
+
+void ecrt_master_application_time(ec_master_t *master, uint64_t app_time) {
+  master->app_time = app_time;
+}
+
+void ecrt_master_sync_reference_clock(ec_master_t *master) {
+}
+
+void ecrt_master_sync_slave_clocks(ec_master_t *master) {
+}
+
+int ecrt_master_reference_clock_time(ec_master_t *master, uint32_t *time) {
+  ec_slave_config_t *sc;
+
+  // first DC slave is the reference clock, running in sync with the master
+  for (sc = master->first_sc; sc != NULL; sc = sc->next) {
+    if (sc->dc_enabled && sc->al_state >= EC_AL_STATE_PREOP) {
+      *time = (uint32_t) master->app_time;
+      return 0;
+    }
+  }
+
+  return -ENXIO;
+}
+
+static ec_slave_config_t *lcec_sim_sc_by_position(ec_master_t *master, uint16_t position) {
+  ec_slave_config_t *sc;
+
+  for (sc = master->first_sc; sc != NULL; sc = sc->next) {
+    if (sc->position == position) {
+      return sc;
+    }
+  }
+
+  return NULL;
+}
+
+// slave info: the configured sync managers, followed by one sync manager
+// per direction holding the entries without PDO configuration
+static int lcec_sim_info_sm(ec_master_t *master, uint16_t position, uint8_t sync_index, ec_slave_config_t **sc, const lcec_sim_sm_t **sm, ec_direction_t *dir) {
+  *sc = lcec_sim_sc_by_position(master, position);
+  if (*sc == NULL || sync_index >= (*sc)->sm_count + 2) {
+    return -ENOENT;
+  }
+
+  if (sync_index < (*sc)->sm_count) {
+    *sm = &(*sc)->sms[sync_index];
+    *dir = (*sm)->dir;
+  } else {
+    *sm = NULL;
+    *dir = (sync_index == (*sc)->sm_count) ? EC_DIR_OUTPUT : EC_DIR_INPUT;
+  }
+
+  return 0;
+}
+
+static unsigned int lcec_sim_unmapped_regs(ec_slave_config_t *sc, ec_direction_t dir, unsigned int pos, lcec_sim_reg_t **found) {
+  lcec_sim_reg_t *reg;
+  const lcec_sim_sm_t *sm;
+  unsigned int bit_offset, count;
+  uint8_t bit_length;
+
+  count = 0;
+  for (reg = sc->first_reg; reg != NULL; reg = reg->next) {
+    if (reg->dir != dir || lcec_sim_find_entry(sc, reg->index, reg->subindex, &sm, &bit_offset, &bit_length) == 0) {
+      continue;
+    }
+    if (count == pos) {
+      *found = reg;
+    }
+    count++;
+  }
+
+  return count;
+}
+
+int ecrt_master_get_slave(ec_master_t *master, uint16_t slave_position, ec_slave_info_t *slave_info) {
+  ec_slave_config_t *sc;
+
+  sc = lcec_sim_sc_by_position(master, slave_position);
+  if (sc == NULL) {
+    return -ENOENT;
+  }
+
+  memset(slave_info, 0, sizeof(ec_slave_info_t));
+  slave_info->position = sc->position;
+  slave_info->alias = sc->alias;
+  slave_info->vendor_id = sc->vendor_id;
+  slave_info->product_code = sc->product_code;
+  slave_info->al_state = sc->al_state;
+  slave_info->sync_count = sc->sm_count + 2;
+
+  return 0;
+}
+
+int ecrt_master_get_sync_manager(ec_master_t *master, uint16_t slave_position, uint8_t sync_index, ec_sync_info_t *sync) {
+  ec_slave_config_t *sc;
+  const lcec_sim_sm_t *sm;
+  lcec_sim_reg_t *reg;
+  ec_direction_t dir;
+
+  if (lcec_sim_info_sm(master, slave_position, sync_index, &sc, &sm, &dir) != 0) {
+    return -ENOENT;
+  }
+
+  memset(sync, 0, sizeof(ec_sync_info_t));
+  sync->dir = dir;
+  if (sm != NULL) {
+    sync->index = sm->index;
+    sync->n_pdos = sm->pdo_count;
+  } else {
+    sync->index = sync_index;
+    sync->n_pdos = (lcec_sim_unmapped_regs(sc, dir, 0, &reg) > 0) ? 1 : 0;
+  }
+
+  return 0;
+}
+
+int ecrt_master_get_pdo(ec_master_t *master, uint16_t slave_position, uint8_t sync_index, uint16_t pos, ec_pdo_info_t *pdo) {
+  ec_slave_config_t *sc;
+  const lcec_sim_sm_t *sm;
+  lcec_sim_reg_t *reg;
+  ec_direction_t dir;
+
+  if (lcec_sim_info_sm(master, slave_position, sync_index, &sc, &sm, &dir) != 0) {
+    return -ENOENT;
+  }
+
+  memset(pdo, 0, sizeof(ec_pdo_info_t));
+  if (sm != NULL) {
+    if (pos >= sm->pdo_count) {
+      return -ENOENT;
+    }
+    pdo->index = sm->pdos[pos].index;
+    pdo->n_entries = sm->pdos[pos].n_entries;
+  } else {
+    if (pos > 0) {
+      return -ENOENT;
+    }
+    pdo->index = (dir == EC_DIR_OUTPUT) ? 0x1600 : 0x1a00;
+    pdo->n_entries = lcec_sim_unmapped_regs(sc, dir, 0, &reg);
+  }
+
+  return 0;
+}
+
+int ecrt_master_get_pdo_entry(ec_master_t *master, uint16_t slave_position, uint8_t sync_index, uint16_t pdo_pos, uint16_t entry_pos, ec_pdo_entry_info_t *entry) {
+  ec_slave_config_t *sc;
+  const lcec_sim_sm_t *sm;
+  lcec_sim_reg_t *reg;
+  ec_direction_t dir;
+
+  if (lcec_sim_info_sm(master, slave_position, sync_index, &sc, &sm, &dir) != 0) {
+    return -ENOENT;
+  }
+
+  if (sm != NULL) {
+    if (pdo_pos >= sm->pdo_count || entry_pos >= sm->pdos[pdo_pos].n_entries) {
+      return -ENOENT;
+    }
+    *entry = sm->pdos[pdo_pos].entries[entry_pos];
+  } else {
+    if (pdo_pos > 0 || entry_pos >= lcec_sim_unmapped_regs(sc, dir, entry_pos, &reg)) {
+      return -ENOENT;
+    }
+    entry->index = reg->index;
+    entry->subindex = reg->subindex;
+    entry->bit_length = reg->bit_length;
+  }
+
+  return 0;
+}
+
+int ecrt_master_sdo_upload(ec_master_t *master, uint16_t slave_position, uint16_t index, uint8_t subindex, uint8_t *target, size_t target_size, size_t *result_size, uint32_t *abort_code) {
+  ec_slave_config_t *sc;
+  lcec_sim_sdo_t *sdo;
+
+  *abort_code = 0;
+
+  // return configured values, zero otherwise
+  for (sc = master->first_sc; sc != NULL; sc = sc->next) {
+    if (sc->position != slave_position) {
+      continue;
+    }
+    for (sdo = sc->first_sdo; sdo != NULL; sdo = sdo->next) {
+      if (sdo->index == index && sdo->subindex == subindex) {
+        *result_size = (sdo->size < target_size) ? sdo->size : target_size;
+        memcpy(target, sdo->data, *result_size);
+        return 0;
+      }
+    }
+    memset(target, 0, target_size);
+    *result_size = target_size;
+    return 0;
+  }
+
+  *abort_code = 0x06020000;
+  return -EIO;
+}
+
+int ecrt_master_read_idn(ec_master_t *master, uint16_t slave_position, uint8_t drive_no, uint16_t idn, uint8_t *target, size_t target_size, size_t *result_size, uint16_t *error_code) {
+  *error_code = 0;
+  memset(target, 0, target_size);
+  *result_size = target_size;
+  return 0;
+}
+
+static lcec_sim_reg_t *lcec_sim_reg_by_index(ec_slave_config_t *sc, uint16_t index, uint8_t subindex) {
+  lcec_sim_reg_t *reg;
+
+  for (reg = sc->first_reg; reg != NULL; reg = reg->next) {
+    if (reg->index == index && reg->subindex == subindex) {
+      return reg;
+    }
+  }
+
+  return NULL;
+}
+
+ec_master_t *lcec_sim_get_master(unsigned int index) {
+  ec_master_t *master;
+
+  for (master = lcec_sim_masters; master != NULL; master = master->next) {
+    if (master->index == index) {
+      return master;
+    }
+  }
+
+  return NULL;
+}
+
+void lcec_sim_set_receive_hook(ec_master_t *master, lcec_sim_hook_t hook, void *arg) {
+  master->receive_hook = hook;
+  master->receive_hook_arg = arg;
+}
+
+lcec_sim_entry_t *lcec_sim_next_entry(ec_master_t *master, lcec_sim_entry_t *entry) {
+  ec_slave_config_t *sc;
+
+  if (entry != NULL) {
+    if (entry->next != NULL) {
+      return entry->next;
+    }
+    sc = entry->sc->next;
+  } else {
+    sc = master->first_sc;
+  }
+
+  for (; sc != NULL; sc = sc->next) {
+    if (sc->first_reg != NULL) {
+      return sc->first_reg;
+    }
+  }
+
+  return NULL;
+}
+
+lcec_sim_entry_t *lcec_sim_get_entry(ec_master_t *master, uint16_t position, uint16_t index, uint8_t subindex) {
+  ec_slave_config_t *sc;
+
+  for (sc = master->first_sc; sc != NULL; sc = sc->next) {
+    if (sc->position == position) {
+      return lcec_sim_reg_by_index(sc, index, subindex);
+    }
+  }
+
+  return NULL;
+}
+
+void lcec_sim_entry_info(const lcec_sim_entry_t *entry, LCEC_SIM_ENTRY_INFO_T *info) {
+  info->position = entry->sc->position;
+  info->index = entry->index;
+  info->subindex = entry->subindex;
+  info->bit_length = entry->bit_length;
+  info->dir = entry->dir;
+  info->data = lcec_sim_reg_ptr(entry);
+  info->bit_position = entry->bit_position;
+}
+
+int64_t lcec_sim_entry_get(const lcec_sim_entry_t *entry) {
+  return lcec_sim_reg_get(entry);
+}
+
+void lcec_sim_entry_set(const lcec_sim_entry_t *entry, int64_t val) {
+  lcec_sim_reg_set(entry, val);
+}
+
+static void lcec_sim_setup_models(ec_master_t *master) {
+  ec_slave_config_t *sc;
+  lcec_sim_cia402_t *drive;
+  lcec_sim_reg_t *control, *status;
+
+  for (sc = master->first_sc; sc != NULL; sc = sc->next) {
+    control = lcec_sim_reg_by_index(sc, 0x6040, 0x00);
+    status = lcec_sim_reg_by_index(sc, 0x6041, 0x00);
+    if (control == NULL || status == NULL) {
+      continue;
+    }
+
+    drive = lcec_zalloc(sizeof(lcec_sim_cia402_t));
+    if (drive == NULL) {
+      continue;
+    }
+    drive->control = control;
+    drive->status = status;
+    drive->mode = lcec_sim_reg_by_index(sc, 0x6060, 0x00);
+    drive->mode_display = lcec_sim_reg_by_index(sc, 0x6061, 0x00);
+    drive->target_pos = lcec_sim_reg_by_index(sc, 0x607a, 0x00);
+    drive->actual_pos = lcec_sim_reg_by_index(sc, 0x6064, 0x00);
+    drive->target_vel = lcec_sim_reg_by_index(sc, 0x60ff, 0x00);
+    drive->actual_vel = lcec_sim_reg_by_index(sc, 0x606c, 0x00);
+    drive->state = 0x0250;
+    sc->cia402 = drive;
+  }
+}
+
+static void lcec_sim_cia402(lcec_sim_cia402_t *drive) {
+  uint16_t control;
+  int fault_reset;
+
+  control = lcec_sim_reg_get(drive->control);
+  fault_reset = (control & 0x0080) != 0;
+
+  // CiA402 device control state machine
+  if (drive->state & 0x0008) {
+    if (fault_reset && !drive->fault_reset_last) {
+      drive->state = 0x0250;
+    }
+  } else if (!(control & 0x0002) || !(control & 0x0004)) {
+    drive->state = 0x0250;
+  } else {
+    switch (control & 0x000f) {
+      case 0x0006:
+        drive->state = 0x0231;
+        break;
+      case 0x0007:
+        if (drive->state != 0x0250) {
+          drive->state = 0x0233;
+        }
+        break;
+      case 0x000f:
+        if (drive->state == 0x0233 || drive->state == 0x0237) {
+          drive->state = 0x0237;
+        }
+        break;
+    }
+  }
+  drive->fault_reset_last = fault_reset;
+
+  lcec_sim_reg_set(drive->status, drive->state);
+  if (drive->mode != NULL && drive->mode_display != NULL) {
+    lcec_sim_reg_set(drive->mode_display, lcec_sim_reg_get(drive->mode));
+  }
+
+  // ideal axis follows command while enabled
+  if (drive->state == 0x0237) {
+    if (drive->target_pos != NULL && drive->actual_pos != NULL) {
+      lcec_sim_reg_set(drive->actual_pos, lcec_sim_reg_get(drive->target_pos));
+    }
+    if (drive->target_vel != NULL && drive->actual_vel != NULL) {
+      lcec_sim_reg_set(drive->actual_vel, lcec_sim_reg_get(drive->target_vel));
+    }
+  } else if (drive->actual_vel != NULL) {
+    lcec_sim_reg_set(drive->actual_vel, 0);
+  }
+}
+
+static void lcec_sim_run_models(ec_master_t *master) {
+  ec_slave_config_t *sc, *in_sc;
+  lcec_sim_reg_t *reg, *in_reg;
+  int val;
+
+  for (sc = master->first_sc; sc != NULL; sc = sc->next) {
+    if (sc->al_state != EC_AL_STATE_OP) {
+      continue;
+    }
+    if (sc->cia402 != NULL) {
+      lcec_sim_cia402(sc->cia402);
+    }
+  }
+
+  // digital loopback: nth output bit drives nth input bit
+  in_sc = master->first_sc;
+  in_reg = NULL;
+  for (sc = master->first_sc; sc != NULL; sc = sc->next) {
+    for (reg = sc->first_reg; reg != NULL; reg = reg->next) {
+      if (reg->bit_length != 1 || reg->dir != EC_DIR_OUTPUT || (reg->index & 0xf000) != 0x7000) {
+        continue;
+      }
+      val = (sc->al_state == EC_AL_STATE_OP) ? lcec_sim_reg_get(reg) : 0;
+
+      // find next digital input
+      for (; in_sc != NULL; in_sc = in_sc->next, in_reg = NULL) {
+        in_reg = (in_reg == NULL) ? in_sc->first_reg : in_reg->next;
+        for (; in_reg != NULL; in_reg = in_reg->next) {
+          if (in_reg->bit_length == 1 && in_reg->dir == EC_DIR_INPUT && (in_reg->index & 0xf000) == 0x6000) {
+            break;
+          }
+        }
+        if (in_reg != NULL) {
+          break;
+        }
+      }
+      if (in_sc == NULL) {
+        return;
+      }
+      if (in_sc->al_state >= EC_AL_STATE_SAFEOP) {
+        lcec_sim_reg_set(in_reg, val);
+      }
+    }
+  }
+}
+
+float ecrt_read_real(const void *data) {
+  uint32_t raw = EC_READ_U32(data);
+  float val;
+
+  memcpy(&val, &raw, sizeof(float));
+  return val;
+}
+
+double ecrt_read_lreal(const void *data) {
+  uint64_t raw = EC_READ_U64(data);
+  double val;
+
+  memcpy(&val, &raw, sizeof(double));
+  return val;
+}
+
+void ecrt_write_real(void *data, float value) {
+  uint32_t raw;
+
+  memcpy(&raw, &value, sizeof(float));
+  EC_WRITE_U32(data, raw);
+}
+
+void ecrt_write_lreal(void *data, double value) {
+  uint64_t raw;
+
+  memcpy(&raw, &value, sizeof(double));
+  EC_WRITE_U64(data, raw);
+}
+
@@ -0,0 +1,57 @@
+//
+//    Copyright (C) 2026 Sascha Ittner <sascha.ittner@modusoft.de>
+//
+//    This program is free software; you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation; either version 2 of the License, or
+//    (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with this program; if not, write to the Free Software
+//    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301 USA
+//
+#ifndef _LCEC_SIM_H_
+#define _LCEC_SIM_H_
+
+#include "ecrt.h"
+
+//
+// Process image access for tools linked against the simulated master
+// (lcec_sim.c). Entries are the PDO entries registered by the driver,
+// enumerated in slave config order.
+//
+
+typedef struct lcec_sim_reg lcec_sim_entry_t;
+
+typedef void (*lcec_sim_hook_t) (ec_master_t *master, void *arg);
+
+typedef struct {
+  uint16_t position;
+  uint16_t index;
+  uint8_t subindex;
+  uint8_t bit_length;
+  ec_direction_t dir;
+  uint8_t *data;
+  unsigned int bit_position;
+} LCEC_SIM_ENTRY_INFO_T;
+
+ec_master_t *lcec_sim_get_master(unsigned int index);
+
+// called on every ecrt_master_receive() after the slave models have run
+void lcec_sim_set_receive_hook(ec_master_t *master, lcec_sim_hook_t hook, void *arg);
+
+lcec_sim_entry_t *lcec_sim_next_entry(ec_master_t *master, lcec_sim_entry_t *entry);
+lcec_sim_entry_t *lcec_sim_get_entry(ec_master_t *master, uint16_t position, uint16_t index, uint8_t subindex);
+void lcec_sim_entry_info(const lcec_sim_entry_t *entry, LCEC_SIM_ENTRY_INFO_T *info);
+
+// integer access for 1, 8, 16, 32 and 64 bit entries (sign extended)
+int64_t lcec_sim_entry_get(const lcec_sim_entry_t *entry);
+void lcec_sim_entry_set(const lcec_sim_entry_t *entry, int64_t val);
+
+#endif
+
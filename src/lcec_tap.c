@@ -0,0 +1,130 @@
+//
+//    Copyright (C) 2026 Sascha Ittner <sascha.ittner@modusoft.de>
+//
+//    This program is free software; you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation; either version 2 of the License, or
+//    (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with this program; if not, write to the Free Software
+//    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301 USA
+//
+
+#include "lcec.h"
+#include "lcec_tap.h"
+
+int lcec_tap_entry_count(struct lcec_master *master) {
+  lcec_domain_t *domain;
+  int count;
+
+  count = 0;
+  for (domain = master->first_domain; domain != NULL; domain = domain->next) {
+    count += domain->pdo_entry_count;
+  }
+
+  return count;
+}
+
+void lcec_tap_init_entries(struct lcec_master *master, LCEC_TAP_ENTRY_T *entry) {
+  lcec_domain_t *domain;
+  lcec_slave_t *slave;
+  ec_pdo_entry_reg_t *reg;
+  int i;
+
+  for (domain = master->first_domain; domain != NULL; domain = domain->next) {
+    for (i = 0, reg = domain->pdo_entry_regs; i < domain->pdo_entry_count; i++, reg++, entry++) {
+      entry->slave_pos = reg->position;
+      entry->domain = domain->index;
+      entry->pdo_index = reg->index;
+      entry->pdo_subindex = reg->subindex;
+      entry->offset = (reg->offset != NULL) ? *(reg->offset) : 0;
+      entry->bit_position = (reg->bit_position != NULL) ? *(reg->bit_position) : 0;
+      slave = lcec_slave_by_index(master, reg->position);
+      if (slave != NULL) {
+        rtapi_snprintf(entry->slave_name, LCEC_TAP_NAME_LEN, "%s", slave->name);
+      }
+    }
+  }
+}
+
+int lcec_tap_init(int comp_id, struct lcec_master *master) {
+  LCEC_TAP_HEADER_T *hdr;
+  void *shmem_ptr;
+  int shmem_id;
+  int entry_count;
+  size_t entry_offset, data_offset, size;
+
+  // get entry count
+  entry_count = lcec_tap_entry_count(master);
+
+  // calculate layout (data 8 byte aligned)
+  entry_offset = sizeof(LCEC_TAP_HEADER_T);
+  data_offset = (entry_offset + sizeof(LCEC_TAP_ENTRY_T) * entry_count + 7) & ~7;
+  size = data_offset + master->process_data_len;
+
+  // create shared memory
+  shmem_id = rtapi_shmem_new(LCEC_TAP_SHMEM_KEY + master->index, comp_id, size);
+  if (shmem_id < 0) {
+    rtapi_print_msg(RTAPI_MSG_ERR, LCEC_MSG_PFX "couldn't allocate tap shared memory for master %s\n", master->name);
+    return -1;
+  }
+  if (lcec_rtapi_shmem_getptr(shmem_id, &shmem_ptr) < 0) {
+    rtapi_print_msg(RTAPI_MSG_ERR, LCEC_MSG_PFX "couldn't map tap shared memory for master %s\n", master->name);
+    rtapi_shmem_delete(shmem_id, comp_id);
+    return -1;
+  }
+  memset(shmem_ptr, 0, size);
+
+  // setup header
+  hdr = shmem_ptr;
+  hdr->version = LCEC_TAP_VERSION;
+  hdr->size = size;
+  hdr->entry_count = entry_count;
+  hdr->entry_offset = entry_offset;
+  hdr->data_offset = data_offset;
+  hdr->data_len = master->process_data_len;
+  hdr->period = master->app_time_period;
+  rtapi_snprintf(hdr->master_name, LCEC_TAP_NAME_LEN, "%s", master->name);
+
+  // setup layout entries
+  lcec_tap_init_entries(master, shmem_ptr + entry_offset);
+
+  // mark as valid
+  lcec_wmb();
+  hdr->magic = LCEC_TAP_MAGIC;
+
+  master->tap_shmem_id = shmem_id;
+  master->tap = hdr;
+  return 0;
+}
+
+void lcec_tap_cleanup(int comp_id, struct lcec_master *master) {
+  if (master->tap == NULL) {
+    return;
+  }
+
+  rtapi_shmem_delete(master->tap_shmem_id, comp_id);
+  master->tap = NULL;
+}
+
+void lcec_tap_publish(struct lcec_master *master) {
+  LCEC_TAP_HEADER_T *hdr = master->tap;
+  uint32_t seq = hdr->seq;
+
+  // odd sequence marks update in progress
+  lcec_atomic_store(&hdr->seq, seq + 1);
+  lcec_wmb();
+
+  memcpy(((uint8_t *) hdr) + hdr->data_offset, master->process_data, hdr->data_len);
+  hdr->cycle++;
+  hdr->timestamp = rtapi_get_time();
+
+  lcec_atomic_store(&hdr->seq, seq + 2);
+}
+
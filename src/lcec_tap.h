@@ -0,0 +1,116 @@
+//
+//    Copyright (C) 2026 Sascha Ittner <sascha.ittner@modusoft.de>
+//
+//    This program is free software; you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation; either version 2 of the License, or
+//    (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with this program; if not, write to the Free Software
+//    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301 USA
+//
+#ifndef _LCEC_TAP_H_
+#define _LCEC_TAP_H_
+
+//
+// Process image tap
+//
+// Masters with processDataTap="true" publish their whole process
+// image to a RTAPI shared memory segment on every cycle, right after
+// the domains have been processed. The segment key is
+// LCEC_TAP_SHMEM_KEY + master index.
+//
+// Segment layout:
+//   LCEC_TAP_HEADER_T
+//   LCEC_TAP_ENTRY_T[entry_count]  at entry_offset
+//   uint8_t[data_len]              at data_offset
+//
+// The image is protected by a sequence lock. The RT side never waits
+// for readers, so readers have to retry if the sequence changed while
+// reading (see lcec_tap_read_begin/lcec_tap_read_retry).
+//
+
+#ifdef __KERNEL__
+#include <linux/types.h>
+#else
+#include <stdint.h>
+#include <string.h>
+#endif
+
+#define LCEC_TAP_SHMEM_KEY 0xACB57300
+#define LCEC_TAP_MAGIC     0x4C544150
+#define LCEC_TAP_VERSION   1
+
+#define LCEC_TAP_NAME_LEN 48
+
+typedef struct {
+  uint32_t magic;
+  uint32_t version;
+  uint32_t size;
+  uint32_t entry_count;
+  uint32_t entry_offset;
+  uint32_t data_offset;
+  uint32_t data_len;
+  uint32_t period;
+  char master_name[LCEC_TAP_NAME_LEN];
+  uint32_t seq;
+  uint32_t reserved;
+  uint64_t cycle;
+  int64_t timestamp;
+} LCEC_TAP_HEADER_T;
+
+typedef struct {
+  uint16_t slave_pos;
+  uint16_t domain;
+  uint16_t pdo_index;
+  uint8_t pdo_subindex;
+  uint8_t bit_position;
+  uint32_t offset;
+  char slave_name[LCEC_TAP_NAME_LEN];
+} LCEC_TAP_ENTRY_T;
+
+static inline const LCEC_TAP_ENTRY_T *lcec_tap_entries(const LCEC_TAP_HEADER_T *hdr) {
+  return (const LCEC_TAP_ENTRY_T *) (((const uint8_t *) hdr) + hdr->entry_offset);
+}
+
+static inline const uint8_t *lcec_tap_data(const LCEC_TAP_HEADER_T *hdr) {
+  return ((const uint8_t *) hdr) + hdr->data_offset;
+}
+
+static inline uint32_t lcec_tap_read_begin(const LCEC_TAP_HEADER_T *hdr) {
+  uint32_t seq;
+
+  // wait for writer to finish
+  while ((seq = __atomic_load_n(&hdr->seq, __ATOMIC_ACQUIRE)) & 1);
+  return seq;
+}
+
+static inline int lcec_tap_read_retry(const LCEC_TAP_HEADER_T *hdr, uint32_t seq) {
+  __atomic_thread_fence(__ATOMIC_ACQUIRE);
+  return __atomic_load_n(&hdr->seq, __ATOMIC_RELAXED) != seq;
+}
+
+#ifndef __KERNEL__
+// copy a consistent image, returns the cycle counter of the copy
+static inline uint64_t lcec_tap_copy(const LCEC_TAP_HEADER_T *hdr, void *dst) {
+  uint32_t seq;
+  uint64_t cycle;
+
+  do {
+    seq = lcec_tap_read_begin(hdr);
+    memcpy(dst, lcec_tap_data(hdr), hdr->data_len);
+    cycle = hdr->cycle;
+  } while (lcec_tap_read_retry(hdr, seq));
+
+  return cycle;
+}
+#endif
+
+#endif
+
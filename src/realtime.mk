@@ -27,10 +27,18 @@ else
 
 module = $(patsubst %.o,%.so,$(obj-m))
 
-EXTRA_CFLAGS := $(filter-out -Wframe-larger-than=%,$(EXTRA_CFLAGS))
+EXTRA_CFLAGS := $(filter-out -Wframe-larger-than=%,$(EXTRA_CFLAGS)) -D_GNU_SOURCE
+
+# LCEC_SIM=1 links the simulated master instead of libethercat
+ifeq ($(LCEC_SIM),1)
+  lcec-objs += lcec_sim.o
+  ECRT_LIBS =
+else
+  ECRT_LIBS = -lethercat
+endif
 
 $(module): $(lcec-objs)
-	$(CC) -shared -o $@ $(lcec-objs) -Wl,-rpath,$(LIBDIR) -L$(LIBDIR) -llinuxcnchal -lethercat -lrt
+	$(CC) -shared -o $@ $(lcec-objs) -Wl,-rpath,$(LIBDIR) -L$(LIBDIR) -llinuxcnchal $(ECRT_LIBS) -lrt -lpthread
 
 %.o: %.c
 	$(CC) -o $@ $(EXTRA_CFLAGS) -Os -c $<
@@ -41,7 +49,7 @@ all: $(module)
 
 clean::
 	rm -f $(module)
-	rm -f $(lcec-objs)
+	rm -f $(lcec-objs) lcec_sim.o
 
 install: $(module)
 	mkdir -p $(DESTDIR)$(RTLIBDIR)
@@ -0,0 +1,98 @@
+include ../configure.mk
+include Kbuild
+
+ifeq ($(BUILDSYS),kbuild)
+  $(error simulator tools need a user space (uspace) LinuxCNC build)
+endif
+
+EXTRA_CFLAGS := $(filter-out -Wframe-larger-than=%,$(EXTRA_CFLAGS)) -D_GNU_SOURCE
+
+# drivers are linked against the simulated master and a fake HAL
+LCEC_SIM_OBJS = \
+	$(lcec-objs) \
+	lcec_sim.o \
+	lcec_fakehal.o \
+
+LCEC_BENCH_OBJS = \
+	$(LCEC_SIM_OBJS) \
+	lcec_bench.o \
+
+# config parser objects are shared with lcec_conf (user space flags)
+LCEC_SIM_CONF_OBJS = \
+	lcec_conf.o \
+	lcec_conf_util.o \
+	lcec_conf_icmds.o \
+	lcec_conf_cache.o \
+
+LCEC_REPLAY_OBJS = \
+	$(LCEC_SIM_OBJS) \
+	$(LCEC_SIM_CONF_OBJS) \
+	lcec_replay.o \
+
+LCEC_LATENCY_OBJS = \
+	$(LCEC_SIM_OBJS) \
+	$(LCEC_SIM_CONF_OBJS) \
+	lcec_latency.o \
+
+LCEC_CONF_SCALE_OBJS = \
+	$(LCEC_SIM_OBJS) \
+	$(LCEC_SIM_CONF_OBJS) \
+	lcec_conf_scale.o \
+
+# fuzz target is built with its own compiler and flags into *.fuzz.o,
+# use FUZZ_CC=afl-clang-fast FUZZ_CFLAGS="-g -O1" for AFL
+FUZZ_CC ?= clang
+FUZZ_CFLAGS ?= -g -O1 -fsanitize=fuzzer,address,undefined -DLCEC_FUZZ_LIBFUZZER
+FUZZ_LDFLAGS ?= $(filter -fsanitize=%,$(FUZZ_CFLAGS))
+
+LCEC_CONF_FUZZ_OBJS = \
+	$(LCEC_SIM_OBJS:.o=.fuzz.o) \
+	$(LCEC_SIM_CONF_OBJS:.o=.fuzz.o) \
+	lcec_conf_fuzz.fuzz.o \
+
+.PHONY: all bench latency scale fuzz clean
+
+all: lcec_bench lcec_replay lcec_latency lcec_conf_scale
+
+bench: lcec_bench
+	./lcec_bench $(BENCH_ARGS)
+
+latency: lcec_latency
+	./lcec_latency $(LATENCY_ARGS)
+
+scale: lcec_conf_scale
+	./lcec_conf_scale $(SCALE_ARGS)
+
+fuzz: lcec_conf_fuzz
+	./lcec_conf_fuzz $(FUZZ_ARGS)
+
+lcec_bench: $(LCEC_BENCH_OBJS)
+	$(CC) -rdynamic -o $@ $(LCEC_BENCH_OBJS) -lrt -lpthread -ldl -lm
+
+lcec_replay: $(LCEC_REPLAY_OBJS)
+	$(CC) -o $@ $(LCEC_REPLAY_OBJS) -lrt -lpthread -lm -lexpat
+
+lcec_latency: $(LCEC_LATENCY_OBJS)
+	$(CC) -o $@ $(LCEC_LATENCY_OBJS) -lrt -lpthread -lm -lexpat
+
+lcec_conf_scale: $(LCEC_CONF_SCALE_OBJS)
+	$(CC) -o $@ $(LCEC_CONF_SCALE_OBJS) -lrt -lpthread -lm -lexpat
+
+lcec_conf_fuzz: $(LCEC_CONF_FUZZ_OBJS)
+	$(FUZZ_CC) $(FUZZ_LDFLAGS) -o $@ $(LCEC_CONF_FUZZ_OBJS) -lrt -lpthread -lm -lexpat
+
+$(LCEC_SIM_CONF_OBJS): %.o: %.c
+	$(CC) -o $@ $(EXTRA_CFLAGS) -URTAPI -U__MODULE__ -DULAPI -Os -c $<
+
+$(LCEC_SIM_CONF_OBJS:.o=.fuzz.o): %.fuzz.o: %.c
+	$(FUZZ_CC) -o $@ $(EXTRA_CFLAGS) -URTAPI -U__MODULE__ -DULAPI $(FUZZ_CFLAGS) -c $<
+
+%.fuzz.o: %.c
+	$(FUZZ_CC) -o $@ $(EXTRA_CFLAGS) $(FUZZ_CFLAGS) -c $<
+
+%.o: %.c
+	$(CC) -o $@ $(EXTRA_CFLAGS) -Os -c $<
+
+clean:
+	rm -f lcec_bench lcec_replay lcec_latency lcec_conf_scale lcec_conf_fuzz *.fuzz.o
+	rm -f lcec_sim.o lcec_fakehal.o lcec_bench.o lcec_replay.o lcec_latency.o lcec_conf_scale.o
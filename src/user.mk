@@ -1,23 +1,32 @@
 include ../configure.mk
 
-EXTRA_CFLAGS := $(filter-out -Wframe-larger-than=%,$(EXTRA_CFLAGS))
+EXTRA_CFLAGS := $(filter-out -Wframe-larger-than=%,$(EXTRA_CFLAGS)) -D_GNU_SOURCE
 
 LCEC_CONF_OBJS = \
+	lcec_conf_main.o \
 	lcec_conf.o \
 	lcec_conf_util.o \
 	lcec_conf_icmds.o \
+	lcec_conf_cache.o \
+
+LCEC_REC_DUMP_OBJS = \
+	lcec_rec_dump.o \
 
 .PHONY: all clean install
 
-all: lcec_conf
+all: lcec_conf lcec_rec_dump
 
-install: lcec_conf
+install: lcec_conf lcec_rec_dump
 	mkdir -p $(DESTDIR)$(EMC2_HOME)/bin
 	cp lcec_conf $(DESTDIR)$(EMC2_HOME)/bin/
+	cp lcec_rec_dump $(DESTDIR)$(EMC2_HOME)/bin/
 
 lcec_conf: $(LCEC_CONF_OBJS)
 	$(CC) -o $@ $(LCEC_CONF_OBJS) -Wl,-rpath,$(LIBDIR) -L$(LIBDIR) -llinuxcnchal -lexpat
 
+lcec_rec_dump: $(LCEC_REC_DUMP_OBJS)
+	$(CC) -o $@ $(LCEC_REC_DUMP_OBJS) -Wl,-rpath,$(LIBDIR) -L$(LIBDIR) -llinuxcnchal
+
 %.o: %.c
 	$(CC) -o $@ $(EXTRA_CFLAGS) -URTAPI -U__MODULE__ -DULAPI -Os -c $<
 